@@ -24,12 +24,23 @@ SOFTWARE.
 #ifndef M8_H
 #define M8_H
 
+#include "m8_fix.h"
 #include "m8_global.h"
+#include "m8_gnss.h"
+#include "m8_metrics.h"
+#include "m8_power.h"
+#include "m8_schedule.h"
+#include "m8_sink.h"
 #include "m8_status.h"
 #include "m8_sv_info.h"
+#include "m8_time.h"
+#include "m8_ttff.h"
 #include <QObject>
 
+class IoReactor;
 class M8Control;
+class M8Manager;
+class QThread;
 
 class M8_EXPORT M8 : public QObject
 {
@@ -37,25 +48,60 @@ class M8_EXPORT M8 : public QObject
 public:
     M8(QString device, QObject *parent = nullptr);
     M8(QString device, QByteArray configPath, QObject *parent = nullptr);
+    ~M8();
 
     void setPower(bool on);
+    void setPowerPolicy(M8PowerPolicy *policy);
+    void setRequestedUpdatePeriod(quint32 periodMs);
+    void setPowerDwellTime(int dwellMs);
+    M8_POWER_STATS powerStatistics();
+    void setFixSchedule(const M8_FIX_SCHEDULE &schedule);
+    void clearFixSchedule();
+    M8_SCHEDULE_STATS scheduleStatistics();
+    M8_GNSS_CONFIG gnssConfig();
+    void requestGnssConfig();
+    bool setGnssConfig(const M8_GNSS_CONFIG &config);
+    bool setGnssSystems(quint32 mask);
     void saveAutonomousAssistData();
     M8_STATUS status();
     void requestTime();
     void requestSatelliteInfo();
+    void sendUbxMessage(const QByteArray &message);
+    M8_TTFF_STATS ttffStatistics();
+    M8_METRICS metrics();
+    qint64 positionTimestamp();
+    void addSink(M8Sink *sink);
+    void removeSink(M8Sink *sink);
 
 signals:
     void statusChange(M8_STATUS status);
     void nmea(const QByteArray &nmea);
     void newPosition(double latitude, double longitude, float altitude, quint8 satellites);
+    void newFix(const M8_FIX &fix);
     void systemTimeDrift(qint64 offsetMilliseconds);
+    void timeSample(M8_TIME_SAMPLE sample);
     void satelliteInfo(M8_SV_INFO info);
+    void ttff(M8_TTFF ttff);
+    void powerModeChange(M8_POWER_MODE mode);
+    void scheduledFix(bool success);
+    void gnssConfigChange(M8_GNSS_CONFIG config);
+
+private slots:
+    void controlFix(const M8_FIX &fix);
 
 private:
-    void init(QString device, QByteArray configPath);
+    friend class M8Manager;
+    M8(QString device, QByteArray configPath, IoReactor *reactor, QThread *worker,
+       QObject *parent);
+
+    Qt::ConnectionType blocking();
+    void init(QString device, QByteArray configPath, IoReactor *reactor, QThread *worker);
 
 private:
     M8Control *m_control;
+    QThread *m_controlThread;
+    bool m_ownsControlThread;
+    qint64 m_positionTimestamp;
 };
 
 #endif // M8_H
@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_DECODER_H
+#define M8_DECODER_H
+
+#include "m8_global.h"
+#include <QString>
+#include <QVector>
+
+class QFile;
+
+/*
+ * Columnar output of M8Decoder::writeColumns(), one file per table. A file is M8_COLUMNS_HEADER,
+ * then one M8_COLUMN per column, then the values of each column in turn, rows * size bytes each.
+ * All fields are in host byte order.
+ */
+#define M8_COLUMNS_MAGIC 0x4D38434F /* "M8CO" */
+#define M8_COLUMNS_VERSION 1
+
+enum M8_COLUMN_TYPE { M8_COLUMN_INT = 0, M8_COLUMN_UINT, M8_COLUMN_FLOAT };
+
+struct M8_COLUMNS_HEADER {
+    quint32 magic; /* M8_COLUMNS_MAGIC */
+    quint16 version; /* M8_COLUMNS_VERSION */
+    quint16 columns;
+    quint64 rows;
+};
+
+struct M8_COLUMN {
+    char name[24]; /* Zero terminated */
+    quint32 type; /* M8_COLUMN_TYPE */
+    quint32 size; /* Bytes per value */
+};
+
+/**
+ * @brief GGA sentences with a fix, in capture order
+ */
+struct M8_DECODED_POSITIONS {
+    QVector<qint64> offset; /* Of the sentence in the capture [bytes] */
+    QVector<qint32> utcTimeOfDay; /* [ms since midnight] */
+    QVector<double> latitude; /* [deg] */
+    QVector<double> longitude; /* [deg] */
+    QVector<float> altitude; /* Above mean sea level [m] */
+    QVector<quint8> satellites; /* Satellites used in the fix */
+    QVector<float> hdop;
+};
+
+/**
+ * @brief UBX-NAV-TIMEUTC messages with a resolved time, in capture order
+ */
+struct M8_DECODED_TIMES {
+    QVector<qint64> offset; /* Of the frame in the capture [bytes] */
+    QVector<qint64> receiverTime; /* UTC [ns since the epoch] */
+    QVector<quint32> accuracy; /* [ns] */
+    QVector<quint8> valid; /* Validity flags of the message */
+};
+
+/**
+ * @brief UBX-NAV-SAT messages, in capture order
+ */
+struct M8_DECODED_SATELLITES {
+    QVector<qint64> offset; /* Of the frame in the capture [bytes] */
+    QVector<quint32> iTOW; /* GPS time of week [ms] */
+    QVector<quint8> numSvs; /* Satellites tracked */
+    QVector<quint8> used; /* Satellites used for navigation */
+    QVector<float> meanCno; /* Of the satellites with a signal [dBHz] */
+};
+
+/**
+ * @brief Decoder statistics
+ */
+struct M8_DECODER_STATS {
+    quint64 bytes; /* Size of the capture */
+    quint32 chunks; /* Pieces decoded in parallel */
+    quint32 redecodedChunks; /* Chunks whose start did not match the sequential framing */
+    quint64 nmeaFrames; /* NMEA sentences with a valid checksum */
+    quint64 ubxFrames; /* UBX frames with a valid checksum */
+    quint64 nmeaChecksumErrors;
+    quint64 ubxChecksumErrors;
+    quint64 framesRecovered; /* Frames found inside the bytes of a frame that was rejected */
+    quint64 resyncs; /* Times the stream was out of sync */
+    quint64 bytesDiscarded; /* Bytes outside any frame */
+};
+
+struct M8DecoderChunk;
+
+/**
+ * @brief Decodes a raw capture of the receiver stream using all cores
+ *
+ * The capture is memory mapped and split into chunks. Every chunk starts at a UBX sync or '$'
+ * that begins a frame with a valid checksum, and the chunks are decoded in parallel with the
+ * framing of the live path. A chunk whose start is not where framing the previous chunk ended is
+ * decoded again from there, so the result is always that of a sequential decode.
+ *
+ * A .m8rec recording is decoded from what it recorded as read from the receiver, gathered in a
+ * temporary file that is mapped the same way. Offsets are then into that stream rather than the
+ * recording.
+ */
+class M8_EXPORT M8Decoder
+{
+public:
+    M8Decoder();
+
+    void setThreads(int threads);
+    void setChunkSize(qint64 bytes);
+    bool decode(const QString &path);
+
+    const M8_DECODED_POSITIONS &positions() const;
+    const M8_DECODED_TIMES &times() const;
+    const M8_DECODED_SATELLITES &satellites() const;
+    M8_DECODER_STATS statistics() const;
+
+    bool writeCsv(const QString &directory) const;
+    bool writeColumns(const QString &directory) const;
+
+private:
+    Q_DISABLE_COPY(M8Decoder)
+
+    bool readRecording(const QString &path, QFile *stream) const;
+    bool decodeFile(QFile *file, const QString &path);
+    void decodeData();
+    qint64 nextFrameStart(qint64 offset, qint64 limit) const;
+    void decodeChunk(M8DecoderChunk *chunk) const;
+    void merge(const M8DecoderChunk &chunk);
+
+private:
+    const char *m_data;
+    qint64 m_size;
+    int m_threads;
+    qint64 m_chunkSize;
+    M8_DECODED_POSITIONS m_positions;
+    M8_DECODED_TIMES m_times;
+    M8_DECODED_SATELLITES m_satellites;
+    M8_DECODER_STATS m_stats;
+};
+
+#endif // M8_DECODER_H
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_FIX_H
+#define M8_FIX_H
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief Fix type, as in gpsFix of UBX-NAV-PVT
+ */
+enum M8_FIX_TYPE {
+    M8_FIX_NONE = 0,
+    M8_FIX_DEAD_RECKONING,
+    M8_FIX_2D,
+    M8_FIX_3D,
+    M8_FIX_GNSS_DEAD_RECKONING,
+    M8_FIX_TIME_ONLY
+};
+
+/**
+ * @brief Fix quality, as in the quality indicator of NMEA GGA
+ */
+enum M8_FIX_QUALITY {
+    M8_FIX_QUALITY_INVALID = 0,
+    M8_FIX_QUALITY_GNSS = 1,
+    M8_FIX_QUALITY_DGNSS = 2,
+    M8_FIX_QUALITY_RTK_FIXED = 4,
+    M8_FIX_QUALITY_RTK_FLOAT = 5,
+    M8_FIX_QUALITY_DEAD_RECKONING = 6
+};
+
+/**
+ * @brief Fields of M8_FIX that are set, beyond position and satellites
+ *
+ * GGA sets the UTC time, height and horizontal DOP. UBX-NAV-PVT sets all but the horizontal and
+ * vertical DOP, which come from UBX-NAV-DOP of the same epoch when it is enabled.
+ */
+#define M8_FIX_HAS_TIME 0x0001 /* utcTimeOfDay */
+#define M8_FIX_HAS_HEIGHT 0x0002 /* height */
+#define M8_FIX_HAS_ACCURACY 0x0004 /* horizontalAccuracy, verticalAccuracy */
+#define M8_FIX_HAS_VELOCITY 0x0008 /* velocityNorth, velocityEast, velocityDown, groundSpeed */
+#define M8_FIX_HAS_HEADING 0x0010 /* heading */
+#define M8_FIX_HAS_PDOP 0x0020
+#define M8_FIX_HAS_HDOP 0x0040
+#define M8_FIX_HAS_VDOP 0x0080
+
+/**
+ * @brief Position fix
+ *
+ * Fields not flagged in fields are zero.
+ */
+struct M8_FIX {
+    qint64 timestamp; /* CLOCK_MONOTONIC time the fix was read from the device [ns] */
+    double latitude; /* [deg] */
+    double longitude; /* [deg] */
+    float altitude; /* Above mean sea level [m] */
+    quint8 satellites; /* Satellites used in the fix */
+    quint8 fixType; /* M8_FIX_TYPE */
+    quint8 quality; /* M8_FIX_QUALITY */
+    quint16 fields; /* M8_FIX_HAS_* */
+    qint32 utcTimeOfDay; /* UTC time of the fix [ms since midnight] */
+    float height; /* Above the ellipsoid [m] */
+    float horizontalAccuracy; /* Estimate [m] */
+    float verticalAccuracy; /* Estimate [m] */
+    float velocityNorth; /* [m/s] */
+    float velocityEast; /* [m/s] */
+    float velocityDown; /* [m/s] */
+    float groundSpeed; /* [m/s] */
+    float heading; /* Heading of motion [deg] */
+    float pdop; /* Position dilution of precision */
+    float hdop; /* Horizontal dilution of precision */
+    float vdop; /* Vertical dilution of precision */
+};
+
+#endif // M8_FIX_H
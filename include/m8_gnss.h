@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_GNSS_H
+#define M8_GNSS_H
+
+#include <QtCore/qglobal.h>
+#include <QList>
+
+/**
+ * @brief GNSS identifiers used by UBX-CFG-GNSS
+ */
+enum M8_GNSS_ID {
+    M8_GNSS_GPS = 0,
+    M8_GNSS_SBAS = 1,
+    M8_GNSS_GALILEO = 2,
+    M8_GNSS_BEIDOU = 3,
+    M8_GNSS_IMES = 4,
+    M8_GNSS_QZSS = 5,
+    M8_GNSS_GLONASS = 6
+};
+
+/* Bit for a system in a GNSS mask */
+#define M8_GNSS_MASK(id) (1u << (id))
+
+/**
+ * @brief Configuration of one GNSS system
+ */
+struct M8_GNSS_BLOCK {
+    quint8 gnssId; /* M8_GNSS_ID */
+    quint8 resTrkCh; /* Tracking channels reserved */
+    quint8 maxTrkCh; /* Maximum tracking channels used */
+    bool enabled;
+    quint32 flags; /* Raw flags, including the signal configuration mask */
+};
+
+/**
+ * @brief UBX-CFG-GNSS configuration and UBX-MON-GNSS capabilities
+ *
+ * The MON-GNSS masks use their own bit order: GPS 0x01, GLONASS 0x02, BeiDou 0x04, Galileo 0x08.
+ */
+struct M8_GNSS_CONFIG {
+    bool valid; /* Whether the configuration has been read from the receiver */
+    quint8 numTrkChHw; /* Tracking channels available in hardware (read only) */
+    quint8 numTrkChUse; /* Tracking channels to use, 0xFF for all */
+    QList<M8_GNSS_BLOCK> blocks;
+    quint8 supported; /* MON-GNSS supported systems */
+    quint8 defaultGnss; /* MON-GNSS default systems */
+    quint8 enabled; /* MON-GNSS enabled systems */
+    quint8 simultaneous; /* MON-GNSS maximum concurrent major systems */
+};
+
+#endif // M8_GNSS_H
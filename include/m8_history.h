@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_HISTORY_H
+#define M8_HISTORY_H
+
+#include "m8_global.h"
+#include "m8_sink.h"
+#include <QVector>
+
+struct M8FixHistoryColumns;
+
+/**
+ * @brief Ring buffer of the latest fixes of a receiver
+ *
+ * Added to a receiver with M8::addSink, it is written on the parser thread and can be queried
+ * from any thread. The fixes are kept column by column in memory allocated up front, so a time
+ * window is found with a binary search over the timestamps alone. Queries never block the parser:
+ * a query that raced with the fix being written over its oldest fix is simply repeated.
+ */
+class M8_EXPORT M8FixHistory : public M8Sink
+{
+public:
+    explicit M8FixHistory(int capacity);
+    ~M8FixHistory() override;
+
+    int capacity() const;
+    quint64 count() const;
+    QVector<M8_FIX> latest(int fixes) const;
+    QVector<M8_FIX> window(qint64 from, qint64 to) const;
+
+    void fix(const M8_FIX &fix) override;
+
+private:
+    Q_DISABLE_COPY(M8FixHistory)
+
+    quint64 bound(quint64 first, quint64 last, qint64 timestamp, bool after) const;
+    bool copy(quint64 first, quint64 last, QVector<M8_FIX> *fixes) const;
+
+private:
+    M8FixHistoryColumns *m_columns;
+    int m_capacity;
+    quint64 m_mask;
+    quint64 m_count;
+};
+
+#endif // M8_HISTORY_H
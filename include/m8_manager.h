@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_MANAGER_H
+#define M8_MANAGER_H
+
+#include "m8.h"
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief Many receivers served by shared threads
+ *
+ * Instead of an I/O thread per receiver, all devices are read and written by one epoll thread.
+ * Framing, parsing and the receiver logic run on a bounded pool of parser workers, and each
+ * receiver stays on the least loaded worker it was given. Signals of the M8 objects are
+ * delivered on the thread that created the manager.
+ */
+class M8_EXPORT M8Manager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit M8Manager(int maxParserThreads = 0, QObject *parent = nullptr);
+    ~M8Manager();
+
+    M8 *addReceiver(QString device, QByteArray configPath = "/etc/m8.conf");
+    void removeReceiver(M8 *receiver);
+    QList<M8 *> receivers();
+    int parserThreads();
+    M8_METRICS metrics();
+
+private:
+    IoReactor *m_reactor;
+    int m_maxParserThreads;
+    QVector<QThread *> m_workers;
+    QHash<M8 *, int> m_receivers; /* Worker index of each receiver */
+};
+
+#endif // M8_MANAGER_H
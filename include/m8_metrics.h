@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_METRICS_H
+#define M8_METRICS_H
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief NMEA sentence types counted separately
+ */
+enum M8_NMEA_MSG { M8_NMEA_GGA = 0, M8_NMEA_OTHER, M8_NMEA_MSG_TYPES };
+
+/**
+ * @brief UBX message types counted separately
+ */
+enum M8_UBX_MSG {
+    M8_UBX_NAV_TIMEUTC = 0,
+    M8_UBX_NAV_SAT,
+    M8_UBX_NAV_OTHER,
+    M8_UBX_ACK,
+    M8_UBX_NAK,
+    M8_UBX_CFG,
+    M8_UBX_MON,
+    M8_UBX_MGA,
+    M8_UBX_OTHER,
+    M8_UBX_MSG_TYPES
+};
+
+/**
+ * @brief Stages timed between reading a fix from the device and delivering it
+ */
+enum M8_LATENCY_STAGE {
+    M8_LATENCY_DEVICE_TO_CONTROL = 0, /* Read on the device thread until framing starts */
+    M8_LATENCY_FRAMING, /* Framing starts until the frame is complete */
+    M8_LATENCY_PARSING, /* Frame complete until it is decoded */
+    M8_LATENCY_DELIVERY, /* Emitting newPosition, including directly connected slots */
+    M8_LATENCY_END_TO_END, /* Read until newPosition has been delivered */
+    M8_LATENCY_CONSUMER, /* Read until the position reached the thread of M8 */
+    M8_LATENCY_STAGES
+};
+
+#define M8_LATENCY_BINS 24
+
+/**
+ * @brief Latency distribution
+ *
+ * Bin 0 counts latencies below 1 us and bin n counts latencies in [2^(n-1), 2^n) us. The last bin
+ * also holds everything above.
+ */
+struct M8_LATENCY_HISTOGRAM {
+    quint64 count;
+    quint64 sumNs; /* [ns] */
+    quint64 maxNs; /* [ns] */
+    quint64 bins[M8_LATENCY_BINS];
+};
+
+/**
+ * @brief Snapshot of the runtime counters of one receiver
+ *
+ * All counters are totals since the M8 object was created, except the send queue depths.
+ */
+struct M8_METRICS {
+    /* Device */
+    quint64 bytesRead;
+    quint64 readCalls;
+    quint64 bytesWritten;
+    quint64 writeCalls;
+    quint64 writeErrors;
+    quint64 rxWakeups; /* Times the consumer was woken for received data */
+    quint64 rxQueueStalls; /* Times reading paused because the receive ring was full */
+    quint64 txQueueDrops; /* Messages dropped because the transmit ring was full */
+
+    /* Recorder */
+    quint64 recordedBytes; /* Written to recording files, including chunk headers */
+    quint64 recordDrops; /* Chunks dropped because the recorder could not keep up */
+
+    /* Framing */
+    quint64 nmeaFrames[M8_NMEA_MSG_TYPES];
+    quint64 ubxFrames[M8_UBX_MSG_TYPES];
+    quint64 nmeaChecksumErrors;
+    quint64 ubxChecksumErrors;
+    quint64 framesRecovered; /* Frames found inside the bytes of a frame that was rejected */
+    quint64 resyncs; /* Times framing had to skip unrecognised data */
+    quint64 bytesDiscarded; /* Bytes skipped while resynchronising */
+
+    /* Send queue */
+    quint64 messagesSent;
+    quint64 ackTimeouts;
+    quint64 sendQueueDepth; /* Messages waiting to be sent */
+    quint64 sendQueueMaxDepth; /* Highest depth seen */
+
+    /* Threads */
+    quint64 deviceThreadCpuNs; /* CPU time used by the device thread [ns] */
+    quint64 parserThreadCpuNs; /* CPU time used by the thread framing and parsing [ns] */
+
+    /* Latency of position fixes, indexed by M8_LATENCY_STAGE */
+    M8_LATENCY_HISTOGRAM latency[M8_LATENCY_STAGES];
+};
+
+#endif // M8_METRICS_H
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_POWER_H
+#define M8_POWER_H
+
+#include "m8_global.h"
+
+/**
+ * @brief Receiver power mode
+ */
+enum M8_POWER_MODE {
+    M8_POWER_CONTINUOUS = 0, /* Continuous tracking, no power save */
+    M8_POWER_CYCLIC_TRACKING, /* Power save mode, cyclic tracking */
+    M8_POWER_ON_OFF, /* Power save mode, receiver off between fixes */
+    M8_POWER_MODES
+};
+
+/**
+ * @brief Power mode with its UBX-CFG-PM2 timing
+ *
+ * Periods are ignored in continuous mode.
+ */
+struct M8_POWER_SETTINGS {
+    M8_POWER_MODE mode;
+    quint32 updatePeriodMs; /* Time between position fixes [ms] */
+    quint32 searchPeriodMs; /* Time between acquisition attempts without a fix [ms] */
+    quint16 onTimeS; /* Time to stay in tracking state after a fix, ON/OFF only [s] */
+};
+
+/**
+ * @brief Observations a power policy decides from
+ */
+struct M8_POWER_INPUT {
+    quint8 satellites; /* Satellites used in the latest fix */
+    quint8 trackedSatellites; /* Satellites with a C/N0 in the latest UBX-NAV-SAT */
+    float meanCno; /* Mean C/N0 of the four strongest satellites [dBHz], 0 if unknown */
+    float minCno; /* Weakest C/N0 of those satellites [dBHz], 0 if unknown */
+    float horizontalAccuracy; /* Receiver estimate or from HDOP [m], negative if unknown */
+    quint32 requestedPeriodMs; /* Update period requested by the application [ms] */
+    bool fix; /* Whether the receiver currently has a fix */
+};
+
+/**
+ * @brief Time spent in each power mode
+ */
+struct M8_POWER_STATS {
+    M8_POWER_MODE mode; /* Current mode */
+    quint64 timeInModeMs[M8_POWER_MODES]; /* [ms] */
+    quint64 timeStoppedMs; /* Time with the GNSS engine stopped [ms] */
+    quint32 transitions; /* Mode changes sent to the receiver */
+};
+
+/**
+ * @brief Power management policy
+ *
+ * select() is called on every fix and every satellite update. It may return a different mode
+ * at any time; hysteresis belongs in the policy, while the minimum dwell time in a mode is
+ * enforced by the library.
+ */
+class M8_EXPORT M8PowerPolicy
+{
+public:
+    virtual ~M8PowerPolicy();
+
+    virtual M8_POWER_SETTINGS select(const M8_POWER_INPUT &input,
+                                     const M8_POWER_SETTINGS &current) = 0;
+
+    /* Whether the library should poll UBX-NAV-SAT to provide C/N0 statistics */
+    virtual bool needsSatelliteInfo() const;
+};
+
+/**
+ * @brief Cyclic tracking at 1 Hz when enough satellites are used in the fix
+ *
+ * This is the behaviour of the "powersave:1" configuration.
+ */
+class M8_EXPORT M8SatelliteCountPolicy : public M8PowerPolicy
+{
+public:
+    explicit M8SatelliteCountPolicy(quint8 enterSatellites = 10, quint8 leaveSatellites = 6);
+
+    M8_POWER_SETTINGS select(const M8_POWER_INPUT &input,
+                             const M8_POWER_SETTINGS &current) override;
+
+private:
+    quint8 m_enterSatellites;
+    quint8 m_leaveSatellites;
+};
+
+/**
+ * @brief Power mode from signal strength, accuracy and the requested update period
+ *
+ * Leaves continuous mode when the strongest satellites reach enterCno on average with none of them
+ * below leaveCno and the accuracy is within maxAccuracy, and returns when their mean drops below
+ * leaveCno or the accuracy exceeds it by half.
+ * Requested periods of at least onOffPeriodMs use ON/OFF operation, shorter ones cyclic tracking.
+ */
+class M8_EXPORT M8SignalQualityPolicy : public M8PowerPolicy
+{
+public:
+    explicit M8SignalQualityPolicy(float enterCno = 35, float leaveCno = 28,
+                                   float maxAccuracy = 10, quint32 onOffPeriodMs = 10000,
+                                   quint16 onTimeS = 2);
+
+    M8_POWER_SETTINGS select(const M8_POWER_INPUT &input,
+                             const M8_POWER_SETTINGS &current) override;
+    bool needsSatelliteInfo() const override;
+
+private:
+    float m_enterCno;
+    float m_leaveCno;
+    float m_maxAccuracy;
+    quint32 m_onOffPeriodMs;
+    quint16 m_onTimeS;
+};
+
+#endif // M8_POWER_H
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_RECORD_H
+#define M8_RECORD_H
+
+#include <QtCore/qglobal.h>
+
+/*
+ * Recording of the raw receiver stream, written with "record:<directory>" in the configuration.
+ *
+ * A recording is a sequence of files, each starting with M8_RECORD_HEADER and followed by
+ * chunks. A chunk is M8_RECORD_CHUNK followed by size bytes exactly as read from or written to
+ * the device. Next to every .m8rec file is a .m8idx file with M8_RECORD_INDEX_HEADER followed by
+ * M8_RECORD_INDEX_ENTRY records in time order, pointing at chunk headers at least every
+ * M8_RECORD_INDEX_INTERVAL_MS or M8_RECORD_INDEX_INTERVAL_BYTES. All fields are in host byte
+ * order.
+ */
+
+#define M8_RECORD_MAGIC 0x4D385243 /* "M8RC" */
+#define M8_RECORD_INDEX_MAGIC 0x4D385249 /* "M8RI" */
+#define M8_RECORD_VERSION 1
+#define M8_RECORD_INDEX_INTERVAL_MS 1000
+#define M8_RECORD_INDEX_INTERVAL_BYTES (64 * 1024)
+
+enum M8_RECORD_DIRECTION {
+    M8_RECORD_RX = 0, /* Read from the receiver */
+    M8_RECORD_TX /* Written to the receiver */
+};
+
+struct M8_RECORD_HEADER {
+    quint32 magic; /* M8_RECORD_MAGIC */
+    quint16 version; /* M8_RECORD_VERSION */
+    quint16 headerSize; /* sizeof(M8_RECORD_HEADER), the offset of the first chunk */
+    qint64 startTimestamp; /* CLOCK_MONOTONIC time of the first chunk [ns] */
+    qint64 startRealtime; /* CLOCK_REALTIME at startTimestamp [ns] */
+    quint32 baudRate; /* Of the device, 0 if unknown */
+    quint32 reserved;
+};
+
+struct M8_RECORD_CHUNK {
+    qint64 timestamp; /* CLOCK_MONOTONIC time the data was read or queued for writing [ns] */
+    quint32 size; /* Bytes following this header */
+    quint8 direction; /* M8_RECORD_DIRECTION */
+    quint8 reserved[3];
+};
+
+struct M8_RECORD_INDEX_HEADER {
+    quint32 magic; /* M8_RECORD_INDEX_MAGIC */
+    quint16 version; /* M8_RECORD_VERSION */
+    quint16 reserved;
+};
+
+struct M8_RECORD_INDEX_ENTRY {
+    qint64 timestamp; /* Of the chunk */
+    quint64 offset; /* Of the chunk header in the .m8rec file */
+};
+
+#endif // M8_RECORD_H
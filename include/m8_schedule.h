@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_SCHEDULE_H
+#define M8_SCHEDULE_H
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief Periodic fix schedule
+ *
+ * The GNSS engine is started ahead of every deadline by the expected time to first fix plus the
+ * margin, and stopped as soon as a fix meets the accuracy.
+ */
+struct M8_FIX_SCHEDULE {
+    quint32 intervalS; /* Time between fix deadlines [s] */
+    float accuracyM; /* Required horizontal accuracy [m], 0 accepts any fix */
+    quint32 marginS; /* Extra start time on top of the expected time to first fix [s] */
+    quint32 timeoutS; /* How long to keep trying after a deadline is missed [s] */
+    quint8 maxBackoff; /* Misses double the wait, up to 2^maxBackoff intervals or a day */
+};
+
+/**
+ * @brief Outcome of the fix schedule so far
+ */
+struct M8_SCHEDULE_STATS {
+    quint32 attempts; /* Engine starts */
+    quint32 fixes; /* Fixes meeting the accuracy */
+    quint32 late; /* Fixes meeting the accuracy after the deadline */
+    quint32 missed; /* Attempts that timed out */
+    quint32 consecutiveMisses;
+    qint64 lastTimeToFixMs; /* Engine start to accepted fix of the last success [ms] */
+    quint64 engineOnMs; /* Total time the engine ran for the schedule [ms] */
+};
+
+#endif // M8_SCHEDULE_H
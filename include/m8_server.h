@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_SERVER_H
+#define M8_SERVER_H
+
+#include "m8.h"
+#include <QAtomicInteger>
+#include <QList>
+
+/**
+ * @brief Message streams a client can subscribe to
+ */
+#define M8_SERVER_NMEA 0x01 /* NMEA sentences from the receiver */
+#define M8_SERVER_UBX 0x02 /* UBX frames from the receiver, with sync characters and checksum */
+#define M8_SERVER_FIX 0x04 /* $PM8FIX,<timestamp ns>,<lat>,<lon>,<alt>,<satellites>*<checksum> */
+
+/**
+ * @brief Server statistics
+ */
+struct M8_SERVER_STATS {
+    quint32 clients; /* Connected clients */
+    quint64 framesSent; /* Frames written completely to a client */
+    quint64 framesDropped; /* Frames dropped from the queues of slow clients */
+    quint64 commandsRouted; /* UBX messages from clients passed to the receiver */
+};
+
+struct M8ServerClient;
+class QSocketNotifier;
+
+/**
+ * @brief Re-publishes the data of one receiver to Unix domain socket clients
+ *
+ * Clients get M8_SERVER_NMEA until they subscribe by sending "$PM8SUB,<mask>" followed by a line
+ * break, with the mask in hexadecimal. Every frame is one shared buffer written to all clients
+ * that subscribed to it. A client whose queue exceeds the limit loses its oldest frames.
+ * Complete UBX frames sent by a client are passed to the receiver through its send queue.
+ */
+class M8_EXPORT M8Server : public QObject, private M8Sink
+{
+    Q_OBJECT
+public:
+    explicit M8Server(M8 *receiver, QObject *parent = nullptr);
+    ~M8Server() override;
+
+    bool listen(const QString &path);
+    void close();
+    void setClientQueueLimit(int bytes);
+    M8_SERVER_STATS statistics();
+
+private slots:
+    void acceptClient();
+
+private:
+    void fix(const M8_FIX &fix) override;
+    void nmea(const QByteArray &sentence) override;
+    void ubx(const QByteArray &frame) override;
+
+    void publish(int type, const QByteArray &frame);
+    void readClient(M8ServerClient *client);
+    bool flush(M8ServerClient *client);
+    void command(M8ServerClient *client);
+    void removeClient(M8ServerClient *client);
+    void updateSubscriptions();
+
+private:
+    M8 *p_receiver;
+    int m_listenFd;
+    QByteArray m_path;
+    QSocketNotifier *m_listenNotifier;
+    QList<M8ServerClient *> m_clients;
+    QAtomicInteger<int> m_subscriptions; /* Union of all client masks, read by the parser */
+    int m_queueLimit;
+    quint64 m_framesSent;
+    quint64 m_framesDropped;
+    quint64 m_commandsRouted;
+};
+
+#endif // M8_SERVER_H
@@ -0,0 +1,222 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_SHM_H
+#define M8_SHM_H
+
+/*
+ * Shared memory layout of the receiver state published with "shm:<name>" in the configuration,
+ * and a reader that needs nothing but this header.
+ *
+ * The segment is a POSIX shared memory object with the name from the configuration. It holds a
+ * ring of the latest fixes, the latest UBX-NAV-SAT snapshot and the latest time sample. Every
+ * record is guarded by a sequence counter, which the writer makes odd while it updates the
+ * record and even again once the record is complete. A reader copies the record and retries if
+ * the counter was odd or changed meanwhile, so readers never block the writer and reading takes
+ * no system calls. All fields are in host byte order.
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define M8_SHM_MAGIC 0x4D385348 /* "M8SH" */
+#define M8_SHM_VERSION 1
+#define M8_SHM_FIX_SLOTS 64 /* Power of two */
+#define M8_SHM_MAX_SVS 128
+
+struct M8_SHM_FIX {
+    int64_t timestamp; /* CLOCK_MONOTONIC time the fix was read from the device [ns] */
+    double latitude; /* [deg] */
+    double longitude; /* [deg] */
+    float altitude; /* Above mean sea level [m] */
+    uint8_t satellites; /* Satellites used in the fix */
+    uint8_t reserved[3];
+};
+
+struct M8_SHM_SV {
+    uint8_t gnssId;
+    uint8_t svId;
+    uint8_t cno; /* [dBHz] */
+    int8_t elev; /* [deg] */
+    int16_t azim; /* [deg] */
+    int16_t prRes; /* [m] */
+    uint32_t flags;
+};
+
+struct M8_SHM_SV_INFO {
+    int64_t timestamp; /* CLOCK_MONOTONIC time the snapshot was published [ns] */
+    uint32_t iTOW; /* [ms] */
+    uint8_t version;
+    uint8_t numSvs; /* Satellites in sv, at most M8_SHM_MAX_SVS */
+    uint8_t reserved[2];
+    struct M8_SHM_SV sv[M8_SHM_MAX_SVS];
+};
+
+struct M8_SHM_TIME {
+    int64_t captureTimestamp; /* See M8_TIME_SAMPLE */
+    int64_t hostTime;
+    int64_t receiverTime;
+    int64_t offset;
+    uint32_t accuracy;
+    uint8_t valid;
+    uint8_t reserved[3];
+};
+
+/* Records are aligned to cache lines, so updating one does not disturb readers of another */
+struct M8_SHM_FIX_RECORD {
+    uint32_t seq;
+    uint32_t reserved;
+    struct M8_SHM_FIX fix;
+} __attribute__((aligned(64)));
+
+struct M8_SHM_SV_INFO_RECORD {
+    uint32_t seq;
+    uint32_t reserved;
+    struct M8_SHM_SV_INFO info;
+} __attribute__((aligned(64)));
+
+struct M8_SHM_TIME_RECORD {
+    uint32_t seq;
+    uint32_t reserved;
+    struct M8_SHM_TIME time;
+} __attribute__((aligned(64)));
+
+struct M8_SHM_SEGMENT {
+    uint32_t magic; /* M8_SHM_MAGIC once the segment is initialised */
+    uint32_t version; /* M8_SHM_VERSION */
+    uint32_t size; /* sizeof(struct M8_SHM_SEGMENT) */
+    uint32_t fixSlots; /* M8_SHM_FIX_SLOTS */
+    uint64_t fixCount; /* Fixes written. The latest is in fixes[(fixCount - 1) % fixSlots]. */
+    struct M8_SHM_FIX_RECORD fixes[M8_SHM_FIX_SLOTS];
+    struct M8_SHM_SV_INFO_RECORD satellites;
+    struct M8_SHM_TIME_RECORD time;
+};
+
+/**
+ * @brief Read access to a published segment
+ *
+ * Any number of processes may read the same segment. The methods copy one record and return
+ * false if there is nothing to read.
+ */
+class M8ShmReader
+{
+public:
+    M8ShmReader() : m_segment(nullptr) { }
+    ~M8ShmReader() { close(); }
+
+    bool open(const char *name)
+    {
+        close();
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        void *mem = mmap(nullptr, sizeof(M8_SHM_SEGMENT), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == mem)
+            return false;
+        m_segment = static_cast<const M8_SHM_SEGMENT *>(mem);
+        if (__atomic_load_n(&m_segment->magic, __ATOMIC_ACQUIRE) != M8_SHM_MAGIC
+            || m_segment->version != M8_SHM_VERSION || m_segment->size != sizeof(M8_SHM_SEGMENT)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        if (m_segment)
+            munmap(const_cast<M8_SHM_SEGMENT *>(m_segment), sizeof(M8_SHM_SEGMENT));
+        m_segment = nullptr;
+    }
+
+    bool isOpen() const { return (m_segment != nullptr); }
+
+    /* Fixes written so far. Fix number n stays readable until n + M8_SHM_FIX_SLOTS is written. */
+    uint64_t fixCount() const
+    {
+        return m_segment ? __atomic_load_n(&m_segment->fixCount, __ATOMIC_ACQUIRE) : 0;
+    }
+
+    bool fix(M8_SHM_FIX *fix) const
+    {
+        uint64_t count = fixCount();
+        return (count > 0) && fixAt(count - 1, fix);
+    }
+
+    /* false if fix number n is not written yet or has been overwritten */
+    bool fixAt(uint64_t n, M8_SHM_FIX *fix) const
+    {
+        if (!m_segment)
+            return false;
+        const M8_SHM_FIX_RECORD &record = m_segment->fixes[n & (M8_SHM_FIX_SLOTS - 1)];
+        // The record holds fix number n once the sequence has been bumped for it
+        uint32_t expected = static_cast<uint32_t>(n / M8_SHM_FIX_SLOTS + 1) * 2;
+        uint32_t seq;
+        if (!read(&record.seq, &record.fix, fix, sizeof(*fix), &seq))
+            return false;
+        return (seq == expected);
+    }
+
+    bool satellites(M8_SHM_SV_INFO *info) const
+    {
+        uint32_t seq;
+        return m_segment
+                && read(&m_segment->satellites.seq, &m_segment->satellites.info, info,
+                        sizeof(*info), &seq)
+                && seq > 0;
+    }
+
+    bool time(M8_SHM_TIME *time) const
+    {
+        uint32_t seq;
+        return m_segment
+                && read(&m_segment->time.seq, &m_segment->time.time, time, sizeof(*time), &seq)
+                && seq > 0;
+    }
+
+private:
+    static bool read(const uint32_t *seqPtr, const void *src, void *dst, size_t size,
+                     uint32_t *seq)
+    {
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            uint32_t before = __atomic_load_n(seqPtr, __ATOMIC_ACQUIRE);
+            if (before & 1)
+                continue;
+            memcpy(dst, src, size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seqPtr, __ATOMIC_RELAXED) == before) {
+                *seq = before;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const M8_SHM_SEGMENT *m_segment;
+};
+
+#endif // M8_SHM_H
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_SINK_H
+#define M8_SINK_H
+
+#include "m8_fix.h"
+#include "m8_global.h"
+#include "m8_sv_info.h"
+#include "m8_time.h"
+#include <QByteArray>
+
+/**
+ * @brief Direct receiver of decoded data
+ *
+ * Sinks are called synchronously on the thread that parses the receiver data, before any of the
+ * corresponding signals of M8 are emitted. The references are only valid during the call, and
+ * an implementation must return quickly, as it holds up the parsing of the following data.
+ * Only the methods of interest need to be overridden.
+ */
+class M8_EXPORT M8Sink
+{
+public:
+    virtual ~M8Sink();
+
+    virtual void fix(const M8_FIX &fix);
+    virtual void satelliteInfo(const M8_SV_INFO &info);
+    virtual void timeSample(const M8_TIME_SAMPLE &sample);
+
+    /*
+     * Raw frames with a valid checksum. NMEA sentences end with the carriage return, before the
+     * line feed, and UBX frames start at the message class, after the sync characters.
+     */
+    virtual void nmea(const QByteArray &sentence);
+    virtual void ubx(const QByteArray &frame);
+};
+
+#endif // M8_SINK_H
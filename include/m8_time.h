@@ -0,0 +1,51 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_TIME_H
+#define M8_TIME_H
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief UBX-NAV-TIMEUTC validity flags
+ */
+#define M8_TIME_VALID_TOW 0x01 /* Valid time of week */
+#define M8_TIME_VALID_WKN 0x02 /* Valid week number */
+#define M8_TIME_VALID_UTC 0x04 /* Valid UTC time */
+
+/**
+ * @brief Receiver time measured against the host clock
+ *
+ * The host time is taken when the message was read, moved back by the time it took to transmit
+ * the message at the configured baud rate.
+ */
+struct M8_TIME_SAMPLE {
+    qint64 captureTimestamp; /* CLOCK_MONOTONIC time the message was read [ns] */
+    qint64 hostTime; /* CLOCK_REALTIME when the receiver started sending the message [ns] */
+    qint64 receiverTime; /* Receiver UTC time since the epoch [ns] */
+    qint64 offset; /* receiverTime - hostTime [ns] */
+    quint32 accuracy; /* Receiver time accuracy estimate, tAcc [ns] */
+    quint8 valid; /* Validity flags, M8_TIME_VALID_* */
+};
+
+#endif // M8_TIME_H
@@ -0,0 +1,132 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_TRACK_H
+#define M8_TRACK_H
+
+#include "m8_fix.h"
+#include "m8_global.h"
+#include <QByteArray>
+#include <QVector>
+
+/*
+ * Compressed track format of M8TrackEncoder. A track is the 4 magic bytes "M8TK" and a version
+ * byte, followed by one record per point. A record is four zigzag encoded LEB128 varints:
+ *  - change of the time step from the previous record [ms]
+ *  - change of latitude [1e-7 deg]
+ *  - change of longitude [1e-7 deg]
+ *  - change of altitude [cm]
+ * The first record is relative to a point at time 0 with a time step of 0.
+ */
+#define M8_TRACK_MAGIC "M8TK"
+#define M8_TRACK_VERSION 1
+#define M8_TRACK_WINDOW 64 /* Most points M8TrackEncoder holds back */
+
+/**
+ * @brief Point of a track, at the resolution it is stored with
+ */
+struct M8_TRACK_POINT {
+    qint64 timestamp; /* [ns], stored in ms */
+    double latitude; /* [deg], stored in 1e-7 deg */
+    double longitude; /* [deg], stored in 1e-7 deg */
+    float altitude; /* [m], stored in cm */
+};
+
+/**
+ * @brief Encoder statistics
+ */
+struct M8_TRACK_STATS {
+    quint64 points; /* Points added */
+    quint64 encodedPoints; /* Points kept after simplification */
+    quint64 bytes; /* Encoded, including the header */
+};
+
+/**
+ * @brief Streaming encoder of tracks in the M8_TRACK_MAGIC format
+ *
+ * With a tolerance, points are dropped as long as every dropped point stays within the tolerance
+ * of the straight line between the points kept around it. The points since the last kept one are
+ * held back in a window of at most M8_TRACK_WINDOW points, so a point is encoded at the latest
+ * that many points after it was added, or by flush().
+ */
+class M8_EXPORT M8TrackEncoder
+{
+public:
+    explicit M8TrackEncoder(double tolerance = 0);
+
+    void add(const M8_TRACK_POINT &point);
+    void add(const M8_FIX &fix);
+    void flush();
+    QByteArray takeData();
+    M8_TRACK_STATS statistics() const;
+
+private:
+    bool withinTolerance(const M8_TRACK_POINT &end) const;
+    void encode(const M8_TRACK_POINT &point);
+    void writeVarint(qint64 value);
+
+private:
+    double m_tolerance;
+    QByteArray m_data;
+    QVector<M8_TRACK_POINT> m_window;
+    M8_TRACK_POINT m_anchor;
+    bool m_started;
+    qint64 m_time;
+    qint64 m_step;
+    qint64 m_latitude;
+    qint64 m_longitude;
+    qint64 m_altitude;
+    M8_TRACK_STATS m_stats;
+};
+
+/**
+ * @brief Streaming decoder of tracks in the M8_TRACK_MAGIC format
+ *
+ * Data may be appended in pieces of any size. Points are returned once their record is
+ * complete.
+ */
+class M8_EXPORT M8TrackDecoder
+{
+public:
+    M8TrackDecoder();
+
+    void append(const QByteArray &data);
+    bool next(M8_TRACK_POINT *point);
+    bool hasError() const;
+
+private:
+    bool readVarint(int *offset, qint64 *value);
+
+private:
+    QByteArray m_input;
+    int m_offset;
+    bool m_started;
+    bool m_error;
+    qint64 m_time;
+    qint64 m_step;
+    qint64 m_latitude;
+    qint64 m_longitude;
+    qint64 m_altitude;
+};
+
+#endif // M8_TRACK_H
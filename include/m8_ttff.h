@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef M8_TTFF_H
+#define M8_TTFF_H
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief Start condition of a time-to-first-fix measurement
+ *
+ * Derived from the assistance available to the receiver when the measurement started.
+ */
+enum M8_START_TYPE {
+    M8_START_COLD = 0, /* No assistance */
+    M8_START_WARM, /* Time assistance injected */
+    M8_START_HOT, /* Navigation database uploaded, or engine restarted after a fix */
+    M8_START_TYPES
+};
+
+#define M8_TTFF_HISTOGRAM_BINS 12
+
+/* Upper bound of each histogram bin [ms]. The last bin holds everything above 300 s. */
+static const quint32 M8_TTFF_HISTOGRAM_LIMITS[M8_TTFF_HISTOGRAM_BINS] = {
+    1000, 2000, 5000, 10000, 20000, 30000, 45000, 60000, 90000, 120000, 300000, 0xFFFFFFFF
+};
+
+/**
+ * @brief Distribution of one measured interval
+ */
+struct M8_TTFF_HISTOGRAM {
+    quint32 count; /* Number of measurements */
+    quint32 minMs; /* Shortest measurement [ms] */
+    quint32 maxMs; /* Longest measurement [ms] */
+    quint64 sumMs; /* Sum of all measurements [ms] */
+    quint32 bins[M8_TTFF_HISTOGRAM_BINS]; /* See M8_TTFF_HISTOGRAM_LIMITS */
+};
+
+/**
+ * @brief Accumulated time-to-first-fix statistics, indexed by M8_START_TYPE
+ */
+struct M8_TTFF_STATS {
+    quint32 starts[M8_START_TYPES]; /* Measurements started */
+    quint32 aborted[M8_START_TYPES]; /* Engine stopped before the first fix */
+    M8_TTFF_HISTOGRAM firstFix[M8_START_TYPES]; /* Start to first valid position */
+    M8_TTFF_HISTOGRAM first3dFix[M8_START_TYPES]; /* Start to first fix with 4+ satellites */
+    M8_TTFF_HISTOGRAM firstTime[M8_START_TYPES]; /* Start to first valid UBX-NAV-TIMEUTC */
+};
+
+/**
+ * @brief A single time-to-first-fix measurement
+ *
+ * Intervals not measured yet are -1.
+ */
+struct M8_TTFF {
+    M8_START_TYPE startType;
+    qint64 firstFixMs; /* [ms] */
+    qint64 first3dFixMs; /* [ms] */
+    qint64 firstTimeMs; /* [ms] */
+};
+
+#endif // M8_TTFF_H
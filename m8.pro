@@ -5,6 +5,7 @@ TEMPLATE = lib
 DEFINES += M8_LIBRARY
 
 QMAKE_CXXFLAGS += -Wall -Wextra
+LIBS += -lrt
 DEFINES += QT_DEPRECATED_WARNINGS
 
 INCLUDEPATH += \
@@ -14,29 +15,78 @@ INCLUDEPATH += \
 HEADERS += \
     include/m8_global.h \
     include/m8.h \
+    include/m8_decoder.h \
+    include/m8_fix.h \
+    include/m8_gnss.h \
+    include/m8_history.h \
+    include/m8_manager.h \
+    include/m8_metrics.h \
+    include/m8_power.h \
+    include/m8_record.h \
+    include/m8_schedule.h \
+    include/m8_server.h \
+    include/m8_shm.h \
+    include/m8_sink.h \
     include/m8_status.h \
-    include/m8_sv_info.h
+    include/m8_sv_info.h \
+    include/m8_time.h \
+    include/m8_track.h \
+    include/m8_ttff.h
 
 # Source
 SOURCES += \
     src/m8.cpp \
+    src/m8decoder.cpp \
+    src/m8history.cpp \
+    src/m8manager.cpp \
+    src/m8server.cpp \
+    src/m8track.cpp \
     src/m8control.cpp \
+    src/ioreactor.cpp \
     src/m8device.cpp \
+    src/metrics.cpp \
     src/nmea.cpp \
+    src/ntpshm.cpp \
     src/ubx.cpp \
     src/assistance.cpp \
     src/config.cpp \
-    src/power.cpp
+    src/framer.cpp \
+    src/kernels.cpp \
+    src/power.cpp \
+    src/powerpolicy.cpp \
+    src/recorder.cpp \
+    src/recordreader.cpp \
+    src/replay.cpp \
+    src/scheduler.cpp \
+    src/shmpublisher.cpp \
+    src/sinks.cpp \
+    src/sink.cpp \
+    src/transport.cpp \
+    src/ttff.cpp
 
 HEADERS += \
     src/m8control.h \
+    src/ioreactor.h \
     src/m8device.h \
+    src/metrics.h \
     src/nmea.h \
+    src/ntpshm.h \
     src/ubx.h \
     src/ubxmessage.h \
     src/assistance.h \
     src/config.h \
-    src/power.h
+    src/framer.h \
+    src/kernels.h \
+    src/power.h \
+    src/recorder.h \
+    src/recordreader.h \
+    src/replay.h \
+    src/scheduler.h \
+    src/shmpublisher.h \
+    src/sinks.h \
+    src/spscqueue.h \
+    src/transport.h \
+    src/ttff.h
 
 
 DESTDIR = $$_PRO_FILE_PWD_/bin/
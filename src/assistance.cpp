@@ -40,10 +40,17 @@ SOFTWARE.
 #define JAN_1_2022 1640995200000LL
 
 Assistance::Assistance(UBX *ubx, Config *cfg, QObject *parent)
-    : QObject(parent), p_cfg(cfg), p_ubx(ubx), m_entryNumber(0)
+    : QObject(parent),
+      p_cfg(cfg),
+      p_ubx(ubx),
+      m_entryNumber(0),
+      m_timeInjected(false),
+      m_uploadedEntries(0)
 {
-    if (cfg->assistLevel() > ASSIST_OFF && QDateTime::currentMSecsSinceEpoch() > JAN_1_2022)
+    if (cfg->assistLevel() > ASSIST_OFF && QDateTime::currentMSecsSinceEpoch() > JAN_1_2022) {
         ubx->injectTimeAssistance();
+        m_timeInjected = true;
+    }
 
     if (ASSIST_AUTONOMOUS == cfg->assistLevel()) {
         ubx->setAutonomousAssist(true);
@@ -61,6 +68,16 @@ void Assistance::saveAutonomousAssistData()
     }
 }
 
+bool Assistance::timeInjected()
+{
+    return m_timeInjected;
+}
+
+int Assistance::uploadedEntries()
+{
+    return m_uploadedEntries;
+}
+
 void Assistance::uploadAutonomousAssistData()
 {
     if (!QDir(p_cfg->offlineDir()).exists())
@@ -73,6 +90,7 @@ void Assistance::uploadAutonomousAssistData()
             QByteArray payload = f.readAll();
             f.close();
             p_ubx->uploadNavigationDatabase(payload);
+            ++m_uploadedEntries;
             ASST_D("Upload " << filename << ":\n\t" << payload);
         }
     }
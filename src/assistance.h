@@ -36,6 +36,8 @@ public:
     explicit Assistance(UBX *ubx, Config *cfg, QObject *parent = nullptr);
 
     void saveAutonomousAssistData();
+    bool timeInjected();
+    int uploadedEntries();
 
 private:
     void uploadAutonomousAssistData();
@@ -47,6 +49,8 @@ private:
     Config *p_cfg;
     UBX *p_ubx;
     int m_entryNumber;
+    bool m_timeInjected;
+    int m_uploadedEntries;
 };
 
 #endif // ASSISTANCE_H
@@ -35,7 +35,18 @@ SOFTWARE.
 #endif
 
 Config::Config(QByteArray configPath, QObject *parent)
-    : QObject(parent), m_assistLevel(ASSIST_BASIC), m_offlineDirectory(""), m_powerSave(false)
+    : QObject(parent),
+      m_assistLevel(ASSIST_BASIC),
+      m_offlineDirectory(""),
+      m_powerSave(false),
+      m_ntpShmUnit(-1),
+      m_ntpShmLatency(0),
+      m_parserThread(false),
+      m_ubxFixes(false),
+      m_shmName(""),
+      m_recordDirectory(""),
+      m_recordFileBytes(64 * 1024 * 1024),
+      m_recordFileMs(60 * 60 * 1000)
 {
     QFile cfg(configPath);
     if (cfg.exists() && cfg.open(QIODevice::ReadOnly)) {
@@ -47,6 +58,22 @@ Config::Config(QByteArray configPath, QObject *parent)
                 m_offlineDirectory = line.mid(11).trimmed();
             } else if (line.startsWith("powersave:")) {
                 m_powerSave = static_cast<bool>(line.remove(0, 10).trimmed().toInt());
+            } else if (line.startsWith("ntpshm:")) {
+                m_ntpShmUnit = line.remove(0, 7).trimmed().toInt();
+            } else if (line.startsWith("ntpshmlatency:")) {
+                m_ntpShmLatency = line.remove(0, 14).trimmed().toLongLong() * 1000;
+            } else if (line.startsWith("parserthread:")) {
+                m_parserThread = static_cast<bool>(line.remove(0, 13).trimmed().toInt());
+            } else if (line.startsWith("fixsource:")) {
+                m_ubxFixes = (line.mid(10).trimmed() == "ubx");
+            } else if (line.startsWith("shm:")) {
+                m_shmName = line.mid(4).trimmed();
+            } else if (line.startsWith("record:")) {
+                m_recordDirectory = line.mid(7).trimmed();
+            } else if (line.startsWith("recordsize:")) {
+                m_recordFileBytes = line.remove(0, 11).trimmed().toLongLong() * 1024 * 1024;
+            } else if (line.startsWith("recordtime:")) {
+                m_recordFileMs = line.remove(0, 11).trimmed().toLongLong() * 60 * 1000;
             }
             line = cfg.readLine();
         }
@@ -75,6 +102,12 @@ Config::Config(QByteArray configPath, QObject *parent)
     CFG_D("Assist level:" << levels.at(m_assistLevel));
     CFG_D("Offline dir:" << m_offlineDirectory);
     CFG_D("Power Save:" << m_powerSave);
+    CFG_D("NTP SHM unit:" << m_ntpShmUnit << "latency:" << m_ntpShmLatency);
+    CFG_D("Parser thread:" << m_parserThread);
+    CFG_D("UBX fixes:" << m_ubxFixes);
+    CFG_D("Shared memory:" << m_shmName);
+    CFG_D("Record directory:" << m_recordDirectory);
+    CFG_D("Record file size:" << m_recordFileBytes << "time:" << m_recordFileMs);
 #endif
 }
 
@@ -92,3 +125,72 @@ bool Config::powerSave()
 {
     return m_powerSave;
 }
+
+/**
+ * @brief Config::ntpShmUnit
+ * @return NTP shared memory refclock unit to feed, or -1 if disabled
+ */
+int Config::ntpShmUnit()
+{
+    return m_ntpShmUnit;
+}
+
+/**
+ * @brief Config::ntpShmLatency
+ * @return Output latency of NAV-TIMEUTC removed from the refclock samples,
+ * "ntpshmlatency:" in microseconds [ns]
+ */
+qint64 Config::ntpShmLatency()
+{
+    return m_ntpShmLatency;
+}
+
+bool Config::parserThread()
+{
+    return m_parserThread;
+}
+
+/**
+ * @brief Config::ubxFixes
+ * @return true for fixes from UBX-NAV-PVT, "fixsource:ubx", instead of GGA
+ */
+bool Config::ubxFixes()
+{
+    return m_ubxFixes;
+}
+
+/**
+ * @brief Config::shmName
+ * @return POSIX shared memory object to publish the receiver state in, or empty if disabled
+ */
+QByteArray Config::shmName()
+{
+    return m_shmName;
+}
+
+/**
+ * @brief Config::recordDirectory
+ * @return Directory to record the raw receiver stream in, or empty if disabled
+ */
+QString Config::recordDirectory()
+{
+    return m_recordDirectory;
+}
+
+/**
+ * @brief Config::recordFileBytes
+ * @return Size that starts a new recording file, "recordsize:" in MiB, 0 for no limit
+ */
+qint64 Config::recordFileBytes()
+{
+    return m_recordFileBytes;
+}
+
+/**
+ * @brief Config::recordFileMs
+ * @return Age that starts a new recording file, "recordtime:" in minutes, 0 for no limit
+ */
+qint64 Config::recordFileMs()
+{
+    return m_recordFileMs;
+}
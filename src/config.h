@@ -43,11 +43,27 @@ public:
     ASSIST_LEVEL assistLevel();
     QString offlineDir();
     bool powerSave();
+    int ntpShmUnit();
+    qint64 ntpShmLatency();
+    bool parserThread();
+    bool ubxFixes();
+    QByteArray shmName();
+    QString recordDirectory();
+    qint64 recordFileBytes();
+    qint64 recordFileMs();
 
 private:
     ASSIST_LEVEL m_assistLevel;
     QString m_offlineDirectory;
     bool m_powerSave;
+    int m_ntpShmUnit;
+    qint64 m_ntpShmLatency;
+    bool m_parserThread;
+    bool m_ubxFixes;
+    QByteArray m_shmName;
+    QString m_recordDirectory;
+    qint64 m_recordFileBytes;
+    qint64 m_recordFileMs;
 };
 
 #endif // CONFIG_H
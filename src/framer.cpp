@@ -0,0 +1,333 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "framer.h"
+#include "kernels.h"
+#include "metrics.h"
+#include "nmea.h"
+#include "ubx.h"
+
+//#define FRAMER_DEBUG
+#ifdef FRAMER_DEBUG
+#include <QDebug>
+#define FRAMER_D(x) qDebug() << "[Framer] " << x
+#else
+#define FRAMER_D(x)
+#endif
+
+/**
+ * @brief Framer::Framer
+ * @param metrics Counters of checksum errors and resyncs, or nullptr to count nothing
+ */
+Framer::Framer(Metrics *metrics)
+    : p_metrics(metrics), m_consumed(0), m_frameOffset(0), m_rejectedEnd(0), m_inSync(true)
+{
+}
+
+void Framer::append(const QByteArray &data)
+{
+    m_input.append(data);
+}
+
+/**
+ * @brief Framer::next
+ * @param frame NMEA sentence without the line feed, or UBX frame without sync chars and
+ * including the checksum
+ * @return FRAME_NONE when more data is needed
+ *
+ * Checksum errors are only counted for the first frame that fails after the stream was in sync,
+ * not for the sync chars found inside the bytes that are rescanned after it.
+ */
+Framer::Frame Framer::next(QByteArray &frame)
+{
+    while (!m_input.isEmpty()) {
+        if (m_input.startsWith('$')) {
+            int nmeaEnd = m_input.indexOf('\n');
+            if (nmeaEnd < 0 || nmeaEnd >= MAX_NMEA_LENGTH) {
+                if (nmeaEnd < 0 && m_input.size() < MAX_NMEA_LENGTH) {
+                    FRAMER_D("Incomplete nmea string. Wait for more data. " << m_input);
+                    return FRAME_NONE;
+                }
+                FRAMER_D("Unterminated nmea string");
+                reject(MAX_NMEA_LENGTH);
+                continue;
+            }
+            frame = m_input.left(nmeaEnd);
+            if (!NMEA::crcCheck(frame)) {
+                FRAMER_D("NMEA checksum error: " << frame);
+                if (m_inSync && p_metrics)
+                    p_metrics->nmeaChecksumErrors.add();
+                reject(nmeaEnd + 1);
+                continue;
+            }
+            consume(nmeaEnd + 1);
+            return FRAME_NMEA;
+        } else if (m_input.startsWith(static_cast<char>(0xB5))) {
+            if (m_input.count() < 8) {
+                FRAMER_D("Incomplete ubx message. Wait for more data.");
+                return FRAME_NONE;
+            }
+            if (0x62 != m_input.at(1)) {
+                FRAMER_D("Incorrect sync char for ubx message: " << m_input.at(1));
+                discard(1);
+                continue;
+            }
+            int payloadLen = (m_input.at(4) & 0xFF) | ((m_input.at(5) & 0xFF) << 8);
+            if (payloadLen > maxUbxPayload(static_cast<quint8>(m_input.at(2)),
+                                           static_cast<quint8>(m_input.at(3)))) {
+                FRAMER_D("Impossible ubx payload length: " << payloadLen);
+                reject(8);
+                continue;
+            }
+            if (m_input.size() < (payloadLen + 8)) {
+                FRAMER_D("Incomplete ubx message. Wait for more data.");
+                return FRAME_NONE;
+            }
+            frame = m_input.mid(2, payloadLen + 6);
+            if (!UBX::crcCheck(frame)) {
+                FRAMER_D("UBX checksum error");
+                if (m_inSync && p_metrics)
+                    p_metrics->ubxChecksumErrors.add();
+                reject(payloadLen + 8);
+                continue;
+            }
+            consume(payloadLen + 8);
+            return FRAME_UBX;
+        } else {
+            // Everything up to the next byte that can start a frame goes at once
+            discard(Kernels::findFrameStart(m_input.constData(), m_input.size()));
+        }
+    }
+    return FRAME_NONE;
+}
+
+/**
+ * @brief Framer::maxUbxPayload
+ * @param messageClass
+ * @param id
+ * @return Largest payload the M8 sends in the message, -1 if it sends no message of the class
+ *
+ * From the payload sizes of the protocol specification. Messages with repeated blocks have room
+ * for the largest count their count field can hold, and messages of a known class that are not
+ * listed get the limit of the class. A corrupted length is thereby found at once rather than
+ * after waiting for up to MAX_UBX_PAYLOAD bytes.
+ */
+int Framer::maxUbxPayload(quint8 messageClass, quint8 id)
+{
+    switch (messageClass) {
+    case 0x01: /* NAV */
+        switch (id) {
+        case 0x01: /* POSECEF */
+        case 0x09: /* ODO */
+        case 0x11: /* VELECEF */
+        case 0x21: /* TIMEUTC */
+        case 0x22: /* CLOCK */
+        case 0x23: /* TIMEGLO */
+        case 0x24: /* TIMEBDS */
+        case 0x25: /* TIMEGAL */
+            return 20;
+        case 0x02: /* POSLLH */
+        case 0x13: /* HPPOSECEF */
+            return 28;
+        case 0x03: /* STATUS */
+        case 0x20: /* TIMEGPS */
+        case 0x60: /* AOPSTATUS */
+            return 16;
+        case 0x04: /* DOP */
+            return 18;
+        case 0x05: /* ATT */
+            return 32;
+        case 0x06: /* SOL */
+            return 52;
+        case 0x07: /* PVT */
+            return 92;
+        case 0x10: /* RESETODO */
+            return 0;
+        case 0x12: /* VELNED */
+        case 0x14: /* HPPOSLLH */
+            return 36;
+        case 0x26: /* TIMELS */
+            return 24;
+        case 0x30: /* SVINFO */
+        case 0x35: /* SAT */
+            return 8 + 12 * 255;
+        case 0x32: /* SBAS */
+            return 12 + 12 * 255;
+        case 0x34: /* ORB */
+            return 8 + 6 * 255;
+        case 0x39: /* GEOFENCE */
+            return 8 + 2 * 255;
+        case 0x3B: /* SVIN */
+            return 40;
+        case 0x3C: /* RELPOSNED */
+            return 64;
+        case 0x42: /* SLAS */
+            return 20 + 8 * 255;
+        case 0x61: /* EOE */
+            return 4;
+        default: /* DGPS is the largest */
+            return 16 + 12 * 255;
+        }
+    case 0x02: /* RXM */
+        switch (id) {
+        case 0x13: /* SFRBX */
+            return 8 + 4 * 255;
+        case 0x14: /* MEASX */
+            return 44 + 24 * 255;
+        case 0x15: /* RAWX */
+            return 16 + 32 * 255;
+        case 0x41: /* PMREQ */
+            return 16;
+        case 0x59: /* RLM */
+            return 32;
+        default:
+            return MAX_UBX_PAYLOAD;
+        }
+    case 0x04: /* INF, text of no fixed length */
+        return 512;
+    case 0x05: /* ACK */
+        return 2;
+    case 0x06: /* CFG, in replies to polls */
+        return 4 + 8 * 255; /* GNSS is the largest */
+    case 0x09: /* UPD */
+        return 8;
+    case 0x0A: /* MON */
+        switch (id) {
+        case 0x07: /* RXBUF */
+            return 24;
+        case 0x08: /* TXBUF */
+        case 0x0B: /* HW2 */
+            return 28;
+        case 0x09: /* HW */
+            return 60;
+        case 0x21: /* RXR */
+            return 1;
+        case 0x28: /* GNSS */
+            return 8;
+        default: /* VER with its extensions, IO, PATCH and SPAN */
+            return 1024;
+        }
+    case 0x0B: /* AID */
+        return 256;
+    case 0x0D: /* TIM */
+        switch (id) {
+        case 0x01: /* TP */
+            return 16;
+        case 0x03: /* TM2 */
+        case 0x04: /* SVIN */
+            return 28;
+        case 0x06: /* VRFY */
+            return 20;
+        case 0x12: /* TOS */
+            return 56;
+        case 0x16: /* FCHG */
+            return 32;
+        default: /* SMEAS is the largest */
+            return 12 + 24 * 255;
+        }
+    case 0x10: /* ESF */
+        switch (id) {
+        case 0x02: /* MEAS */
+            return 8 + 4 * 31 + 4;
+        case 0x10: /* STATUS */
+            return 16 + 4 * 255;
+        case 0x14: /* ALG */
+            return 16;
+        case 0x15: /* INS */
+            return 36;
+        default: /* RAW */
+            return 4 + 8 * 255;
+        }
+    case 0x13: /* MGA */
+        return 512;
+    case 0x21: /* LOG */
+        return 16 + 256; /* RETRIEVESTRING is the largest */
+    case 0x27: /* SEC */
+        return 40;
+    case 0x28: /* HNR */
+        return 72;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Framer::frameOffset
+ * @return Offset in the stream of the first byte of the frame last returned by next()
+ */
+qint64 Framer::frameOffset() const
+{
+    return m_frameOffset;
+}
+
+/**
+ * @brief Framer::buffered
+ * @return Bytes held back for a frame that is not complete yet
+ */
+int Framer::buffered() const
+{
+    return m_input.size();
+}
+
+void Framer::clear()
+{
+    m_consumed += m_input.size();
+    m_input.clear();
+    m_inSync = true;
+}
+
+/**
+ * @brief Framer::reject
+ * @param length Bytes the rejected frame claimed
+ *
+ * Only the sync char is dropped. Frames found in the rest of the claimed length are counted as
+ * recovered.
+ */
+void Framer::reject(int length)
+{
+    m_rejectedEnd = qMax(m_rejectedEnd, m_consumed + length);
+    discard(1);
+}
+
+void Framer::discard(int bytes)
+{
+    if (m_inSync) {
+        m_inSync = false;
+        if (p_metrics)
+            p_metrics->resyncs.add();
+    }
+    if (p_metrics)
+        p_metrics->bytesDiscarded.add(static_cast<quint64>(bytes));
+    m_input.remove(0, bytes);
+    m_consumed += bytes;
+}
+
+void Framer::consume(int bytes)
+{
+    if (m_consumed < m_rejectedEnd && p_metrics)
+        p_metrics->framesRecovered.add();
+    m_frameOffset = m_consumed;
+    m_input.remove(0, bytes);
+    m_consumed += bytes;
+    m_inSync = true;
+}
@@ -0,0 +1,71 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <QByteArray>
+
+#define MAX_NMEA_LENGTH 128 /* NMEA allows 82, with room for proprietary sentences */
+#define MAX_UBX_PAYLOAD 8192 /* Larger than any message the M8 sends, see maxUbxPayload() */
+
+class Metrics;
+
+/**
+ * @brief Splits the receiver byte stream into NMEA sentences and UBX frames with valid checksums
+ *
+ * Bytes that can not start a frame are discarded up to the next '$' or UBX sync char. A frame
+ * that fails its checksum, claims more payload than its class and id allow or has no line feed
+ * within MAX_NMEA_LENGTH only gives up its first byte, so frames hidden behind a corrupted header
+ * are found by the rescan.
+ */
+class Framer
+{
+public:
+    enum Frame { FRAME_NONE = 0, FRAME_NMEA, FRAME_UBX };
+
+    explicit Framer(Metrics *metrics);
+
+    static int maxUbxPayload(quint8 messageClass, quint8 id);
+
+    void append(const QByteArray &data);
+    Frame next(QByteArray &frame);
+    qint64 frameOffset() const;
+    int buffered() const;
+    void clear();
+
+private:
+    void reject(int length);
+    void discard(int bytes);
+    void consume(int bytes);
+
+private:
+    Metrics *p_metrics;
+    QByteArray m_input;
+    qint64 m_consumed;
+    qint64 m_frameOffset;
+    qint64 m_rejectedEnd;
+    bool m_inSync;
+};
+
+#endif // FRAMER_H
@@ -0,0 +1,240 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "ioreactor.h"
+#include "m8device.h"
+#include <errno.h>
+#include <qplatformdefs.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+//#define IOREACTOR_DEBUG
+#ifdef IOREACTOR_DEBUG
+#include <QDebug>
+#define IOR_D(x) qDebug() << "[IoReactor] " << x
+#else
+#define IOR_D(x)
+#endif
+
+#define MAX_EVENTS 32
+#define STALL_RETRY_MS 1
+
+// Each device registers two descriptors. The low bit of the key tells which one signalled.
+#define KEY_TX 1
+#define KEY_WAKE 0
+
+IoReactor::IoReactor(QObject *parent)
+    : QThread(parent), m_nextId(1), m_stalled(0)
+{
+    setObjectName("m8 io");
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0) {
+        qWarning("[IoReactor] Could not create epoll instance");
+    } else {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = KEY_WAKE;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+    }
+}
+
+IoReactor::~IoReactor()
+{
+    stop();
+    if (m_wakeFd >= 0)
+        QT_CLOSE(m_wakeFd);
+    if (m_epollFd >= 0)
+        QT_CLOSE(m_epollFd);
+}
+
+/**
+ * @brief IoReactor::add
+ * @param device Open device. It must be removed before it is deleted.
+ * @return false if the descriptors could not be watched
+ */
+bool IoReactor::add(M8Device *device)
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 key = m_nextId++ << 1;
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = key;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, device->fd(), &event) != 0)
+        return false;
+
+    event.data.u64 = key | KEY_TX;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, device->transmitEventFd(), &event) != 0) {
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, device->fd(), nullptr);
+        return false;
+    }
+
+    m_entries.insert(key, Entry { device, false, false });
+    IOR_D("Added device" << device->fd() << "as" << key);
+    return true;
+}
+
+/**
+ * @brief IoReactor::remove
+ * @param device
+ *
+ * The device is not touched by the I/O thread once this returns.
+ */
+void IoReactor::remove(M8Device *device)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->device == device) {
+            epoll_ctl(m_epollFd, EPOLL_CTL_DEL, device->fd(), nullptr);
+            epoll_ctl(m_epollFd, EPOLL_CTL_DEL, device->transmitEventFd(), nullptr);
+            if (it->stalled)
+                m_stalled--;
+            m_entries.erase(it);
+            return;
+        }
+    }
+}
+
+void IoReactor::stop()
+{
+    if (!isRunning())
+        return;
+
+    requestInterruption();
+    quint64 one = 1;
+    if (QT_WRITE(m_wakeFd, &one, sizeof(one)) != sizeof(one))
+        qWarning("[IoReactor] Could not wake the I/O thread");
+    wait();
+}
+
+void IoReactor::run()
+{
+    struct epoll_event events[MAX_EVENTS];
+    int timeout = -1;
+    while (!isInterruptionRequested()) {
+        int count = epoll_wait(m_epollFd, events, MAX_EVENTS, timeout);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            qWarning("[IoReactor] epoll_wait failed");
+            break;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        // Devices stalled in the previous round were not watched during this wait
+        if (m_stalled > 0)
+            resumeStalled();
+        if (count > 0)
+            wakeups.add();
+        for (int i = 0; i < count; ++i)
+            dispatch(events[i].data.u64, events[i].events);
+        timeout = (m_stalled > 0) ? STALL_RETRY_MS : -1;
+        cpuNs.set(static_cast<quint64>(Metrics::threadCpuTime()));
+    }
+}
+
+/**
+ * @brief IoReactor::dispatch
+ * @param key
+ * @param events
+ *
+ * Called with the mutex held. Events of removed devices are dropped here.
+ */
+void IoReactor::dispatch(quint64 key, quint32 events)
+{
+    if (KEY_WAKE == key) {
+        quint64 count;
+        ssize_t bytesRead = QT_READ(m_wakeFd, &count, sizeof(count));
+        Q_UNUSED(bytesRead)
+        return;
+    }
+
+    auto it = m_entries.find(key & ~static_cast<quint64>(KEY_TX));
+    if (it == m_entries.end())
+        return;
+
+    if (key & KEY_TX) {
+        writeDevice(it.key(), *it);
+        return;
+    }
+
+    if (events & EPOLLOUT)
+        writeDevice(it.key(), *it);
+    if ((events & EPOLLIN) && !it->device->readAvailable()) {
+        // The receive ring is full. Stop watching until the parser has caught up.
+        it->stalled = true;
+        m_stalled++;
+        watch(it.key(), *it);
+    } else if ((events & (EPOLLHUP | EPOLLERR)) || it->device->atEnd()) {
+        // Level triggered, so a hung up device would otherwise be reported on every wait
+        qWarning("[IoReactor] Device %d hung up", it->device->fd());
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it->device->fd(), nullptr);
+    }
+}
+
+/**
+ * @brief IoReactor::writeDevice
+ * @param key
+ * @param entry
+ *
+ * Writes what the device has queued and watches for writability while some of it is left.
+ */
+void IoReactor::writeDevice(quint64 key, Entry &entry)
+{
+    entry.device->writeQueued();
+    bool writing = entry.device->writePending();
+    if (writing != entry.writing) {
+        entry.writing = writing;
+        watch(key, entry);
+    }
+}
+
+/**
+ * @brief IoReactor::watch
+ * @param key
+ * @param entry
+ *
+ * Sets the events of the device descriptor from the state of the entry.
+ */
+void IoReactor::watch(quint64 key, const Entry &entry)
+{
+    struct epoll_event event = {};
+    if (!entry.stalled)
+        event.events |= EPOLLIN;
+    if (entry.writing)
+        event.events |= EPOLLOUT;
+    event.data.u64 = key;
+    epoll_ctl(m_epollFd, EPOLL_CTL_MOD, entry.device->fd(), &event);
+}
+
+void IoReactor::resumeStalled()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->stalled) {
+            it->stalled = false;
+            m_stalled--;
+            watch(it.key(), *it);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef IOREACTOR_H
+#define IOREACTOR_H
+
+#include "metrics.h"
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+
+class M8Device;
+
+/**
+ * @brief One epoll thread reading and writing any number of devices
+ *
+ * Replaces the thread and event loop each M8Device otherwise runs on. Received data goes into the
+ * receive ring of the device exactly as with a thread per device, and queued messages are written
+ * when the transmit ring signals. A device that can not take a write right away is watched for
+ * writability until it has taken all of it, so no device blocks the thread.
+ */
+class IoReactor : public QThread
+{
+    Q_OBJECT
+public:
+    explicit IoReactor(QObject *parent = nullptr);
+    ~IoReactor();
+
+    bool add(M8Device *device);
+    void remove(M8Device *device);
+    void stop();
+
+    MetricsCounter wakeups; /* Returns from epoll_wait with events */
+    MetricsCounter cpuNs; /* CPU time used by the I/O thread [ns] */
+
+protected:
+    void run() override;
+
+private:
+    struct Entry {
+        M8Device *device;
+        bool stalled;
+        bool writing;
+    };
+
+    void dispatch(quint64 key, quint32 events);
+    void writeDevice(quint64 key, Entry &entry);
+    void watch(quint64 key, const Entry &entry);
+    void resumeStalled();
+
+private:
+    int m_epollFd;
+    int m_wakeFd;
+    QMutex m_mutex;
+    QHash<quint64, Entry> m_entries;
+    quint64 m_nextId;
+    int m_stalled;
+};
+
+#endif // IOREACTOR_H
@@ -0,0 +1,269 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "kernels.h"
+#include <atomic>
+#include <string.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define UBX_SYNC_1 static_cast<char>(0xB5)
+
+/*
+ * Every version returns the index of the first '$' or first UBX sync char, or size if there is
+ * none. The framer checks the second sync char itself.
+ */
+
+static int findFrameStartScalar(const char *data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if ('$' == data[i] || UBX_SYNC_1 == data[i])
+            return i;
+    }
+    return size;
+}
+
+#if defined(__SSE2__)
+static int findFrameStartSse2(const char *data, int size)
+{
+    const __m128i dollar = _mm_set1_epi8('$');
+    const __m128i sync = _mm_set1_epi8(UBX_SYNC_1);
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        int mask = _mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(v, dollar), _mm_cmpeq_epi8(v, sync)));
+        if (mask)
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return i + findFrameStartScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) static int findFrameStartAvx2(const char *data, int size)
+{
+    const __m256i dollar = _mm256_set1_epi8('$');
+    const __m256i sync = _mm256_set1_epi8(UBX_SYNC_1);
+    int i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        int mask = _mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, dollar), _mm256_cmpeq_epi8(v, sync)));
+        if (mask)
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return i + findFrameStartSse2(data + i, size - i);
+}
+#endif
+
+#if defined(__ARM_NEON)
+static int findFrameStartNeon(const char *data, int size)
+{
+    const uint8x16_t dollar = vdupq_n_u8('$');
+    const uint8x16_t sync = vdupq_n_u8(0xB5);
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+        uint8x16_t match = vorrq_u8(vceqq_u8(v, dollar), vceqq_u8(v, sync));
+        // Narrow to four bits per byte, as NEON has no movemask
+        uint64_t bits = vget_lane_u64(
+                vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+        if (bits)
+            return i + (__builtin_ctzll(bits) >> 2);
+    }
+    return i + findFrameStartScalar(data + i, size - i);
+}
+#endif
+
+typedef int (*FindFrameStart)(const char *data, int size);
+
+static FindFrameStart findFrameStartFunction(Kernels::Isa isa)
+{
+    switch (isa) {
+#if defined(__SSE2__)
+    case Kernels::ISA_SSE2:
+        return findFrameStartSse2;
+    case Kernels::ISA_AVX2:
+        return __builtin_cpu_supports("avx2") ? findFrameStartAvx2 : nullptr;
+#endif
+#if defined(__ARM_NEON)
+    case Kernels::ISA_NEON:
+        return findFrameStartNeon;
+#endif
+    case Kernels::ISA_SCALAR:
+        return findFrameStartScalar;
+    default:
+        return nullptr;
+    }
+}
+
+static Kernels::Isa bestIsa()
+{
+#if defined(__SSE2__)
+    // May run from a static initializer, before the one that fills in the CPU features
+    __builtin_cpu_init();
+#endif
+    for (int isa = Kernels::ISA_COUNT - 1; isa > Kernels::ISA_SCALAR; --isa) {
+        if (findFrameStartFunction(static_cast<Kernels::Isa>(isa)))
+            return static_cast<Kernels::Isa>(isa);
+    }
+    return Kernels::ISA_SCALAR;
+}
+
+static int findFrameStartFirst(const char *data, int size);
+
+/*
+ * Constant initialized, so they are valid before any dynamic initializer runs, also one in
+ * another file that parses. The version is picked on first use.
+ */
+static std::atomic<FindFrameStart> findFrameStartCurrent(findFrameStartFirst);
+static std::atomic<Kernels::Isa> currentIsa(Kernels::ISA_COUNT);
+
+static void resolveIsa()
+{
+    if (Kernels::ISA_COUNT == currentIsa.load(std::memory_order_acquire))
+        Kernels::setIsa(bestIsa());
+}
+
+static int findFrameStartFirst(const char *data, int size)
+{
+    resolveIsa();
+    return findFrameStartCurrent.load(std::memory_order_relaxed)(data, size);
+}
+
+bool Kernels::supported(Isa isa)
+{
+    return findFrameStartFunction(isa) != nullptr;
+}
+
+const char *Kernels::name(Isa isa)
+{
+    static const char *names[ISA_COUNT] = { "scalar", "sse2", "avx2", "neon" };
+    return (isa >= 0 && isa < ISA_COUNT) ? names[isa] : "unknown";
+}
+
+Kernels::Isa Kernels::isa()
+{
+    resolveIsa();
+    return currentIsa.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Kernels::setIsa
+ * @param isa
+ * @return false if the CPU or the build does not support it
+ *
+ * Not thread safe. Call it before any parsing starts.
+ */
+bool Kernels::setIsa(Isa isa)
+{
+    FindFrameStart function = findFrameStartFunction(isa);
+    if (!function)
+        return false;
+    findFrameStartCurrent.store(function, std::memory_order_relaxed);
+    currentIsa.store(isa, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Kernels::findFrameStart
+ * @param data
+ * @param size
+ * @return Index of the first byte that may start an NMEA sentence or UBX frame, size if none
+ */
+int Kernels::findFrameStart(const char *data, int size)
+{
+    return findFrameStartCurrent.load(std::memory_order_relaxed)(data, size);
+}
+
+/**
+ * @brief Kernels::nmeaChecksum
+ * @param data Sentence between '$' and '*'
+ * @param size
+ * @return XOR of all bytes, eight at a time
+ */
+quint8 Kernels::nmeaChecksum(const char *data, int size)
+{
+    quint64 word = 0;
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 next;
+        memcpy(&next, data + i, sizeof(next));
+        word ^= next;
+    }
+    word ^= word >> 32;
+    word ^= word >> 16;
+    word ^= word >> 8;
+    quint8 checksum = static_cast<quint8>(word);
+    for (; i < size; ++i)
+        checksum ^= static_cast<quint8>(data[i]);
+    return checksum;
+}
+
+quint8 Kernels::nmeaChecksumScalar(const char *data, int size)
+{
+    quint8 checksum = 0;
+    for (int i = 0; i < size; ++i)
+        checksum ^= static_cast<quint8>(data[i]);
+    return checksum;
+}
+
+/**
+ * @brief Kernels::ubxChecksum
+ * @param data Class, id, length and payload
+ * @param size
+ * @return CK_A in the low byte and CK_B in the high byte
+ *
+ * Fletcher-8 four bytes per step: after x0..x3, B has grown by 4A + 4x0 + 3x1 + 2x2 + x3. The
+ * sums are only needed modulo 256, so they are left to wrap and truncated at the end.
+ */
+quint16 Kernels::ubxChecksum(const char *data, int size)
+{
+    const quint8 *bytes = reinterpret_cast<const quint8 *>(data);
+    quint32 a = 0;
+    quint32 b = 0;
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        b += 4 * a + 4 * bytes[i] + 3 * bytes[i + 1] + 2 * bytes[i + 2] + bytes[i + 3];
+        a += bytes[i] + bytes[i + 1] + bytes[i + 2] + bytes[i + 3];
+    }
+    for (; i < size; ++i) {
+        a += bytes[i];
+        b += a;
+    }
+    return static_cast<quint16>((a & 0xFF) | ((b & 0xFF) << 8));
+}
+
+quint16 Kernels::ubxChecksumScalar(const char *data, int size)
+{
+    quint8 a = 0;
+    quint8 b = 0;
+    for (int i = 0; i < size; ++i) {
+        a += static_cast<quint8>(data[i]);
+        b += a;
+    }
+    return static_cast<quint16>(a | (b << 8));
+}
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Byte scanning and checksum loops of the parser hot path
+ *
+ * findFrameStart() has SSE2, AVX2 and NEON versions next to the scalar one. The best one the CPU
+ * supports is picked on first use. setIsa() picks another, for benchmarks and for comparing them.
+ */
+class Kernels
+{
+public:
+    enum Isa { ISA_SCALAR = 0, ISA_SSE2, ISA_AVX2, ISA_NEON, ISA_COUNT };
+
+    static bool supported(Isa isa);
+    static const char *name(Isa isa);
+    static Isa isa();
+    static bool setIsa(Isa isa);
+
+    static int findFrameStart(const char *data, int size);
+    static quint8 nmeaChecksum(const char *data, int size);
+    static quint8 nmeaChecksumScalar(const char *data, int size);
+    static quint16 ubxChecksum(const char *data, int size);
+    static quint16 ubxChecksumScalar(const char *data, int size);
+};
+
+#endif // KERNELS_H
@@ -22,49 +22,338 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "m8.h"
+#include "config.h"
 #include "m8control.h"
+#include "metrics.h"
+#include <QThread>
 
-M8::M8(QString device, QObject *parent) : QObject(parent)
+M8::M8(QString device, QObject *parent)
+    : QObject(parent),
+      m_controlThread(nullptr),
+      m_ownsControlThread(false),
+      m_positionTimestamp(0)
 {
-    init(device, "/etc/m8.conf");
+    init(device, "/etc/m8.conf", nullptr, nullptr);
 }
 
-M8::M8(QString device, QByteArray configPath, QObject *parent) : QObject(parent)
+M8::M8(QString device, QByteArray configPath, QObject *parent)
+    : QObject(parent),
+      m_controlThread(nullptr),
+      m_ownsControlThread(false),
+      m_positionTimestamp(0)
 {
-    init(device, configPath);
+    init(device, configPath, nullptr, nullptr);
+}
+
+/**
+ * @brief M8::M8
+ *
+ * Receiver served by the shared I/O thread and parser worker of an M8Manager.
+ */
+M8::M8(QString device, QByteArray configPath, IoReactor *reactor, QThread *worker,
+       QObject *parent)
+    : QObject(parent),
+      m_controlThread(nullptr),
+      m_ownsControlThread(false),
+      m_positionTimestamp(0)
+{
+    init(device, configPath, reactor, worker);
+}
+
+M8::~M8()
+{
+    if (m_controlThread && m_ownsControlThread) {
+        // Deferred deletion is done by the parser thread as it finishes
+        m_control->deleteLater();
+        m_controlThread->quit();
+        m_controlThread->wait();
+        delete m_controlThread;
+    } else if (m_controlThread) {
+        // The worker is shared and keeps running
+        QMetaObject::invokeMethod(m_control, [=] { delete m_control; }, blocking());
+    }
 }
 
 void M8::setPower(bool on)
 {
-    m_control->setPower(on);
+    QMetaObject::invokeMethod(m_control, [=] { m_control->setPower(on); });
+}
+
+/**
+ * @brief M8::setPowerPolicy
+ * @param policy Policy deciding the power mode, not owned. nullptr disables power management.
+ */
+void M8::setPowerPolicy(M8PowerPolicy *policy)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->setPowerPolicy(policy); });
+}
+
+/**
+ * @brief M8::setRequestedUpdatePeriod
+ * @param periodMs Position update period the application needs, input to the power policy
+ */
+void M8::setRequestedUpdatePeriod(quint32 periodMs)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->setRequestedUpdatePeriod(periodMs); });
+}
+
+/**
+ * @brief M8::setPowerDwellTime
+ * @param dwellMs Minimum time between power mode changes
+ */
+void M8::setPowerDwellTime(int dwellMs)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->setPowerDwellTime(dwellMs); });
+}
+
+M8_POWER_STATS M8::powerStatistics()
+{
+    M8_POWER_STATS stats;
+    QMetaObject::invokeMethod(
+            m_control, [&] { stats = m_control->powerStatistics(); }, blocking());
+    return stats;
+}
+
+/**
+ * @brief M8::setFixSchedule
+ * @param schedule
+ *
+ * Duty-cycles the GNSS engine to deliver one fix per interval. setPower() is ignored until
+ * clearFixSchedule() is called.
+ */
+void M8::setFixSchedule(const M8_FIX_SCHEDULE &schedule)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->setFixSchedule(schedule); });
+}
+
+void M8::clearFixSchedule()
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->clearFixSchedule(); });
+}
+
+M8_SCHEDULE_STATS M8::scheduleStatistics()
+{
+    M8_SCHEDULE_STATS stats;
+    QMetaObject::invokeMethod(
+            m_control, [&] { stats = m_control->scheduleStatistics(); }, blocking());
+    return stats;
+}
+
+/**
+ * @brief M8::gnssConfig
+ * @return Cached GNSS configuration, not valid before requestGnssConfig() has been answered
+ */
+M8_GNSS_CONFIG M8::gnssConfig()
+{
+    M8_GNSS_CONFIG config;
+    QMetaObject::invokeMethod(m_control, [&] { config = m_control->gnssConfig(); }, blocking());
+    return config;
+}
+
+/**
+ * @brief M8::requestGnssConfig
+ *
+ * Emits gnssConfigChange, reading the configuration from the receiver only if not cached.
+ */
+void M8::requestGnssConfig()
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->requestGnssConfig(); });
+}
+
+/**
+ * @brief M8::setGnssConfig
+ * @param config Systems and tracking channel reservations
+ * @return False if the channel budget is invalid or no major system is enabled
+ *
+ * Restarts the GNSS engine to apply the configuration. gnssConfigChange is emitted once the
+ * receiver has accepted it.
+ */
+bool M8::setGnssConfig(const M8_GNSS_CONFIG &config)
+{
+    bool ok = false;
+    QMetaObject::invokeMethod(
+            m_control, [&] { ok = m_control->setGnssConfig(config); }, blocking());
+    return ok;
+}
+
+/**
+ * @brief M8::setGnssSystems
+ * @param mask Systems to enable, M8_GNSS_MASK() bits
+ * @return False if no major system is enabled or the channel budget is invalid
+ *
+ * Keeps the current channel reservations and restarts the GNSS engine. gnssConfigChange is
+ * emitted once the receiver has accepted the configuration.
+ */
+bool M8::setGnssSystems(quint32 mask)
+{
+    bool ok = false;
+    QMetaObject::invokeMethod(
+            m_control, [&] { ok = m_control->setGnssSystems(mask); }, blocking());
+    return ok;
 }
 
 void M8::saveAutonomousAssistData()
 {
-    m_control->saveAutonomousAssistData();
+    QMetaObject::invokeMethod(m_control, [=] { m_control->saveAutonomousAssistData(); });
 }
 
 M8_STATUS M8::status()
 {
-    return m_control->status();
+    M8_STATUS status = M8_STATUS_ERROR_DRIVER;
+    QMetaObject::invokeMethod(m_control, [&] { status = m_control->status(); }, blocking());
+    return status;
 }
 
 void M8::requestTime()
 {
-    m_control->requestTime();
+    QMetaObject::invokeMethod(m_control, [=] { m_control->requestTime(); });
 }
 
 void M8::requestSatelliteInfo()
 {
-    m_control->requestSatelliteInfo();
+    QMetaObject::invokeMethod(m_control, [=] { m_control->requestSatelliteInfo(); });
+}
+
+/**
+ * @brief M8::sendUbxMessage
+ * @param message Class, id, length and payload. Sync characters and checksum are added.
+ *
+ * The message goes through the send queue of the library, after the messages already queued.
+ * Writes of UBX-CFG-GNSS and UBX-CFG-PM2 are refused, use setGnssConfig() and the power policy.
+ */
+void M8::sendUbxMessage(const QByteArray &message)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->sendUbxMessage(message); });
 }
 
-void M8::init(QString device, QByteArray configPath)
+M8_TTFF_STATS M8::ttffStatistics()
 {
-    m_control = new M8Control(device, configPath, this);
+    M8_TTFF_STATS stats;
+    QMetaObject::invokeMethod(m_control, [&] { stats = m_control->ttffStatistics(); }, blocking());
+    return stats;
+}
+
+/**
+ * @brief M8::metrics
+ * @return Snapshot of the runtime counters, taken without waiting for the parser thread
+ */
+M8_METRICS M8::metrics()
+{
+    return m_control->metrics();
+}
+
+/**
+ * @brief M8::positionTimestamp
+ * @return CLOCK_MONOTONIC time [ns] the bytes of the latest newPosition were read from the device
+ */
+qint64 M8::positionTimestamp()
+{
+    return m_positionTimestamp;
+}
+
+/**
+ * @brief M8::addSink
+ * @param sink Called on the parser thread. Not owned, and must stay valid until removed.
+ *
+ * May be called from a sink, and then takes effect from the next decoded data on.
+ */
+void M8::addSink(M8Sink *sink)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->addSink(sink); }, blocking());
+}
+
+/**
+ * @brief M8::removeSink
+ * @param sink
+ *
+ * The sink is not called again once this returns, except when removed from within a sink
+ * callback. It then still gets the data that is being delivered.
+ */
+void M8::removeSink(M8Sink *sink)
+{
+    QMetaObject::invokeMethod(m_control, [=] { m_control->removeSink(sink); }, blocking());
+}
+
+/**
+ * @brief M8::controlFix
+ *
+ * Runs on the thread of M8, after the fix crossed from the parser thread if there is one. The
+ * fix is only copied when it crosses threads, and newFix passes that copy on by reference.
+ */
+void M8::controlFix(const M8_FIX &fix)
+{
+    m_positionTimestamp = fix.timestamp;
+    m_control->metricsRegistry()->latency[M8_LATENCY_CONSUMER].add(Metrics::timestamp()
+                                                                   - fix.timestamp);
+    emit newPosition(fix.latitude, fix.longitude, fix.altitude, fix.satellites);
+    emit newFix(fix);
+}
+
+/**
+ * @brief M8::blocking
+ * @return Connection type for calls into M8Control that return a value
+ *
+ * Direct when already on the control thread, such as from a slot of a receiver that shares a
+ * worker, where a blocking queued call would wait for itself.
+ */
+Qt::ConnectionType M8::blocking()
+{
+    if (!m_controlThread || QThread::currentThread() == m_control->thread())
+        return Qt::DirectConnection;
+    return Qt::BlockingQueuedConnection;
+}
+
+/**
+ * @brief M8::init
+ * @param device
+ * @param configPath
+ *
+ * With "parserthread:1" in the configuration, framing, parsing and the receiver logic run on
+ * their own thread and only the signals of M8 are delivered on the thread that created it.
+ * Receivers of an M8Manager run on the worker given instead.
+ *
+ * M8Control starts talking to the receiver and arms its timers as it is constructed, so it is
+ * constructed on the thread it runs on rather than moved there afterwards.
+ */
+void M8::init(QString device, QByteArray configPath, IoReactor *reactor, QThread *worker)
+{
+    qRegisterMetaType<M8_FIX>("M8_FIX");
+    qRegisterMetaType<M8_STATUS>("M8_STATUS");
+    qRegisterMetaType<M8_SV_INFO>("M8_SV_INFO");
+    qRegisterMetaType<M8_TIME_SAMPLE>("M8_TIME_SAMPLE");
+    qRegisterMetaType<M8_TTFF>("M8_TTFF");
+    qRegisterMetaType<M8_POWER_MODE>("M8_POWER_MODE");
+    qRegisterMetaType<M8_GNSS_CONFIG>("M8_GNSS_CONFIG");
+
+    m_controlThread = worker;
+    if (!m_controlThread && Config(configPath).parserThread()) {
+        m_controlThread = new QThread();
+        m_controlThread->setObjectName("m8 parser");
+        m_ownsControlThread = true;
+        m_controlThread->start();
+    }
+
+    if (m_controlThread) {
+        QObject context;
+        context.moveToThread(m_controlThread);
+        Qt::ConnectionType type = (QThread::currentThread() == m_controlThread)
+                ? Qt::DirectConnection
+                : Qt::BlockingQueuedConnection;
+        QMetaObject::invokeMethod(
+                &context, [&] { m_control = new M8Control(device, configPath, reactor); },
+                type);
+    } else {
+        m_control = new M8Control(device, configPath, reactor, this);
+    }
+
     connect(m_control, &M8Control::statusChange, this, &M8::statusChange);
     connect(m_control, &M8Control::nmea, this, &M8::nmea);
-    connect(m_control, &M8Control::newPosition, this, &M8::newPosition);
+    connect(m_control, &M8Control::newFix, this, &M8::controlFix);
     connect(m_control, &M8Control::systemTimeDrift, this, &M8::systemTimeDrift);
+    connect(m_control, &M8Control::timeSample, this, &M8::timeSample);
     connect(m_control, &M8Control::satelliteInfo, this, &M8::satelliteInfo);
+    connect(m_control, &M8Control::ttff, this, &M8::ttff);
+    connect(m_control, &M8Control::powerModeChange, this, &M8::powerModeChange);
+    connect(m_control, &M8Control::scheduledFix, this, &M8::scheduledFix);
+    connect(m_control, &M8Control::gnssConfigChange, this, &M8::gnssConfigChange);
 }
@@ -23,11 +23,19 @@ SOFTWARE.
 */
 #include "m8control.h"
 #include "m8device.h"
+#include "metrics.h"
 #include "assistance.h"
 #include "config.h"
+#include "framer.h"
 #include "nmea.h"
+#include "ntpshm.h"
 #include "power.h"
+#include "recorder.h"
+#include "scheduler.h"
+#include "shmpublisher.h"
+#include "ttff.h"
 #include "ubx.h"
+#include <QSocketNotifier>
 #include <QThread>
 #include <QTimer>
 
@@ -39,30 +47,88 @@ SOFTWARE.
 #define M8C_D(x)
 #endif
 
-M8Control::M8Control(QString device, QByteArray configPath, QObject *parent)
-    : QObject(parent), m_status(M8_STATUS_INITIALIZING), m_chipConfirmationDone(false)
+/**
+ * @brief M8Control::M8Control
+ * @param device
+ * @param configPath
+ * @param reactor Shared I/O thread. Without one, or for a device it cannot serve, the device gets
+ * a thread of its own.
+ * @param parent
+ */
+M8Control::M8Control(QString device, QByteArray configPath, IoReactor *reactor,
+                     QObject *parent)
+    : QObject(parent),
+      m_m8DeviceThread(nullptr),
+      m_rxNotifier(nullptr),
+      m_status(M8_STATUS_INITIALIZING),
+      m_frameTimestamp(0),
+      m_frameParsed(false),
+      m_parserThread(false),
+      m_chipConfirmationDone(false),
+      m_ntpShm(nullptr),
+      m_shmPublisher(nullptr),
+      m_recorder(nullptr)
 {
-    m_m8Device = new M8Device(device);
+    m_metrics = new Metrics();
+    m_framer = new Framer(m_metrics);
+    m_m8Device = new M8Device(device, m_metrics, reactor);
     if (m_m8Device->isAvailable()) {
-        m_m8DeviceThread = new QThread();
-        m_m8Device->moveToThread(m_m8DeviceThread);
-        m_m8DeviceThread->start();
+        // Files and replays are read by an event loop, which must not be the parser's
+        if (!m_m8Device->usesReactor()) {
+            m_m8DeviceThread = new QThread();
+            m_m8Device->moveToThread(m_m8DeviceThread);
+            m_m8DeviceThread->start();
+        }
         m_nmea = new NMEA(this);
-        connect(m_nmea, &NMEA::newPosition, this, &M8Control::newPosition);
-        m_ubx = new UBX(m_m8Device, this);
+        m_ubx = new UBX(m_m8Device, m_metrics, this);
         connect(m_ubx, &UBX::systemTimeDrift, this, &M8Control::systemTimeDrift);
-        connect(m_ubx, &UBX::satelliteInfo, this, &M8Control::satelliteInfo);
+        connect(m_ubx, &UBX::timeSample, this, &M8Control::ubxTimeSample);
+        connect(m_ubx, &UBX::gnssConfig, this, &M8Control::gnssConfigChange);
+        connect(m_ubx, &UBX::satelliteInfo, this, &M8Control::ubxSatelliteInfo);
         m_config = new Config(configPath, this);
-        m_power = new Power(m_nmea, m_ubx, m_config, this);
+        m_parserThread = m_config->parserThread();
+        m_power = new Power(m_ubx, m_config, this);
+        connect(m_power, &Power::powerModeChange, this, &M8Control::powerModeChange);
         m_assistance = new Assistance(m_ubx, m_config, this);
+        m_ttff = new TTFF(m_ubx, m_power, m_assistance, this);
+        connect(m_ttff, &TTFF::ttff, this, &M8Control::ttff);
+        m_scheduler = new Scheduler(m_power, m_ttff, this);
+        connect(m_scheduler, &Scheduler::scheduledFix, this, &M8Control::scheduledFix);
+        // Power, TTFF and the scheduler follow the same fixes as the application
+        if (m_config->ubxFixes()) {
+            connectFixes(m_ubx);
+            m_ubx->setSinks(&m_sinks, true);
+        } else {
+            connectFixes(m_nmea);
+            m_ubx->setSinks(&m_sinks, false);
+            m_nmea->setFixSinks(&m_sinks);
+        }
+        if (m_config->ntpShmUnit() >= 0)
+            m_ntpShm = new NtpShm(m_config->ntpShmUnit(), m_config->ntpShmLatency(), m_ubx,
+                                  this);
+        if (!m_config->recordDirectory().isEmpty()) {
+            m_recorder = new Recorder(m_config->recordDirectory(), m_config->recordFileBytes(),
+                                      m_config->recordFileMs(), m_m8Device->baudRate(),
+                                      m_metrics);
+            m_recorder->start();
+            m_m8Device->setRecorder(m_recorder);
+        }
+        if (!m_config->shmName().isEmpty()) {
+            m_shmPublisher = new ShmPublisher(m_config->shmName());
+            addSink(m_shmPublisher);
+        }
         m_statusTimer = new QTimer(this);
         m_statusTimer->setInterval(3000);
         connect(m_statusTimer, &QTimer::timeout, this, &M8Control::chipTimeout);
 
-        connect(m_m8Device, &M8Device::data, this, &M8Control::deviceData);
+        m_rxNotifier = new QSocketNotifier(m_m8Device->receiveQueue()->eventFd(),
+                                           QSocketNotifier::Read, this);
+        connect(m_rxNotifier, &QSocketNotifier::activated, this, &M8Control::receiveQueued);
+        connect(m_m8Device, &M8Device::endOfData, this, &M8Control::endOfData);
         m_statusTimer->start();
     } else {
         delete m_m8Device;
+        m_m8Device = nullptr;
         setStatus(M8_STATUS_ERROR_DRIVER);
     }
 }
@@ -73,15 +139,84 @@ M8Control::~M8Control()
         m_m8DeviceThread->quit();
         m_m8DeviceThread->wait(2000);
         m_m8DeviceThread->deleteLater();
-        delete m_m8Device;
     }
+    delete m_m8Device;
+    delete m_recorder;
+    delete m_shmPublisher;
+    delete m_framer;
+    delete m_metrics;
 }
 
+/**
+ * @brief M8Control::setPower
+ * @param on
+ *
+ * Ignored while a fix schedule runs the engine.
+ */
 void M8Control::setPower(bool on)
 {
+    if (m_scheduler->isActive()) {
+        M8C_D("Fix schedule active, ignoring setPower(" << on << ")");
+        return;
+    }
     m_power->setPower(on);
 }
 
+void M8Control::setPowerPolicy(M8PowerPolicy *policy)
+{
+    m_power->setPolicy(policy);
+}
+
+void M8Control::setRequestedUpdatePeriod(quint32 periodMs)
+{
+    m_power->setRequestedPeriod(periodMs);
+}
+
+void M8Control::setPowerDwellTime(int dwellMs)
+{
+    m_power->setDwellTime(dwellMs);
+}
+
+M8_POWER_STATS M8Control::powerStatistics()
+{
+    return m_power->statistics();
+}
+
+void M8Control::setFixSchedule(const M8_FIX_SCHEDULE &schedule)
+{
+    m_scheduler->setSchedule(schedule);
+}
+
+void M8Control::clearFixSchedule()
+{
+    m_scheduler->clear();
+}
+
+M8_SCHEDULE_STATS M8Control::scheduleStatistics()
+{
+    return m_scheduler->statistics();
+}
+
+M8_GNSS_CONFIG M8Control::gnssConfig()
+{
+    return m_ubx->gnssConfiguration();
+}
+
+void M8Control::requestGnssConfig()
+{
+    m_ubx->requestGnssConfig();
+}
+
+bool M8Control::setGnssConfig(const M8_GNSS_CONFIG &config)
+{
+    return m_ubx->setGnssConfig(config);
+}
+
+bool M8Control::setGnssSystems(quint32 mask)
+{
+    return m_ubx->setGnssSystems(mask);
+}
+
 void M8Control::saveAutonomousAssistData()
 {
     m_assistance->saveAutonomousAssistData();
@@ -102,61 +237,171 @@ void M8Control::requestSatelliteInfo()
     m_ubx->requestSatelliteInfo();
 }
 
+void M8Control::sendUbxMessage(const QByteArray &message)
+{
+    m_ubx->sendMessage(message);
+}
+
+M8_TTFF_STATS M8Control::ttffStatistics()
+{
+    return m_ttff->statistics();
+}
+
+M8_METRICS M8Control::metrics()
+{
+    return m_metrics->snapshot();
+}
+
+/**
+ * @brief M8Control::metricsRegistry
+ * @return Counters, which may be read from any thread
+ */
+Metrics *M8Control::metricsRegistry()
+{
+    return m_metrics;
+}
+
+/**
+ * @brief M8Control::parserThread
+ * @return Whether the configuration asks for M8Control to run on its own thread
+ */
+bool M8Control::parserThread()
+{
+    return m_parserThread;
+}
+
+/**
+ * @brief M8Control::receiveQueued
+ *
+ * Drains every chunk the device thread queued since the last wakeup.
+ */
+void M8Control::receiveQueued()
+{
+    M8DeviceRxQueue *queue = m_m8Device->receiveQueue();
+    queue->clearWakeup();
+    while (M8DeviceChunk *chunk = queue->readSlot()) {
+        deviceData(QByteArray::fromRawData(chunk->data, chunk->size), chunk->timestamp);
+        queue->releaseSlot();
+    }
+}
+
 /**
  * @brief M8Control::deviceData
  * @param ba
+ * @param timestamp CLOCK_MONOTONIC time [ns] the data was read from the device
  *
- * Either NMEA or UBX message (disregarding CRC) will confirm chip presence.
+ * Either NMEA or UBX message with a valid checksum will confirm chip presence.
+ * Every frame completed here ends in this read, so it inherits its timestamp.
  */
-void M8Control::deviceData(QByteArray ba)
-{
-    m_input.append(ba);
-    while (!m_input.isEmpty()) {
-        if (m_input.startsWith('$')) {
-            int nmeaEnd = m_input.indexOf('\n');
-            if (nmeaEnd >= 0) {
-                QByteArray nmeaStr = m_input.left(nmeaEnd);
-                if (m_nmea->crcCheck(nmeaStr)) {
-                    M8C_D("NMEA: " << nmeaStr);
-                    emit nmea(nmeaStr);
-                    m_nmea->parse(nmeaStr);
-                } else {
-                    M8C_D("NMEA checksum error: " << nmeaStr);
-                }
-                m_input.remove(0, nmeaEnd);
-                setStatus(M8_STATUS_ON);
-                m_statusTimer->start();
-            } else {
-                M8C_D("Incomplete nmea string. Wait for more data. " << m_input);
-                break;
-            }
-        } else if (m_input.startsWith(static_cast<char>(0xB5))) {
-            if (m_input.count() >= 8) {
-                if (0x62 != m_input.at(1)) {
-                    M8C_D("Incorrect sync char for ubx message: " << m_input.at(1));
-                    m_input.remove(0, 1);
-                } else {
-                    int payloadLen = m_input.at(4) | (m_input.at(5) << 8);
-                    if (m_input.size() >= (payloadLen + 8)) {
-                        QByteArray ubxMessage = m_input.mid(2, payloadLen + 6);
-                        if (m_ubx->crcCheck(ubxMessage))
-                            m_ubx->parse(ubxMessage);
-
-                        m_input.remove(0, payloadLen + 8);
-                    } else {
-                        M8C_D("Incomplete ubx message. Wait for more data.");
-                        break;
-                    }
-                    setStatus(M8_STATUS_ON);
-                    m_statusTimer->start();
-                }
-            } else {
-                M8C_D("Incomplete ubx message. Wait for more data.");
-                break;
-            }
+void M8Control::deviceData(QByteArray ba, qint64 timestamp)
+{
+    qint64 received = Metrics::timestamp();
+    m_metrics->latency[M8_LATENCY_DEVICE_TO_CONTROL].add(received - timestamp);
+    m_framer->append(ba);
+    QByteArray frame;
+    while (Framer::Frame type = m_framer->next(frame)) {
+        if (Framer::FRAME_NMEA == type) {
+            M8C_D("NMEA: " << frame);
+            m_metrics->nmeaFrames[Metrics::nmeaType(frame)].add();
+            frameComplete(received);
+            m_sinks.nmea(frame);
+            emit nmea(frame);
+            m_nmea->parse(frame, timestamp);
+            frameParsed();
         } else {
-            m_input.remove(0, 1);
+            m_metrics->ubxFrames[Metrics::ubxType(frame.at(0), frame.at(1))].add();
+            frameComplete(received);
+            m_sinks.ubx(frame);
+            m_ubx->parse(frame, timestamp);
+            frameParsed();
         }
+        setStatus(M8_STATUS_ON);
+        m_statusTimer->start();
+    }
+    m_metrics->parserThreadCpuNs.set(static_cast<quint64>(Metrics::threadCpuTime()));
+}
+
+/**
+ * @brief M8Control::connectFixes
+ * @param decoder NMEA or UBX, whichever delivers the application's fixes
+ */
+template <class Decoder> void M8Control::connectFixes(Decoder *decoder)
+{
+    connect(decoder, &Decoder::newFix, this, &M8Control::position);
+    connect(decoder, &Decoder::newFix, m_power, &Power::newFix);
+    connect(decoder, &Decoder::fixLost, m_power, &Power::fixLost);
+    connect(decoder, &Decoder::newFix, m_ttff, &TTFF::newFix);
+    connect(decoder, &Decoder::newFix, m_scheduler, &Scheduler::newFix);
+}
+
+/**
+ * @brief M8Control::position
+ * @param fix From GGA, or from UBX-NAV-PVT with "fixsource:ubx"
+ *
+ * The sinks already had the fix from the decoder.
+ */
+void M8Control::position(const M8_FIX &fix)
+{
+    frameParsed();
+    qint64 delivery = Metrics::timestamp();
+    emit newFix(fix);
+    qint64 delivered = Metrics::timestamp();
+    m_metrics->latency[M8_LATENCY_DELIVERY].add(delivered - delivery);
+    m_metrics->latency[M8_LATENCY_END_TO_END].add(delivered - fix.timestamp);
+}
+
+/**
+ * @brief M8Control::endOfData
+ *
+ * A replayed recording has ended, so no more data will arrive.
+ */
+void M8Control::endOfData()
+{
+    m_statusTimer->stop();
+    setStatus(M8_STATUS_OFF);
+}
+
+void M8Control::ubxTimeSample(const M8_TIME_SAMPLE &sample)
+{
+    emit timeSample(sample);
+}
+
+void M8Control::ubxSatelliteInfo(const M8_SV_INFO &info)
+{
+    emit satelliteInfo(info);
+}
+
+/**
+ * @brief M8Control::addSink
+ * @param sink Not owned. It must stay valid until removed.
+ */
+void M8Control::addSink(M8Sink *sink)
+{
+    m_sinks.add(sink);
+}
+
+void M8Control::removeSink(M8Sink *sink)
+{
+    m_sinks.remove(sink);
+}
+
+void M8Control::frameComplete(qint64 received)
+{
+    m_frameTimestamp = Metrics::timestamp();
+    m_frameParsed = false;
+    m_metrics->latency[M8_LATENCY_FRAMING].add(m_frameTimestamp - received);
+}
+
+/**
+ * @brief M8Control::frameParsed
+ *
+ * Called when a frame is decoded, which for a position is before its signal is delivered.
+ */
+void M8Control::frameParsed()
+{
+    if (!m_frameParsed) {
+        m_frameParsed = true;
+        m_metrics->latency[M8_LATENCY_PARSING].add(Metrics::timestamp() - m_frameTimestamp);
     }
 }
 
@@ -172,6 +417,10 @@ void M8Control::setStatus(M8_STATUS status)
         M8C_D("Changing status:" << m_status << " to " << status);
         if (M8_STATUS_ON == status) {
             m_ubx->configureNMEA();
+            if (m_config->ubxFixes())
+                m_ubx->enableNavigationSolution();
+            if (m_ubx->timeSubscription())
+                m_ubx->setTimeSubscription(true);
             m_chipConfirmationDone = true;
         }
 
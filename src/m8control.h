@@ -25,57 +25,118 @@ SOFTWARE.
 #define M8CONTROL_H
 
 #include <QObject>
+#include <QVector>
 #include "m8_status.h"
+#include "m8_gnss.h"
+#include "m8_metrics.h"
+#include "m8_power.h"
+#include "m8_schedule.h"
+#include "m8_sink.h"
 #include "m8_sv_info.h"
+#include "m8_time.h"
+#include "m8_ttff.h"
+#include "sinks.h"
 
 class Assistance;
 class Config;
+class Framer;
+class IoReactor;
 class M8Device;
+class Metrics;
 class NMEA;
+class NtpShm;
 class Power;
+class QSocketNotifier;
 class QThread;
 class QTimer;
+class Recorder;
+class Scheduler;
+class ShmPublisher;
+class TTFF;
 class UBX;
 
 class M8Control : public QObject
 {
     Q_OBJECT
 public:
-    explicit M8Control(QString device, QByteArray configPath, QObject *parent = nullptr);
+    explicit M8Control(QString device, QByteArray configPath, IoReactor *reactor = nullptr,
+                       QObject *parent = nullptr);
     ~M8Control();
 
     void setPower(bool on);
+    void setPowerPolicy(M8PowerPolicy *policy);
+    void setRequestedUpdatePeriod(quint32 periodMs);
+    void setPowerDwellTime(int dwellMs);
+    M8_POWER_STATS powerStatistics();
+    void setFixSchedule(const M8_FIX_SCHEDULE &schedule);
+    void clearFixSchedule();
+    M8_SCHEDULE_STATS scheduleStatistics();
+    M8_GNSS_CONFIG gnssConfig();
+    void requestGnssConfig();
+    bool setGnssConfig(const M8_GNSS_CONFIG &config);
+    bool setGnssSystems(quint32 mask);
     void saveAutonomousAssistData();
     M8_STATUS status();
     void requestTime();
     void requestSatelliteInfo();
+    void sendUbxMessage(const QByteArray &message);
+    M8_TTFF_STATS ttffStatistics();
+    M8_METRICS metrics();
+    Metrics *metricsRegistry();
+    bool parserThread();
+    void addSink(M8Sink *sink);
+    void removeSink(M8Sink *sink);
 
 signals:
     void statusChange(M8_STATUS status);
     void nmea(const QByteArray &nmea);
-    void newPosition(double latitude, double longitude, float altitude, quint8 satellites);
+    void newFix(const M8_FIX &fix);
     void systemTimeDrift(qint64 offsetMilliseconds);
+    void timeSample(M8_TIME_SAMPLE sample);
     void satelliteInfo(M8_SV_INFO info);
+    void ttff(M8_TTFF ttff);
+    void powerModeChange(M8_POWER_MODE mode);
+    void scheduledFix(bool success);
+    void gnssConfigChange(M8_GNSS_CONFIG config);
 
 private slots:
-    void deviceData(QByteArray ba);
+    void receiveQueued();
+    void deviceData(QByteArray ba, qint64 timestamp);
+    void position(const M8_FIX &fix);
+    void ubxTimeSample(const M8_TIME_SAMPLE &sample);
+    void ubxSatelliteInfo(const M8_SV_INFO &info);
     void chipTimeout();
+    void endOfData();
 
 private:
+    void frameComplete(qint64 received);
+    void frameParsed();
     void setStatus(M8_STATUS status);
+    template <class Decoder> void connectFixes(Decoder *decoder);
 
 private:
+    Metrics *m_metrics;
     M8Device *m_m8Device;
     QThread *m_m8DeviceThread;
+    QSocketNotifier *m_rxNotifier;
     M8_STATUS m_status;
     QTimer *m_statusTimer;
-    QByteArray m_input;
+    Framer *m_framer;
+    qint64 m_frameTimestamp;
+    bool m_frameParsed;
+    bool m_parserThread;
     Assistance *m_assistance;
     Config *m_config;
     Power *m_power;
     NMEA *m_nmea;
     bool m_chipConfirmationDone;
     UBX *m_ubx;
+    TTFF *m_ttff;
+    Scheduler *m_scheduler;
+    NtpShm *m_ntpShm;
+    ShmPublisher *m_shmPublisher;
+    Recorder *m_recorder;
+    Sinks m_sinks;
 };
 
 #endif // M8CONTROL_H
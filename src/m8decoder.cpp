@@ -0,0 +1,516 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_decoder.h"
+#include "framer.h"
+#include "kernels.h"
+#include "metrics.h"
+#include "nmea.h"
+#include "recordreader.h"
+#include "ubx.h"
+#include <QAtomicInteger>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QThread>
+#include <string.h>
+
+//#define M8DECODER_DEBUG
+#ifdef M8DECODER_DEBUG
+#include <QDebug>
+#define M8DECODER_D(x) qDebug() << "[M8Decoder] " << x
+#else
+#define M8DECODER_D(x)
+#endif
+
+#define FEED_BYTES 1024 /* The framer moves what is buffered after every frame, so keep it short */
+#define SCAN_BYTES 65536 /* Bytes handed to Kernels::findFrameStart() per call */
+
+/**
+ * @brief Decoding state of one piece of the capture
+ */
+struct M8DecoderChunk {
+    qint64 begin; /* First frame */
+    qint64 end; /* Frames starting here or later belong to the next chunk */
+    qint64 stop; /* First frame at or after end, or the capture size if there is none */
+    M8_DECODED_POSITIONS positions;
+    M8_DECODED_TIMES times;
+    M8_DECODED_SATELLITES satellites;
+    M8_DECODER_STATS stats;
+};
+
+M8Decoder::M8Decoder()
+    : m_data(nullptr),
+      m_size(0),
+      m_threads(0),
+      m_chunkSize(16 * 1024 * 1024)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/**
+ * @brief M8Decoder::setThreads
+ * @param threads 0 to use one per core
+ */
+void M8Decoder::setThreads(int threads)
+{
+    m_threads = threads;
+}
+
+/**
+ * @brief M8Decoder::setChunkSize
+ * @param bytes Nominal size of the pieces decoded in parallel
+ */
+void M8Decoder::setChunkSize(qint64 bytes)
+{
+    m_chunkSize = qMax<qint64>(bytes, 4096);
+}
+
+/**
+ * @brief M8Decoder::decode
+ * @param path Raw capture, exactly as read from the receiver, or a .m8rec recording
+ * @return false if the capture could not be mapped or the recording could not be read
+ *
+ * Replaces the result of a previous decode.
+ */
+bool M8Decoder::decode(const QString &path)
+{
+    m_positions = M8_DECODED_POSITIONS();
+    m_times = M8_DECODED_TIMES();
+    m_satellites = M8_DECODED_SATELLITES();
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    if (path.endsWith(".m8rec")) {
+        // The stream may be larger than a QByteArray can hold, so it is mapped from a file too
+        QTemporaryFile stream;
+        if (!stream.open()) {
+            qWarning("[M8Decoder] Could not create a temporary file for %s",
+                     path.toUtf8().constData());
+            return false;
+        }
+        return readRecording(path, &stream) && decodeFile(&stream, path);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("[M8Decoder] Could not open %s", path.toUtf8().constData());
+        return false;
+    }
+    return decodeFile(&file, path);
+}
+
+/**
+ * @brief M8Decoder::readRecording
+ * @param path
+ * @param stream Gets the data of every chunk read from the receiver, in recorded order
+ * @return false if the file is not a recording or the stream could not be written
+ *
+ * What was written to the receiver is left out, as it is not part of the stream it sent.
+ */
+bool M8Decoder::readRecording(const QString &path, QFile *stream) const
+{
+    RecordReader reader(path);
+    if (!reader.isOpen()) {
+        qWarning("[M8Decoder] Could not read %s", path.toUtf8().constData());
+        return false;
+    }
+
+    M8_RECORD_CHUNK chunk;
+    QByteArray data;
+    while (reader.next(&chunk, &data)) {
+        if (M8_RECORD_RX == chunk.direction && stream->write(data) != data.size()) {
+            qWarning("[M8Decoder] Could not write the stream of %s", path.toUtf8().constData());
+            return false;
+        }
+    }
+    return stream->flush();
+}
+
+/**
+ * @brief M8Decoder::decodeFile
+ * @param file Open for reading
+ * @param path For messages
+ * @return false if the file could not be mapped
+ */
+bool M8Decoder::decodeFile(QFile *file, const QString &path)
+{
+    m_size = file->size();
+    m_stats.bytes = static_cast<quint64>(m_size);
+    if (m_size == 0)
+        return true;
+    uchar *map = file->map(0, m_size);
+    if (!map) {
+        qWarning("[M8Decoder] Could not map %s", path.toUtf8().constData());
+        return false;
+    }
+    m_data = reinterpret_cast<const char *>(map);
+    decodeData();
+    file->unmap(map);
+    m_data = nullptr;
+    return true;
+}
+
+/**
+ * @brief M8Decoder::decodeData
+ *
+ * Decodes the m_size bytes at m_data in parallel.
+ */
+void M8Decoder::decodeData()
+{
+    // The first chunk starts where a sequential decode would, the rest at a verified frame
+    QVector<M8DecoderChunk> chunks;
+    qint64 begin = 0;
+    while (begin < m_size) {
+        M8DecoderChunk chunk;
+        chunk.begin = begin;
+        begin = nextFrameStart(begin + m_chunkSize, m_size);
+        chunk.end = begin;
+        chunks.append(chunk);
+    }
+    m_stats.chunks = static_cast<quint32>(chunks.size());
+    M8DECODER_D("Decoding" << m_size << "bytes in" << chunks.size() << "chunks");
+
+    int threads = (m_threads > 0) ? m_threads : QThread::idealThreadCount();
+    threads = qBound(1, threads, chunks.size());
+    QAtomicInteger<int> nextChunk(0);
+    M8DecoderChunk *pending = chunks.data();
+    int count = chunks.size();
+    QVector<QThread *> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.append(QThread::create([&]() {
+            int index;
+            while ((index = nextChunk.fetchAndAddRelaxed(1)) < count)
+                decodeChunk(&pending[index]);
+        }));
+        workers.last()->start();
+    }
+    for (QThread *worker : qAsConst(workers)) {
+        worker->wait();
+        delete worker;
+    }
+
+    for (int i = 0; i < chunks.size(); ++i) {
+        if (i > 0 && chunks[i].begin != chunks[i - 1].stop) {
+            // Framing the previous chunk did not end at this start, e.g. because it lies within
+            // a frame. Continue from where it did end instead.
+            M8DECODER_D("Chunk" << i << "starts at" << chunks[i].begin << "instead of"
+                                << chunks[i - 1].stop);
+            M8DecoderChunk redo;
+            redo.begin = chunks[i - 1].stop;
+            redo.end = chunks[i].end;
+            chunks[i] = redo;
+            decodeChunk(&chunks[i]);
+            m_stats.redecodedChunks++;
+        }
+        merge(chunks[i]);
+        chunks[i] = M8DecoderChunk();
+    }
+}
+
+/**
+ * @brief M8Decoder::nextFrameStart
+ * @param offset
+ * @param limit
+ * @return Offset of the first frame with a valid checksum at or after offset, or limit
+ */
+qint64 M8Decoder::nextFrameStart(qint64 offset, qint64 limit) const
+{
+    while (offset < limit) {
+        int block = static_cast<int>(qMin<qint64>(limit - offset, SCAN_BYTES));
+        int skip = Kernels::findFrameStart(m_data + offset, block);
+        offset += skip;
+        if (skip == block)
+            continue;
+        if ('$' == m_data[offset]) {
+            const char *start = m_data + offset;
+            qint64 length = qMin<qint64>(MAX_NMEA_LENGTH, m_size - offset);
+            const char *end = static_cast<const char *>(memchr(start, '\n', length));
+            if (end
+                && NMEA::crcCheck(QByteArray::fromRawData(start, static_cast<int>(end - start))))
+                return offset;
+        } else if (static_cast<char>(0xB5) == m_data[offset] && offset + 8 <= m_size
+                   && 0x62 == m_data[offset + 1]) {
+            int payloadLen = (m_data[offset + 4] & 0xFF) | ((m_data[offset + 5] & 0xFF) << 8);
+            int maxPayload = Framer::maxUbxPayload(static_cast<quint8>(m_data[offset + 2]),
+                                                   static_cast<quint8>(m_data[offset + 3]));
+            if (payloadLen <= maxPayload && offset + payloadLen + 8 <= m_size
+                && UBX::crcCheck(QByteArray::fromRawData(m_data + offset + 2, payloadLen + 6)))
+                return offset;
+        }
+        ++offset;
+    }
+    return limit;
+}
+
+/**
+ * @brief M8Decoder::decodeChunk
+ * @param chunk Frames starting in [begin, end) are decoded
+ *
+ * Frames may extend past end, so the capture is fed to the framer until a frame starts at or
+ * after end.
+ */
+void M8Decoder::decodeChunk(M8DecoderChunk *chunk) const
+{
+    memset(&chunk->stats, 0, sizeof(chunk->stats));
+    Metrics metrics;
+    Framer framer(&metrics);
+    QByteArray frame;
+    qint64 fed = chunk->begin;
+    chunk->stop = m_size;
+    for (;;) {
+        Framer::Frame type = framer.next(frame);
+        if (Framer::FRAME_NONE == type) {
+            if (fed >= m_size)
+                break;
+            int bytes = static_cast<int>(qMin<qint64>(FEED_BYTES, m_size - fed));
+            framer.append(QByteArray::fromRawData(m_data + fed, bytes));
+            fed += bytes;
+            continue;
+        }
+
+        qint64 offset = chunk->begin + framer.frameOffset();
+        if (offset >= chunk->end) {
+            chunk->stop = offset;
+            break;
+        }
+
+        if (Framer::FRAME_NMEA == type) {
+            M8_FIX fix;
+            chunk->stats.nmeaFrames++;
+            if (NMEA::decodeGga(frame, &fix)) {
+                chunk->positions.offset.append(offset);
+                chunk->positions.utcTimeOfDay.append(fix.utcTimeOfDay);
+                chunk->positions.latitude.append(fix.latitude);
+                chunk->positions.longitude.append(fix.longitude);
+                chunk->positions.altitude.append(fix.altitude);
+                chunk->positions.satellites.append(fix.satellites);
+                chunk->positions.hdop.append(fix.hdop);
+            }
+        } else {
+            chunk->stats.ubxFrames++;
+            M8_TIME_SAMPLE sample;
+            M8_SV_INFO info;
+            if (0x01 == frame.at(0) && 0x21 == frame.at(1) && UBX::decodeTimeUtc(frame, &sample)) {
+                chunk->times.offset.append(offset);
+                chunk->times.receiverTime.append(sample.receiverTime);
+                chunk->times.accuracy.append(sample.accuracy);
+                chunk->times.valid.append(sample.valid);
+            } else if (0x01 == frame.at(0) && 0x35 == frame.at(1)
+                       && UBX::decodeSatelliteInfo(frame, &info)) {
+                int used = 0;
+                int withSignal = 0;
+                int cnoSum = 0;
+                for (const M8_SV &sat : qAsConst(info.satellites)) {
+                    if (sat.flags & 0x08)
+                        used++;
+                    if (sat.cno > 0) {
+                        withSignal++;
+                        cnoSum += sat.cno;
+                    }
+                }
+                chunk->satellites.offset.append(offset);
+                chunk->satellites.iTOW.append(info.iTOW);
+                chunk->satellites.numSvs.append(info.numSvs);
+                chunk->satellites.used.append(static_cast<quint8>(used));
+                chunk->satellites.meanCno.append(withSignal > 0 ? float(cnoSum) / withSignal : 0);
+            }
+        }
+    }
+    chunk->stats.nmeaChecksumErrors = metrics.nmeaChecksumErrors.value();
+    chunk->stats.ubxChecksumErrors = metrics.ubxChecksumErrors.value();
+    chunk->stats.framesRecovered = metrics.framesRecovered.value();
+    chunk->stats.resyncs = metrics.resyncs.value();
+    chunk->stats.bytesDiscarded = metrics.bytesDiscarded.value();
+}
+
+void M8Decoder::merge(const M8DecoderChunk &chunk)
+{
+    m_positions.offset += chunk.positions.offset;
+    m_positions.utcTimeOfDay += chunk.positions.utcTimeOfDay;
+    m_positions.latitude += chunk.positions.latitude;
+    m_positions.longitude += chunk.positions.longitude;
+    m_positions.altitude += chunk.positions.altitude;
+    m_positions.satellites += chunk.positions.satellites;
+    m_positions.hdop += chunk.positions.hdop;
+    m_times.offset += chunk.times.offset;
+    m_times.receiverTime += chunk.times.receiverTime;
+    m_times.accuracy += chunk.times.accuracy;
+    m_times.valid += chunk.times.valid;
+    m_satellites.offset += chunk.satellites.offset;
+    m_satellites.iTOW += chunk.satellites.iTOW;
+    m_satellites.numSvs += chunk.satellites.numSvs;
+    m_satellites.used += chunk.satellites.used;
+    m_satellites.meanCno += chunk.satellites.meanCno;
+    m_stats.nmeaFrames += chunk.stats.nmeaFrames;
+    m_stats.ubxFrames += chunk.stats.ubxFrames;
+    m_stats.nmeaChecksumErrors += chunk.stats.nmeaChecksumErrors;
+    m_stats.ubxChecksumErrors += chunk.stats.ubxChecksumErrors;
+    m_stats.framesRecovered += chunk.stats.framesRecovered;
+    m_stats.resyncs += chunk.stats.resyncs;
+    m_stats.bytesDiscarded += chunk.stats.bytesDiscarded;
+}
+
+const M8_DECODED_POSITIONS &M8Decoder::positions() const
+{
+    return m_positions;
+}
+
+const M8_DECODED_TIMES &M8Decoder::times() const
+{
+    return m_times;
+}
+
+const M8_DECODED_SATELLITES &M8Decoder::satellites() const
+{
+    return m_satellites;
+}
+
+M8_DECODER_STATS M8Decoder::statistics() const
+{
+    return m_stats;
+}
+
+/**
+ * @brief M8Decoder::writeCsv
+ * @param directory Gets positions.csv, times.csv and satellites.csv
+ * @return false if a file could not be written
+ */
+bool M8Decoder::writeCsv(const QString &directory) const
+{
+    QDir dir(directory);
+    dir.mkpath(".");
+    QByteArray out;
+
+    out = "offset,utc_time_of_day_ms,latitude,longitude,altitude,satellites,hdop\n";
+    for (int i = 0; i < m_positions.offset.size(); ++i) {
+        out += QByteArray::number(m_positions.offset.at(i)) + ','
+                + QByteArray::number(m_positions.utcTimeOfDay.at(i)) + ','
+                + QByteArray::number(m_positions.latitude.at(i), 'f', 8) + ','
+                + QByteArray::number(m_positions.longitude.at(i), 'f', 8) + ','
+                + QByteArray::number(m_positions.altitude.at(i), 'f', 1) + ','
+                + QByteArray::number(m_positions.satellites.at(i)) + ','
+                + QByteArray::number(m_positions.hdop.at(i), 'f', 2) + '\n';
+    }
+    QFile positions(dir.filePath("positions.csv"));
+    if (!positions.open(QIODevice::WriteOnly) || positions.write(out) != out.size())
+        return false;
+
+    out = "offset,receiver_time_ns,accuracy_ns,valid\n";
+    for (int i = 0; i < m_times.offset.size(); ++i) {
+        out += QByteArray::number(m_times.offset.at(i)) + ','
+                + QByteArray::number(m_times.receiverTime.at(i)) + ','
+                + QByteArray::number(m_times.accuracy.at(i)) + ','
+                + QByteArray::number(m_times.valid.at(i)) + '\n';
+    }
+    QFile times(dir.filePath("times.csv"));
+    if (!times.open(QIODevice::WriteOnly) || times.write(out) != out.size())
+        return false;
+
+    out = "offset,itow_ms,num_svs,used,mean_cno\n";
+    for (int i = 0; i < m_satellites.offset.size(); ++i) {
+        out += QByteArray::number(m_satellites.offset.at(i)) + ','
+                + QByteArray::number(m_satellites.iTOW.at(i)) + ','
+                + QByteArray::number(m_satellites.numSvs.at(i)) + ','
+                + QByteArray::number(m_satellites.used.at(i)) + ','
+                + QByteArray::number(m_satellites.meanCno.at(i), 'f', 1) + '\n';
+    }
+    QFile satellites(dir.filePath("satellites.csv"));
+    return satellites.open(QIODevice::WriteOnly) && satellites.write(out) == out.size();
+}
+
+namespace {
+
+struct ColumnData {
+    const char *name;
+    M8_COLUMN_TYPE type;
+    quint32 size;
+    const void *data;
+};
+
+template<class T>
+ColumnData column(const char *name, M8_COLUMN_TYPE type, const QVector<T> &values)
+{
+    return { name, type, sizeof(T), values.constData() };
+}
+
+bool writeTable(const QString &path, quint64 rows, const QVector<ColumnData> &columns)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    M8_COLUMNS_HEADER header;
+    header.magic = M8_COLUMNS_MAGIC;
+    header.version = M8_COLUMNS_VERSION;
+    header.columns = static_cast<quint16>(columns.size());
+    header.rows = rows;
+    bool ok = file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header);
+    for (const ColumnData &data : columns) {
+        M8_COLUMN column;
+        memset(&column, 0, sizeof(column));
+        strncpy(column.name, data.name, sizeof(column.name) - 1);
+        column.type = data.type;
+        column.size = data.size;
+        ok = ok && file.write(reinterpret_cast<const char *>(&column), sizeof(column))
+                        == sizeof(column);
+    }
+    for (const ColumnData &data : columns) {
+        qint64 bytes = static_cast<qint64>(rows * data.size);
+        ok = ok && file.write(static_cast<const char *>(data.data), bytes) == bytes;
+    }
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief M8Decoder::writeColumns
+ * @param directory Gets positions.m8col, times.m8col and satellites.m8col
+ * @return false if a file could not be written
+ */
+bool M8Decoder::writeColumns(const QString &directory) const
+{
+    QDir dir(directory);
+    dir.mkpath(".");
+    return writeTable(dir.filePath("positions.m8col"),
+                      static_cast<quint64>(m_positions.offset.size()),
+                      { column("offset", M8_COLUMN_INT, m_positions.offset),
+                        column("utcTimeOfDay", M8_COLUMN_INT, m_positions.utcTimeOfDay),
+                        column("latitude", M8_COLUMN_FLOAT, m_positions.latitude),
+                        column("longitude", M8_COLUMN_FLOAT, m_positions.longitude),
+                        column("altitude", M8_COLUMN_FLOAT, m_positions.altitude),
+                        column("satellites", M8_COLUMN_UINT, m_positions.satellites),
+                        column("hdop", M8_COLUMN_FLOAT, m_positions.hdop) })
+            && writeTable(dir.filePath("times.m8col"), static_cast<quint64>(m_times.offset.size()),
+                          { column("offset", M8_COLUMN_INT, m_times.offset),
+                            column("receiverTime", M8_COLUMN_INT, m_times.receiverTime),
+                            column("accuracy", M8_COLUMN_UINT, m_times.accuracy),
+                            column("valid", M8_COLUMN_UINT, m_times.valid) })
+            && writeTable(dir.filePath("satellites.m8col"),
+                          static_cast<quint64>(m_satellites.offset.size()),
+                          { column("offset", M8_COLUMN_INT, m_satellites.offset),
+                            column("iTOW", M8_COLUMN_UINT, m_satellites.iTOW),
+                            column("numSvs", M8_COLUMN_UINT, m_satellites.numSvs),
+                            column("used", M8_COLUMN_UINT, m_satellites.used),
+                            column("meanCno", M8_COLUMN_FLOAT, m_satellites.meanCno) });
+}
@@ -22,8 +22,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "m8device.h"
-#include <qplatformdefs.h>
+#include "ioreactor.h"
+#include "metrics.h"
+#include "recorder.h"
+#include "replay.h"
+#include "transport.h"
+#include <errno.h>
 #include <QSocketNotifier>
+#include <QTimer>
 
 //#define M8DEVICE_DEBUG
 #ifdef M8DEVICE_DEBUG
@@ -33,63 +39,383 @@ SOFTWARE.
 #define M8DEVICE_D(x)
 #endif
 
-#define MAX_WRITE_DATA 512
-#define MAX_READ_DATA 512
+#define READ_BATCH 8
+#define WRITE_BATCH 16
 
-M8Device::M8Device(QString device, QObject *parent) : QObject(parent), m_socketNotifier(nullptr)
+/**
+ * @brief M8Device::M8Device
+ * @param device Device path or transport, see Transport::create(), or "replay:" and a recording
+ * @param metrics
+ * @param reactor I/O thread to serve the device from. Without one, the device is served by the
+ * event loop of the thread it lives on.
+ * @param parent
+ */
+M8Device::M8Device(QString device, Metrics *metrics, IoReactor *reactor, QObject *parent)
+    : QObject(parent),
+      p_metrics(metrics),
+      p_reactor(reactor),
+      p_recorder(nullptr),
+      m_socketNotifier(nullptr),
+      m_txNotifier(nullptr),
+      m_writeNotifier(nullptr),
+      m_replay(nullptr),
+      m_transport(nullptr),
+      m_baudRate(0),
+      m_atEnd(false)
 {
-    m_deviceFD = QT_OPEN(device.toUtf8().constData(), O_RDWR);
-    if (m_deviceFD < 0) {
+    if (device.startsWith("replay:")) {
+        initReplay(device.mid(7));
+        return;
+    }
+
+    m_transport = Transport::create(device);
+    if (!m_transport->open()) {
         qWarning("[M8Device] Could not open %s", device.toUtf8().constData());
+        delete m_transport;
+        m_transport = nullptr;
+        return;
+    }
+    m_baudRate = m_transport->baudRate();
+
+    // A file is always readable, which epoll refuses. It is read by the event loop instead.
+    if (p_reactor && m_transport->pollable()) {
+        if (!p_reactor->add(this)) {
+            qWarning("[M8Device] Could not watch %s", device.toUtf8().constData());
+            delete m_transport;
+            m_transport = nullptr;
+        }
     } else {
-        m_socketNotifier = new QSocketNotifier(m_deviceFD, QSocketNotifier::Read, this);
+        p_reactor = nullptr;
+        m_socketNotifier = new QSocketNotifier(m_transport->fd(), QSocketNotifier::Read, this);
         connect(m_socketNotifier, &QSocketNotifier::activated, this, &M8Device::readDeviceData);
+        m_txNotifier = new QSocketNotifier(m_txQueue.eventFd(), QSocketNotifier::Read, this);
+        connect(m_txNotifier, &QSocketNotifier::activated, this, &M8Device::writeQueued);
+        // Only watched while a write is waiting for room in the transport
+        m_writeNotifier = new QSocketNotifier(m_transport->fd(), QSocketNotifier::Write, this);
+        m_writeNotifier->setEnabled(false);
+        connect(m_writeNotifier, &QSocketNotifier::activated, this, &M8Device::writeQueued);
     }
 }
 
+/**
+ * @brief M8Device::initReplay
+ * @param source See Replay
+ *
+ * Replays a recording through the receive ring. Writes are counted but not sent anywhere. A
+ * replay always runs on the event loop of the device, also when a reactor is given.
+ */
+void M8Device::initReplay(QString source)
+{
+    p_reactor = nullptr;
+    m_replay = new Replay(source, &m_rxQueue, p_metrics, this);
+    if (!m_replay->isAvailable()) {
+        delete m_replay;
+        m_replay = nullptr;
+        return;
+    }
+    m_baudRate = m_replay->baudRate();
+    connect(m_replay, &Replay::finished, this, &M8Device::endOfData);
+    m_txNotifier = new QSocketNotifier(m_txQueue.eventFd(), QSocketNotifier::Read, this);
+    connect(m_txNotifier, &QSocketNotifier::activated, this, &M8Device::writeQueued);
+}
+
 M8Device::~M8Device()
 {
+    if (p_reactor && m_transport)
+        p_reactor->remove(this);
     if (m_socketNotifier) {
         disconnect(m_socketNotifier, &QSocketNotifier::activated, this, &M8Device::readDeviceData);
         m_socketNotifier->deleteLater();
     }
+    if (m_txNotifier) {
+        disconnect(m_txNotifier, &QSocketNotifier::activated, this, &M8Device::writeQueued);
+        m_txNotifier->deleteLater();
+    }
+    if (m_writeNotifier) {
+        disconnect(m_writeNotifier, &QSocketNotifier::activated, this, &M8Device::writeQueued);
+        m_writeNotifier->deleteLater();
+    }
 
-    if (m_deviceFD >= 0)
-        QT_CLOSE(m_deviceFD);
+    delete m_transport;
 }
 
 bool M8Device::isAvailable()
 {
-    return (m_deviceFD >= 0);
+    return (m_transport || m_replay);
 }
 
-void M8Device::write(QByteArray message)
+/**
+ * @brief M8Device::usesReactor
+ * @return false if the device is served by the event loop of its thread, which is the case for
+ * files and replays even when a reactor was given
+ */
+bool M8Device::usesReactor()
 {
-    if (m_deviceFD < 0)
-        return;
+    return p_reactor != nullptr;
+}
+
+/**
+ * @brief M8Device::baudRate
+ * @return Configured baud rate, or 0 if the device is not a serial port
+ */
+int M8Device::baudRate()
+{
+    return m_baudRate;
+}
+
+int M8Device::fd()
+{
+    return m_transport ? m_transport->fd() : -1;
+}
+
+/**
+ * @brief M8Device::transmitEventFd
+ * @return Descriptor that becomes readable when send() has queued messages
+ */
+int M8Device::transmitEventFd()
+{
+    return m_txQueue.eventFd();
+}
+
+/**
+ * @brief M8Device::receiveQueue
+ * @return Ring the device thread fills with everything read. It has one consumer.
+ */
+M8DeviceRxQueue *M8Device::receiveQueue()
+{
+    return &m_rxQueue;
+}
+
+/**
+ * @brief M8Device::send
+ * @param message
+ * @return false if the transmit ring is full and the message was not queued
+ *
+ * Queues the message for the device thread. Called from one thread only.
+ */
+bool M8Device::send(const QByteArray &message)
+{
+    QByteArray *slot = m_txQueue.writeSlot();
+    if (!slot)
+        return false;
+
+    *slot = message;
+    m_txQueue.commitWrite();
+    return true;
+}
+
+/**
+ * @brief M8Device::setRecorder
+ * @param recorder Gets everything read and written
+ *
+ * Both directions are recorded on the device thread as the data passes the transport, so the
+ * timestamps in a recording never go back. Safe to call while the device thread runs.
+ */
+void M8Device::setRecorder(Recorder *recorder)
+{
+    p_recorder.storeRelease(recorder);
+    if (m_replay)
+        m_replay->setRecorder(recorder);
+}
+
+/**
+ * @brief M8Device::writeQueued
+ *
+ * Writes everything queued by send() since the last wakeup, several messages per system call.
+ * When the transport has no room, what is left is kept and the rest of the ring waits until the
+ * descriptor is writable again, see writePending().
+ */
+void M8Device::writeQueued()
+{
+    m_txQueue.clearWakeup();
+    QByteArray unsent;
+    unsent.swap(m_unsent);
+    struct iovec iov;
+    iov.iov_base = unsent.data();
+    iov.iov_len = static_cast<size_t>(unsent.size());
+    bool complete = unsent.isEmpty() || writeAll(&iov, 1);
 
-    while (!message.isEmpty()) {
-        int bytesToSend = qMin(message.count(), MAX_WRITE_DATA);
-        ssize_t bytesSent =
-                QT_WRITE(m_deviceFD, message.left(bytesToSend), static_cast<size_t>(bytesToSend));
-        M8DEVICE_D("writeMessage() - actual size: " << bytesToSend << ", sent: " << bytesSent);
-        if (bytesSent > 0) {
-            message.remove(0, static_cast<int>(bytesSent));
-        } else {
-            message.clear();
-            M8DEVICE_D("writeMessage() - ERROR");
+    QByteArray *messages[WRITE_BATCH];
+    while (complete) {
+        int count = m_txQueue.readSlots(messages, WRITE_BATCH);
+        if (count == 0)
+            break;
+        complete = writeBatch(messages, count);
+        for (int i = 0; i < count; ++i)
+            messages[i]->clear();
+        m_txQueue.releaseSlot(static_cast<quint32>(count));
+    }
+    if (m_writeNotifier)
+        m_writeNotifier->setEnabled(!complete);
+}
+
+/**
+ * @brief M8Device::writePending
+ * @return true while written data waits for the transport to become writable
+ *
+ * The reactor watches the descriptor for writability while this is true and calls writeQueued()
+ * when it is.
+ */
+bool M8Device::writePending()
+{
+    return !m_unsent.isEmpty();
+}
+
+/**
+ * @brief M8Device::writeBatch
+ * @param messages
+ * @param count
+ * @return false if the transport took only part of the messages. The rest is kept in m_unsent.
+ */
+bool M8Device::writeBatch(QByteArray **messages, int count)
+{
+    struct iovec iov[WRITE_BATCH];
+    quint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        iov[i].iov_base = messages[i]->data();
+        iov[i].iov_len = static_cast<size_t>(messages[i]->size());
+        total += iov[i].iov_len;
+    }
+
+    if (Recorder *recorder = p_recorder.loadAcquire()) {
+        qint64 timestamp = Metrics::timestamp();
+        for (int i = 0; i < count; ++i)
+            recorder->record(M8_RECORD_TX, timestamp, messages[i]->constData(),
+                             messages[i]->size());
+    }
+
+    if (m_replay) {
+        // Nothing to send to. The messages are kept by the recorder, if there is one.
+        p_metrics->writeCalls.add();
+        p_metrics->bytesWritten.add(total);
+        return true;
+    }
+
+    if (!m_transport)
+        return true;
+
+    return writeAll(iov, count);
+}
+
+/**
+ * @brief M8Device::writeAll
+ * @param iov Buffers to write, updated as they are sent
+ * @param count
+ * @return false if the transport would block. What was not sent is appended to m_unsent.
+ *
+ * Buffers are dropped on any other error.
+ */
+bool M8Device::writeAll(struct iovec *iov, int count)
+{
+    struct iovec *next = iov;
+    while (count > 0) {
+        ssize_t bytesSent = m_transport->write(next, count);
+        M8DEVICE_D("writeAll() - buffers: " << count << ", sent: " << bytesSent);
+        p_metrics->writeCalls.add();
+        if (bytesSent < 0 && errno == EINTR)
+            continue;
+        if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            for (int i = 0; i < count; ++i)
+                m_unsent.append(static_cast<const char *>(next[i].iov_base),
+                                static_cast<int>(next[i].iov_len));
+            M8DEVICE_D("writeAll() - kept " << m_unsent.size() << " bytes");
+            return false;
+        }
+        if (bytesSent <= 0) {
+            p_metrics->writeErrors.add();
+            M8DEVICE_D("writeAll() - ERROR");
+            return true;
+        }
+
+        p_metrics->bytesWritten.add(static_cast<quint64>(bytesSent));
+        // Skip what was sent, the last buffer possibly only in part
+        size_t sent = static_cast<size_t>(bytesSent);
+        while (count > 0 && sent >= next->iov_len) {
+            sent -= next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0) {
+            next->iov_base = static_cast<char *>(next->iov_base) + sent;
+            next->iov_len -= sent;
         }
     }
+    return true;
+}
+
+void M8Device::resumeRead()
+{
+    m_socketNotifier->setEnabled(true);
 }
 
 void M8Device::readDeviceData()
 {
-    static char buffer[MAX_READ_DATA];
-    ssize_t bytesRead = QT_READ(m_deviceFD, buffer, sizeof(buffer));
+    if (!readAvailable()) {
+        // The consumer is behind. Leave the data in the kernel buffer until there is room.
+        m_socketNotifier->setEnabled(false);
+        QTimer::singleShot(1, this, &M8Device::resumeRead);
+    }
+    p_metrics->deviceThreadCpuNs.set(static_cast<quint64>(Metrics::threadCpuTime()));
+}
+
+/**
+ * @brief M8Device::readAvailable
+ * @return false if the receive ring is full and nothing was read
+ *
+ * Reads straight into the free slots of the receive ring, several at a time. Slots filled by the
+ * same read share its timestamp.
+ */
+bool M8Device::readAvailable()
+{
+    if (m_atEnd)
+        return true;
+
+    M8DeviceChunk *chunks[READ_BATCH];
+    int count = m_rxQueue.writeSlots(chunks, READ_BATCH);
+    if (count == 0) {
+        p_metrics->rxQueueStalls.add();
+        return false;
+    }
+
+    struct iovec iov[READ_BATCH];
+    for (int i = 0; i < count; ++i) {
+        iov[i].iov_base = chunks[i]->data;
+        iov[i].iov_len = sizeof(chunks[i]->data);
+    }
+
+    ssize_t bytesRead = m_transport->read(iov, count);
+    qint64 timestamp = Metrics::timestamp();
     M8DEVICE_D("Read " << bytesRead << " bytes");
+    p_metrics->readCalls.add();
     if (bytesRead > 0) {
-        QByteArray newData(buffer, static_cast<int>(bytesRead));
-        // M8DEVICE_D(newData);
-        emit data(newData);
+        p_metrics->bytesRead.add(static_cast<quint64>(bytesRead));
+        Recorder *recorder = p_recorder.loadAcquire();
+        int used = 0;
+        for (ssize_t left = bytesRead; left > 0; left -= MAX_READ_DATA) {
+            chunks[used]->timestamp = timestamp;
+            chunks[used]->size = static_cast<int>(qMin<ssize_t>(left, MAX_READ_DATA));
+            if (recorder)
+                recorder->record(M8_RECORD_RX, timestamp, chunks[used]->data, chunks[used]->size);
+            used++;
+        }
+        if (m_rxQueue.commitWrite(static_cast<quint32>(used)))
+            p_metrics->rxWakeups.add();
+    } else if (bytesRead == 0 || (errno != EAGAIN && errno != EINTR)) {
+        // End of file, closed connection or a device that went away
+        M8DEVICE_D("End of data on" << m_transport->name());
+        m_atEnd = true;
+        if (m_socketNotifier)
+            m_socketNotifier->setEnabled(false);
+        emit endOfData();
     }
+    return true;
+}
+
+/**
+ * @brief M8Device::atEnd
+ * @return true once the transport has reported end of data or a read error
+ */
+bool M8Device::atEnd()
+{
+    return m_atEnd;
 }
@@ -23,31 +23,81 @@ SOFTWARE.
 */
 #ifndef M8DEVICE_H
 #define M8DEVICE_H
+#include "spscqueue.h"
+#include <QAtomicPointer>
 #include <QObject>
 
+#define MAX_READ_DATA 512
+
+class IoReactor;
+class Metrics;
 class QSocketNotifier;
+class Recorder;
+class Replay;
+class Transport;
+struct iovec;
+
+/**
+ * @brief One read from the device, handed to the consumer in place
+ */
+struct M8DeviceChunk {
+    qint64 timestamp; /* CLOCK_MONOTONIC time [ns] the data was read */
+    int size;
+    char data[MAX_READ_DATA];
+};
+
+typedef SpscQueue<M8DeviceChunk, 256> M8DeviceRxQueue;
+typedef SpscQueue<QByteArray, 64> M8DeviceTxQueue;
 
 class M8Device : public QObject
 {
     Q_OBJECT
 public:
-    explicit M8Device(QString device, QObject *parent = nullptr);
+    explicit M8Device(QString device, Metrics *metrics, IoReactor *reactor = nullptr,
+                      QObject *parent = nullptr);
     ~M8Device();
 
     bool isAvailable();
+    bool usesReactor();
+    int baudRate();
+    int fd();
+    int transmitEventFd();
+    M8DeviceRxQueue *receiveQueue();
+    bool send(const QByteArray &message);
+    bool readAvailable();
+    bool atEnd();
+    bool writePending();
+    void setRecorder(Recorder *recorder);
 
 public slots:
-    void write(QByteArray message);
+    void writeQueued();
 
 signals:
-    void data(const QByteArray &message);
+    void endOfData();
 
 private slots:
     void readDeviceData();
+    void resumeRead();
+
+private:
+    void initReplay(QString source);
+    bool writeBatch(QByteArray **messages, int count);
+    bool writeAll(struct iovec *iov, int count);
 
 private:
+    Metrics *p_metrics;
+    IoReactor *p_reactor;
+    QAtomicPointer<Recorder> p_recorder;
     QSocketNotifier *m_socketNotifier;
-    int m_deviceFD;
+    QSocketNotifier *m_txNotifier;
+    QSocketNotifier *m_writeNotifier;
+    M8DeviceRxQueue m_rxQueue;
+    M8DeviceTxQueue m_txQueue;
+    Replay *m_replay;
+    Transport *m_transport;
+    QByteArray m_unsent;
+    int m_baudRate;
+    bool m_atEnd;
 };
 
 #endif // M8DEVICE_H
@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_history.h"
+
+//#define M8HISTORY_DEBUG
+#ifdef M8HISTORY_DEBUG
+#include <QDebug>
+#define M8H_D(x) qDebug() << "[M8FixHistory] " << x
+#else
+#define M8H_D(x)
+#endif
+
+#define MAX_ATTEMPTS 1000 /* Queries repeated after racing with the parser thread */
+
+/**
+ * @brief Fields of the fixes, one array each
+ */
+struct M8FixHistoryColumns {
+    QVector<qint64> timestamp;
+    QVector<double> latitude;
+    QVector<double> longitude;
+    QVector<float> altitude;
+    QVector<quint8> satellites;
+    QVector<quint8> fixType;
+    QVector<quint8> quality;
+    QVector<quint16> fields;
+    QVector<qint32> utcTimeOfDay;
+    QVector<float> height;
+    QVector<float> horizontalAccuracy;
+    QVector<float> verticalAccuracy;
+    QVector<float> velocityNorth;
+    QVector<float> velocityEast;
+    QVector<float> velocityDown;
+    QVector<float> groundSpeed;
+    QVector<float> heading;
+    QVector<float> pdop;
+    QVector<float> hdop;
+    QVector<float> vdop;
+};
+
+/**
+ * @brief M8FixHistory::M8FixHistory
+ * @param capacity Fixes kept
+ *
+ * One slot more than the capacity is allocated, rounded up to a power of two, so the fix being
+ * written never overwrites one a query may return.
+ */
+M8FixHistory::M8FixHistory(int capacity)
+    : m_columns(new M8FixHistoryColumns), m_capacity(qMax(1, capacity)), m_count(0)
+{
+    int size = 1;
+    while (size <= m_capacity)
+        size <<= 1;
+    m_mask = static_cast<quint64>(size - 1);
+
+    m_columns->timestamp.resize(size);
+    m_columns->latitude.resize(size);
+    m_columns->longitude.resize(size);
+    m_columns->altitude.resize(size);
+    m_columns->satellites.resize(size);
+    m_columns->fixType.resize(size);
+    m_columns->quality.resize(size);
+    m_columns->fields.resize(size);
+    m_columns->utcTimeOfDay.resize(size);
+    m_columns->height.resize(size);
+    m_columns->horizontalAccuracy.resize(size);
+    m_columns->verticalAccuracy.resize(size);
+    m_columns->velocityNorth.resize(size);
+    m_columns->velocityEast.resize(size);
+    m_columns->velocityDown.resize(size);
+    m_columns->groundSpeed.resize(size);
+    m_columns->heading.resize(size);
+    m_columns->pdop.resize(size);
+    m_columns->hdop.resize(size);
+    m_columns->vdop.resize(size);
+}
+
+M8FixHistory::~M8FixHistory()
+{
+    delete m_columns;
+}
+
+int M8FixHistory::capacity() const
+{
+    return m_capacity;
+}
+
+/**
+ * @brief M8FixHistory::count
+ * @return Fixes added so far, including those no longer kept
+ */
+quint64 M8FixHistory::count() const
+{
+    return __atomic_load_n(&m_count, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief M8FixHistory::latest
+ * @param fixes Most fixes to return
+ * @return The latest fixes, oldest first
+ */
+QVector<M8_FIX> M8FixHistory::latest(int fixes) const
+{
+    QVector<M8_FIX> result;
+    quint64 wanted = static_cast<quint64>(qBound(0, fixes, m_capacity));
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        quint64 last = count();
+        quint64 first = last - qMin(last, wanted);
+        if (copy(first, last, &result))
+            return result;
+    }
+    M8H_D("Gave up racing the parser thread");
+    result.clear();
+    return result;
+}
+
+/**
+ * @brief M8FixHistory::window
+ * @param from CLOCK_MONOTONIC time [ns]
+ * @param to CLOCK_MONOTONIC time [ns]
+ * @return Fixes with a timestamp in [from, to], oldest first
+ */
+QVector<M8_FIX> M8FixHistory::window(qint64 from, qint64 to) const
+{
+    QVector<M8_FIX> result;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        quint64 last = count();
+        quint64 first = last - qMin<quint64>(last, static_cast<quint64>(m_capacity));
+        quint64 begin = bound(first, last, from, false);
+        quint64 end = (to < from) ? begin : bound(begin, last, to, true);
+        // The search may have read slots written over since, not only the copied ones
+        if (copy(begin, end, &result)
+            && first + m_mask >= __atomic_load_n(&m_count, __ATOMIC_RELAXED))
+            return result;
+    }
+    M8H_D("Gave up racing the parser thread");
+    result.clear();
+    return result;
+}
+
+/**
+ * @brief M8FixHistory::fix
+ * @param fix
+ *
+ * Called on the parser thread, the only writer.
+ */
+void M8FixHistory::fix(const M8_FIX &fix)
+{
+    quint64 n = m_count;
+    int i = static_cast<int>(n & m_mask);
+    // Orders the writes below after publishing the previous fix, see copy()
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    m_columns->timestamp.data()[i] = fix.timestamp;
+    m_columns->latitude.data()[i] = fix.latitude;
+    m_columns->longitude.data()[i] = fix.longitude;
+    m_columns->altitude.data()[i] = fix.altitude;
+    m_columns->satellites.data()[i] = fix.satellites;
+    m_columns->fixType.data()[i] = fix.fixType;
+    m_columns->quality.data()[i] = fix.quality;
+    m_columns->fields.data()[i] = fix.fields;
+    m_columns->utcTimeOfDay.data()[i] = fix.utcTimeOfDay;
+    m_columns->height.data()[i] = fix.height;
+    m_columns->horizontalAccuracy.data()[i] = fix.horizontalAccuracy;
+    m_columns->verticalAccuracy.data()[i] = fix.verticalAccuracy;
+    m_columns->velocityNorth.data()[i] = fix.velocityNorth;
+    m_columns->velocityEast.data()[i] = fix.velocityEast;
+    m_columns->velocityDown.data()[i] = fix.velocityDown;
+    m_columns->groundSpeed.data()[i] = fix.groundSpeed;
+    m_columns->heading.data()[i] = fix.heading;
+    m_columns->pdop.data()[i] = fix.pdop;
+    m_columns->hdop.data()[i] = fix.hdop;
+    m_columns->vdop.data()[i] = fix.vdop;
+    __atomic_store_n(&m_count, n + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief M8FixHistory::bound
+ * @param first
+ * @param last
+ * @param timestamp
+ * @param after Find the first fix newer than timestamp instead
+ * @return Number of the first fix in [first, last) not older, or newer, than timestamp, or last
+ *
+ * Timestamps read while the slot is overwritten may be garbage, which the caller detects.
+ */
+quint64 M8FixHistory::bound(quint64 first, quint64 last, qint64 timestamp, bool after) const
+{
+    const qint64 *timestamps = m_columns->timestamp.constData();
+    while (first < last) {
+        quint64 middle = first + (last - first) / 2;
+        qint64 t = timestamps[middle & m_mask];
+        if (t < timestamp || (after && t == timestamp))
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return first;
+}
+
+/**
+ * @brief M8FixHistory::copy
+ * @param first Number of the first fix
+ * @param last Number after the last fix
+ * @param fixes Replaced by the copies
+ * @return false if the parser thread may have written over one of the fixes while copying
+ *
+ * The fix numbered count() is the only one that can be in the middle of being written. It goes
+ * to the slot of fix count() - mask - 1, which is outside the fixes a query may ask for, unless
+ * more fixes were added while copying.
+ */
+bool M8FixHistory::copy(quint64 first, quint64 last, QVector<M8_FIX> *fixes) const
+{
+    fixes->resize(static_cast<int>(last - first));
+    M8_FIX *out = fixes->data();
+    const M8FixHistoryColumns &c = *m_columns;
+    for (quint64 n = first; n < last; ++n, ++out) {
+        int i = static_cast<int>(n & m_mask);
+        out->timestamp = c.timestamp.constData()[i];
+        out->latitude = c.latitude.constData()[i];
+        out->longitude = c.longitude.constData()[i];
+        out->altitude = c.altitude.constData()[i];
+        out->satellites = c.satellites.constData()[i];
+        out->fixType = c.fixType.constData()[i];
+        out->quality = c.quality.constData()[i];
+        out->fields = c.fields.constData()[i];
+        out->utcTimeOfDay = c.utcTimeOfDay.constData()[i];
+        out->height = c.height.constData()[i];
+        out->horizontalAccuracy = c.horizontalAccuracy.constData()[i];
+        out->verticalAccuracy = c.verticalAccuracy.constData()[i];
+        out->velocityNorth = c.velocityNorth.constData()[i];
+        out->velocityEast = c.velocityEast.constData()[i];
+        out->velocityDown = c.velocityDown.constData()[i];
+        out->groundSpeed = c.groundSpeed.constData()[i];
+        out->heading = c.heading.constData()[i];
+        out->pdop = c.pdop.constData()[i];
+        out->hdop = c.hdop.constData()[i];
+        out->vdop = c.vdop.constData()[i];
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    // The fix being written now is at most the one numbered count(), in slot count() - mask - 1
+    return (first + m_mask >= __atomic_load_n(&m_count, __ATOMIC_RELAXED));
+}
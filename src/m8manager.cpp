@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_manager.h"
+#include "ioreactor.h"
+#include <QThread>
+#include <string.h>
+
+//#define M8M_DEBUG
+#ifdef M8M_DEBUG
+#include <QDebug>
+#define M8M_D(x) qDebug() << "[M8Manager] " << x
+#else
+#define M8M_D(x)
+#endif
+
+/**
+ * @brief M8Manager::M8Manager
+ * @param maxParserThreads Upper bound of parser workers, 0 for one per CPU core
+ * @param parent
+ */
+M8Manager::M8Manager(int maxParserThreads, QObject *parent)
+    : QObject(parent),
+      m_maxParserThreads((maxParserThreads > 0) ? maxParserThreads : QThread::idealThreadCount())
+{
+    m_reactor = new IoReactor();
+    m_reactor->start();
+}
+
+M8Manager::~M8Manager()
+{
+    for (M8 *receiver : m_receivers.keys())
+        delete receiver;
+    for (QThread *worker : qAsConst(m_workers)) {
+        worker->quit();
+        worker->wait();
+        delete worker;
+    }
+    m_reactor->stop();
+    delete m_reactor;
+}
+
+/**
+ * @brief M8Manager::addReceiver
+ * @param device
+ * @param configPath
+ * @return Receiver owned by the manager
+ *
+ * A new parser worker is started as long as there are fewer than the maximum, otherwise the
+ * receiver shares the worker with the fewest receivers.
+ */
+M8 *M8Manager::addReceiver(QString device, QByteArray configPath)
+{
+    QVector<int> load(m_workers.size(), 0);
+    for (int index : m_receivers.values())
+        load[index]++;
+
+    int index = load.indexOf(0);
+    if (index < 0 && m_workers.size() < qMax(m_maxParserThreads, 1)) {
+        QThread *worker = new QThread();
+        worker->setObjectName(QString("m8 parser %1").arg(m_workers.size()));
+        worker->start();
+        m_workers.append(worker);
+        index = m_workers.size() - 1;
+    } else if (index < 0) {
+        index = 0;
+        for (int i = 1; i < load.size(); ++i) {
+            if (load.at(i) < load.at(index))
+                index = i;
+        }
+    }
+
+    M8M_D("Receiver" << device << "on worker" << index);
+    M8 *receiver = new M8(device, configPath, m_reactor, m_workers.at(index), this);
+    m_receivers.insert(receiver, index);
+    return receiver;
+}
+
+void M8Manager::removeReceiver(M8 *receiver)
+{
+    if (m_receivers.remove(receiver) > 0)
+        delete receiver;
+}
+
+QList<M8 *> M8Manager::receivers()
+{
+    return m_receivers.keys();
+}
+
+int M8Manager::parserThreads()
+{
+    return m_workers.size();
+}
+
+/**
+ * @brief M8Manager::metrics
+ * @return Counters summed over all receivers
+ *
+ * The device thread CPU time is that of the shared I/O thread, and the parser thread CPU time is
+ * summed over the workers.
+ */
+M8_METRICS M8Manager::metrics()
+{
+    M8_METRICS total;
+    memset(&total, 0, sizeof(total));
+    QVector<quint64> workerCpuNs(m_workers.size(), 0);
+    for (auto it = m_receivers.constBegin(); it != m_receivers.constEnd(); ++it) {
+        M8_METRICS m = it.key()->metrics();
+        Metrics::merge(total, m);
+        // Every receiver on a worker reports the CPU time of that same thread
+        workerCpuNs[it.value()] = qMax(workerCpuNs.at(it.value()), m.parserThreadCpuNs);
+    }
+    for (quint64 cpuNs : qAsConst(workerCpuNs))
+        total.parserThreadCpuNs += cpuNs;
+    total.deviceThreadCpuNs = m_reactor->cpuNs.value();
+    return total;
+}
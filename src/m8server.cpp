@@ -0,0 +1,357 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_server.h"
+#include "ubx.h"
+#include <errno.h>
+#include <qplatformdefs.h>
+#include <QSocketNotifier>
+#include <QThread>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//#define M8SERVER_DEBUG
+#ifdef M8SERVER_DEBUG
+#include <QDebug>
+#define M8S_D(x) qDebug() << "[M8Server] " << x
+#else
+#define M8S_D(x)
+#endif
+
+#define DEFAULT_QUEUE_LIMIT (256 * 1024)
+#define MAX_CLIENT_INPUT (64 * 1024)
+#define READ_CHUNK 4096
+
+struct M8ServerClient {
+    int fd;
+    int mask; /* M8_SERVER_* */
+    QSocketNotifier *readNotifier;
+    QSocketNotifier *writeNotifier;
+    QList<QByteArray> queue; /* Frames shared with the other clients */
+    int queuedBytes;
+    int offset; /* Bytes of the first frame already written */
+    QByteArray input;
+};
+
+M8Server::M8Server(M8 *receiver, QObject *parent)
+    : QObject(parent),
+      p_receiver(receiver),
+      m_listenFd(-1),
+      m_listenNotifier(nullptr),
+      m_subscriptions(0),
+      m_queueLimit(DEFAULT_QUEUE_LIMIT),
+      m_framesSent(0),
+      m_framesDropped(0),
+      m_commandsRouted(0)
+{
+}
+
+M8Server::~M8Server()
+{
+    close();
+}
+
+/**
+ * @brief M8Server::listen
+ * @param path Socket path. An existing socket file is replaced.
+ * @return false if the socket could not be created
+ */
+bool M8Server::listen(const QString &path)
+{
+    close();
+    m_path = path.toUtf8();
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (m_path.size() >= static_cast<int>(sizeof(addr.sun_path))) {
+        qWarning("[M8Server] Socket path too long: %s", m_path.constData());
+        return false;
+    }
+    memcpy(addr.sun_path, m_path.constData(), static_cast<size_t>(m_path.size()));
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(m_path.constData());
+    if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(m_listenFd, 16) != 0) {
+        qWarning("[M8Server] Could not listen on %s", m_path.constData());
+        close();
+        return false;
+    }
+
+    m_listenNotifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_listenNotifier, &QSocketNotifier::activated, this, &M8Server::acceptClient);
+    p_receiver->addSink(this);
+    M8S_D("Listening on" << m_path);
+    return true;
+}
+
+void M8Server::close()
+{
+    if (m_listenNotifier) {
+        p_receiver->removeSink(this);
+        delete m_listenNotifier;
+        m_listenNotifier = nullptr;
+    }
+    while (!m_clients.isEmpty())
+        removeClient(m_clients.first());
+    if (m_listenFd >= 0) {
+        QT_CLOSE(m_listenFd);
+        unlink(m_path.constData());
+        m_listenFd = -1;
+    }
+}
+
+/**
+ * @brief M8Server::setClientQueueLimit
+ * @param bytes Data queued for a client before its oldest frames are dropped
+ */
+void M8Server::setClientQueueLimit(int bytes)
+{
+    m_queueLimit = bytes;
+}
+
+M8_SERVER_STATS M8Server::statistics()
+{
+    M8_SERVER_STATS stats;
+    stats.clients = static_cast<quint32>(m_clients.size());
+    stats.framesSent = m_framesSent;
+    stats.framesDropped = m_framesDropped;
+    stats.commandsRouted = m_commandsRouted;
+    return stats;
+}
+
+void M8Server::acceptClient()
+{
+    int fd;
+    while ((fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        M8ServerClient *client = new M8ServerClient;
+        client->fd = fd;
+        client->mask = M8_SERVER_NMEA;
+        client->queuedBytes = 0;
+        client->offset = 0;
+        client->readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(client->readNotifier, &QSocketNotifier::activated, this,
+                [=] { readClient(client); });
+        client->writeNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+        client->writeNotifier->setEnabled(false);
+        connect(client->writeNotifier, &QSocketNotifier::activated, this, [=] { flush(client); });
+        m_clients.append(client);
+        M8S_D("Client" << fd << "connected");
+    }
+    updateSubscriptions();
+}
+
+void M8Server::removeClient(M8ServerClient *client)
+{
+    M8S_D("Client" << client->fd << "disconnected");
+    m_clients.removeOne(client);
+    // May be called from the notifiers of the client
+    client->readNotifier->setEnabled(false);
+    client->readNotifier->deleteLater();
+    client->writeNotifier->setEnabled(false);
+    client->writeNotifier->deleteLater();
+    QT_CLOSE(client->fd);
+    delete client;
+    updateSubscriptions();
+}
+
+void M8Server::updateSubscriptions()
+{
+    int mask = 0;
+    for (const M8ServerClient *client : qAsConst(m_clients))
+        mask |= client->mask;
+    m_subscriptions.storeRelaxed(mask);
+}
+
+void M8Server::fix(const M8_FIX &fix)
+{
+    if (!(m_subscriptions.loadRelaxed() & M8_SERVER_FIX))
+        return;
+
+    QByteArray sentence = "PM8FIX," + QByteArray::number(fix.timestamp) + ','
+            + QByteArray::number(fix.latitude, 'f', 9) + ','
+            + QByteArray::number(fix.longitude, 'f', 9) + ','
+            + QByteArray::number(static_cast<double>(fix.altitude), 'f', 2) + ','
+            + QByteArray::number(fix.satellites);
+    quint8 checksum = 0;
+    for (char c : sentence)
+        checksum ^= static_cast<quint8>(c);
+    publish(M8_SERVER_FIX,
+            '$' + sentence + '*' + QByteArray::number(checksum, 16).toUpper().rightJustified(2, '0')
+                    + "\r\n");
+}
+
+/**
+ * @brief M8Server::nmea
+ * @param sentence Ends in the carriage return, only the line feed is missing
+ */
+void M8Server::nmea(const QByteArray &sentence)
+{
+    if (m_subscriptions.loadRelaxed() & M8_SERVER_NMEA)
+        publish(M8_SERVER_NMEA, sentence + '\n');
+}
+
+void M8Server::ubx(const QByteArray &frame)
+{
+    if (!(m_subscriptions.loadRelaxed() & M8_SERVER_UBX))
+        return;
+
+    QByteArray out;
+    out.reserve(frame.size() + 2);
+    out.append(static_cast<char>(0xB5));
+    out.append(0x62);
+    out.append(frame);
+    publish(M8_SERVER_UBX, out);
+}
+
+/**
+ * @brief M8Server::publish
+ * @param type
+ * @param frame Queued by reference for every subscribed client
+ *
+ * Called by the parser, which may run on another thread.
+ */
+void M8Server::publish(int type, const QByteArray &frame)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [=] { publish(type, frame); }, Qt::QueuedConnection);
+        return;
+    }
+
+    const QList<M8ServerClient *> clients = m_clients;
+    for (M8ServerClient *client : clients) {
+        if (!(client->mask & type))
+            continue;
+
+        client->queue.append(frame);
+        client->queuedBytes += frame.size();
+        while (client->queuedBytes > m_queueLimit && client->queue.size() > 1) {
+            // Keep a frame that is partly written, or the stream would be corrupted
+            int oldest = (client->offset > 0) ? 1 : 0;
+            client->queuedBytes -= client->queue.at(oldest).size();
+            client->queue.removeAt(oldest);
+            m_framesDropped++;
+        }
+        flush(client);
+    }
+}
+
+/**
+ * @brief M8Server::flush
+ * @param client
+ * @return false if the client was removed
+ */
+bool M8Server::flush(M8ServerClient *client)
+{
+    while (!client->queue.isEmpty()) {
+        const QByteArray &frame = client->queue.first();
+        ssize_t sent = send(client->fd, frame.constData() + client->offset,
+                            static_cast<size_t>(frame.size() - client->offset),
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+            client->writeNotifier->setEnabled(true);
+            return true;
+        } else if (sent < 0) {
+            removeClient(client);
+            return false;
+        }
+
+        client->offset += static_cast<int>(sent);
+        if (client->offset == frame.size()) {
+            client->queuedBytes -= frame.size();
+            client->queue.removeFirst();
+            client->offset = 0;
+            m_framesSent++;
+        }
+    }
+    client->writeNotifier->setEnabled(false);
+    return true;
+}
+
+void M8Server::readClient(M8ServerClient *client)
+{
+    char buffer[READ_CHUNK];
+    ssize_t received;
+    while ((received = recv(client->fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+        client->input.append(buffer, static_cast<int>(received));
+
+    bool closed = (0 == received) || (received < 0 && EAGAIN != errno && EWOULDBLOCK != errno);
+    if (closed || client->input.size() > MAX_CLIENT_INPUT) {
+        removeClient(client);
+        return;
+    }
+    command(client);
+}
+
+/**
+ * @brief M8Server::command
+ * @param client
+ *
+ * Handles subscriptions and routes complete UBX frames with a valid checksum to the receiver.
+ */
+void M8Server::command(M8ServerClient *client)
+{
+    QByteArray &input = client->input;
+    while (!input.isEmpty()) {
+        if (input.startsWith('$')) {
+            int end = input.indexOf('\n');
+            if (end < 0)
+                break;
+            QByteArray line = input.left(end).trimmed();
+            input.remove(0, end + 1);
+            if (line.startsWith("$PM8SUB,")) {
+                QByteArray mask = line.mid(8);
+                int star = mask.indexOf('*');
+                if (star >= 0)
+                    mask.truncate(star);
+                bool ok;
+                int subscription = mask.toInt(&ok, 16);
+                if (ok) {
+                    client->mask = subscription;
+                    updateSubscriptions();
+                }
+            }
+        } else if (input.startsWith(static_cast<char>(0xB5))) {
+            if (input.size() < 8)
+                break;
+            if (0x62 != input.at(1)) {
+                input.remove(0, 1);
+                continue;
+            }
+            int payloadLen =
+                    static_cast<quint8>(input.at(4)) | (static_cast<quint8>(input.at(5)) << 8);
+            if (input.size() < payloadLen + 8)
+                break;
+
+            QByteArray frame = input.mid(2, payloadLen + 6);
+            if (UBX::crcCheck(frame)) {
+                frame.chop(2);
+                p_receiver->sendUbxMessage(frame);
+                m_commandsRouted++;
+            }
+            input.remove(0, payloadLen + 8);
+        } else {
+            input.remove(0, 1);
+        }
+    }
+}
@@ -0,0 +1,284 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_track.h"
+#include <math.h>
+#include <string.h>
+
+//#define M8TRACK_DEBUG
+#ifdef M8TRACK_DEBUG
+#include <QDebug>
+#define M8T_D(x) qDebug() << "[M8Track] " << x
+#else
+#define M8T_D(x)
+#endif
+
+#define METRES_PER_DEGREE 111194.93 /* Along a great circle of the mean earth radius */
+#define MAX_VARINT_BYTES 10
+
+M8TrackEncoder::M8TrackEncoder(double tolerance)
+    : m_tolerance(tolerance),
+      m_started(false),
+      m_time(0),
+      m_step(0),
+      m_latitude(0),
+      m_longitude(0),
+      m_altitude(0)
+{
+    memset(&m_anchor, 0, sizeof(m_anchor));
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_window.reserve(M8_TRACK_WINDOW);
+}
+
+/**
+ * @brief M8TrackEncoder::add
+ * @param point Timestamps are expected to increase
+ */
+void M8TrackEncoder::add(const M8_TRACK_POINT &point)
+{
+    m_stats.points++;
+    if (m_tolerance <= 0 || !m_started) {
+        encode(point);
+        m_anchor = point;
+        return;
+    }
+
+    if (!m_window.isEmpty() && (m_window.size() >= M8_TRACK_WINDOW || !withinTolerance(point))) {
+        // The previous point is the furthest the line from the anchor can reach
+        m_anchor = m_window.last();
+        encode(m_anchor);
+        m_window.clear();
+    }
+    m_window.append(point);
+}
+
+void M8TrackEncoder::add(const M8_FIX &fix)
+{
+    M8_TRACK_POINT point;
+    point.timestamp = fix.timestamp;
+    point.latitude = fix.latitude;
+    point.longitude = fix.longitude;
+    point.altitude = fix.altitude;
+    add(point);
+}
+
+/**
+ * @brief M8TrackEncoder::flush
+ *
+ * Encodes the last point added, so the track is complete up to it. The points held back before
+ * it are within the tolerance of the line to it, and are dropped.
+ */
+void M8TrackEncoder::flush()
+{
+    if (m_window.isEmpty())
+        return;
+
+    m_anchor = m_window.last();
+    encode(m_anchor);
+    m_window.clear();
+}
+
+/**
+ * @brief M8TrackEncoder::takeData
+ * @return Encoded data since the last call, starting with the header on the first call
+ */
+QByteArray M8TrackEncoder::takeData()
+{
+    QByteArray data = m_data;
+    m_data.clear();
+    return data;
+}
+
+M8_TRACK_STATS M8TrackEncoder::statistics() const
+{
+    return m_stats;
+}
+
+/**
+ * @brief M8TrackEncoder::withinTolerance
+ * @param end
+ * @return true if every point in the window is within the tolerance of the line from the
+ * anchor to end
+ *
+ * Distances are measured in metres on a plane tangent at the anchor, which is accurate for the
+ * distances a window covers.
+ */
+bool M8TrackEncoder::withinTolerance(const M8_TRACK_POINT &end) const
+{
+    double scaleX = METRES_PER_DEGREE * cos(m_anchor.latitude * M_PI / 180);
+    double dx = (end.longitude - m_anchor.longitude) * scaleX;
+    double dy = (end.latitude - m_anchor.latitude) * METRES_PER_DEGREE;
+    double dz = static_cast<double>(end.altitude - m_anchor.altitude);
+    double length2 = dx * dx + dy * dy + dz * dz;
+    double tolerance2 = m_tolerance * m_tolerance;
+
+    for (const M8_TRACK_POINT &p : m_window) {
+        double px = (p.longitude - m_anchor.longitude) * scaleX;
+        double py = (p.latitude - m_anchor.latitude) * METRES_PER_DEGREE;
+        double pz = static_cast<double>(p.altitude - m_anchor.altitude);
+        double t = (length2 > 0) ? qBound(0.0, (px * dx + py * dy + pz * dz) / length2, 1.0) : 0;
+        double ex = px - t * dx;
+        double ey = py - t * dy;
+        double ez = pz - t * dz;
+        if (ex * ex + ey * ey + ez * ez > tolerance2)
+            return false;
+    }
+    return true;
+}
+
+void M8TrackEncoder::encode(const M8_TRACK_POINT &point)
+{
+    if (!m_started) {
+        m_data.append(M8_TRACK_MAGIC);
+        m_data.append(static_cast<char>(M8_TRACK_VERSION));
+        m_stats.bytes += 5;
+        m_started = true;
+    }
+
+    int before = m_data.size();
+    qint64 time = point.timestamp / 1000000;
+    qint64 latitude = qRound64(point.latitude * 1e7);
+    qint64 longitude = qRound64(point.longitude * 1e7);
+    qint64 altitude = qRound64(static_cast<double>(point.altitude) * 100);
+    qint64 step = time - m_time;
+    writeVarint(step - m_step);
+    writeVarint(latitude - m_latitude);
+    writeVarint(longitude - m_longitude);
+    writeVarint(altitude - m_altitude);
+    m_time = time;
+    m_step = step;
+    m_latitude = latitude;
+    m_longitude = longitude;
+    m_altitude = altitude;
+    m_stats.encodedPoints++;
+    m_stats.bytes += static_cast<quint64>(m_data.size() - before);
+}
+
+/**
+ * @brief M8TrackEncoder::writeVarint
+ * @param value Zigzag encoded, so small negative values are short too
+ */
+void M8TrackEncoder::writeVarint(qint64 value)
+{
+    quint64 v = (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+    while (v >= 0x80) {
+        m_data.append(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    m_data.append(static_cast<char>(v));
+}
+
+M8TrackDecoder::M8TrackDecoder()
+    : m_offset(0),
+      m_started(false),
+      m_error(false),
+      m_time(0),
+      m_step(0),
+      m_latitude(0),
+      m_longitude(0),
+      m_altitude(0)
+{
+}
+
+void M8TrackDecoder::append(const QByteArray &data)
+{
+    if (m_offset > 0 && m_offset >= m_input.size() / 2) {
+        m_input.remove(0, m_offset);
+        m_offset = 0;
+    }
+    m_input.append(data);
+}
+
+/**
+ * @brief M8TrackDecoder::next
+ * @param point
+ * @return false if more data is needed, or the data is not a track
+ */
+bool M8TrackDecoder::next(M8_TRACK_POINT *point)
+{
+    if (m_error)
+        return false;
+
+    if (!m_started) {
+        if (m_input.size() - m_offset < 5)
+            return false;
+        if (!m_input.mid(m_offset, 4).startsWith(M8_TRACK_MAGIC)
+            || M8_TRACK_VERSION != m_input.at(m_offset + 4)) {
+            M8T_D("Not a track, or a newer version");
+            m_error = true;
+            return false;
+        }
+        m_offset += 5;
+        m_started = true;
+    }
+
+    int offset = m_offset;
+    qint64 step;
+    qint64 latitude;
+    qint64 longitude;
+    qint64 altitude;
+    if (!readVarint(&offset, &step) || !readVarint(&offset, &latitude)
+        || !readVarint(&offset, &longitude) || !readVarint(&offset, &altitude))
+        return false;
+
+    m_offset = offset;
+    m_step += step;
+    m_time += m_step;
+    m_latitude += latitude;
+    m_longitude += longitude;
+    m_altitude += altitude;
+    point->timestamp = m_time * 1000000;
+    point->latitude = m_latitude * 1e-7;
+    point->longitude = m_longitude * 1e-7;
+    point->altitude = m_altitude * 0.01f;
+    return true;
+}
+
+bool M8TrackDecoder::hasError() const
+{
+    return m_error;
+}
+
+/**
+ * @brief M8TrackDecoder::readVarint
+ * @param offset Moved past the varint
+ * @param value
+ * @return false if the varint is not complete yet
+ */
+bool M8TrackDecoder::readVarint(int *offset, qint64 *value)
+{
+    quint64 v = 0;
+    for (int i = 0; i < MAX_VARINT_BYTES; ++i) {
+        if (*offset >= m_input.size())
+            return false;
+        quint8 byte = static_cast<quint8>(m_input.at((*offset)++));
+        v |= static_cast<quint64>(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            *value = static_cast<qint64>(v >> 1) ^ -static_cast<qint64>(v & 1);
+            return true;
+        }
+    }
+    M8T_D("Varint too long");
+    m_error = true;
+    return false;
+}
@@ -0,0 +1,177 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "metrics.h"
+#include <QByteArray>
+#include <QtAlgorithms>
+#include <time.h>
+
+void LatencyHistogram::add(qint64 ns)
+{
+    quint64 value = (ns > 0) ? static_cast<quint64>(ns) : 0;
+    quint64 us = value / 1000;
+    int bin = (us > 0) ? (64 - qCountLeadingZeroBits(us)) : 0;
+    m_bins[qMin(bin, M8_LATENCY_BINS - 1)].add();
+    m_count.add();
+    m_sumNs.add(value);
+    if (value > m_maxNs.value())
+        m_maxNs.set(value);
+}
+
+M8_LATENCY_HISTOGRAM LatencyHistogram::snapshot() const
+{
+    M8_LATENCY_HISTOGRAM h;
+    h.count = m_count.value();
+    h.sumNs = m_sumNs.value();
+    h.maxNs = m_maxNs.value();
+    for (int i = 0; i < M8_LATENCY_BINS; ++i)
+        h.bins[i] = m_bins[i].value();
+    return h;
+}
+
+M8_METRICS Metrics::snapshot() const
+{
+    M8_METRICS m;
+    m.bytesRead = bytesRead.value();
+    m.readCalls = readCalls.value();
+    m.bytesWritten = bytesWritten.value();
+    m.writeCalls = writeCalls.value();
+    m.writeErrors = writeErrors.value();
+    m.rxWakeups = rxWakeups.value();
+    m.rxQueueStalls = rxQueueStalls.value();
+    m.txQueueDrops = txQueueDrops.value();
+    m.recordedBytes = recordedBytes.value();
+    m.recordDrops = recordDrops.value();
+    for (int i = 0; i < M8_NMEA_MSG_TYPES; ++i)
+        m.nmeaFrames[i] = nmeaFrames[i].value();
+    for (int i = 0; i < M8_UBX_MSG_TYPES; ++i)
+        m.ubxFrames[i] = ubxFrames[i].value();
+    m.nmeaChecksumErrors = nmeaChecksumErrors.value();
+    m.ubxChecksumErrors = ubxChecksumErrors.value();
+    m.framesRecovered = framesRecovered.value();
+    m.resyncs = resyncs.value();
+    m.bytesDiscarded = bytesDiscarded.value();
+    m.messagesSent = messagesSent.value();
+    m.ackTimeouts = ackTimeouts.value();
+    m.sendQueueDepth = sendQueueDepth.value();
+    m.sendQueueMaxDepth = sendQueueMaxDepth.value();
+    m.deviceThreadCpuNs = deviceThreadCpuNs.value();
+    m.parserThreadCpuNs = parserThreadCpuNs.value();
+    for (int i = 0; i < M8_LATENCY_STAGES; ++i)
+        m.latency[i] = latency[i].snapshot();
+    return m;
+}
+
+/**
+ * @brief Metrics::merge
+ * @param total Sum of several receivers, zero initialised before the first merge
+ * @param m
+ *
+ * Thread CPU times depend on how receivers share threads, so they are left to the caller.
+ */
+void Metrics::merge(M8_METRICS &total, const M8_METRICS &m)
+{
+    total.bytesRead += m.bytesRead;
+    total.readCalls += m.readCalls;
+    total.bytesWritten += m.bytesWritten;
+    total.writeCalls += m.writeCalls;
+    total.writeErrors += m.writeErrors;
+    total.rxWakeups += m.rxWakeups;
+    total.rxQueueStalls += m.rxQueueStalls;
+    total.txQueueDrops += m.txQueueDrops;
+    total.recordedBytes += m.recordedBytes;
+    total.recordDrops += m.recordDrops;
+    for (int i = 0; i < M8_NMEA_MSG_TYPES; ++i)
+        total.nmeaFrames[i] += m.nmeaFrames[i];
+    for (int i = 0; i < M8_UBX_MSG_TYPES; ++i)
+        total.ubxFrames[i] += m.ubxFrames[i];
+    total.nmeaChecksumErrors += m.nmeaChecksumErrors;
+    total.ubxChecksumErrors += m.ubxChecksumErrors;
+    total.framesRecovered += m.framesRecovered;
+    total.resyncs += m.resyncs;
+    total.bytesDiscarded += m.bytesDiscarded;
+    total.messagesSent += m.messagesSent;
+    total.ackTimeouts += m.ackTimeouts;
+    total.sendQueueDepth += m.sendQueueDepth;
+    total.sendQueueMaxDepth = qMax(total.sendQueueMaxDepth, m.sendQueueMaxDepth);
+    for (int i = 0; i < M8_LATENCY_STAGES; ++i) {
+        M8_LATENCY_HISTOGRAM &h = total.latency[i];
+        h.count += m.latency[i].count;
+        h.sumNs += m.latency[i].sumNs;
+        h.maxNs = qMax(h.maxNs, m.latency[i].maxNs);
+        for (int j = 0; j < M8_LATENCY_BINS; ++j)
+            h.bins[j] += m.latency[i].bins[j];
+    }
+}
+
+/**
+ * @brief Metrics::timestamp
+ * @return CLOCK_MONOTONIC time [ns]
+ */
+qint64 Metrics::timestamp()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Metrics::threadCpuTime
+ * @return CPU time used by the calling thread [ns]
+ */
+qint64 Metrics::threadCpuTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+M8_NMEA_MSG Metrics::nmeaType(const QByteArray &nmea)
+{
+    if (nmea.size() >= 6 && nmea.at(3) == 'G' && nmea.at(4) == 'G' && nmea.at(5) == 'A')
+        return M8_NMEA_GGA;
+
+    return M8_NMEA_OTHER;
+}
+
+M8_UBX_MSG Metrics::ubxType(char msgClass, char msgId)
+{
+    switch (msgClass) {
+    case 0x01:
+        if (0x21 == msgId)
+            return M8_UBX_NAV_TIMEUTC;
+        if (0x35 == msgId)
+            return M8_UBX_NAV_SAT;
+        return M8_UBX_NAV_OTHER;
+    case 0x05:
+        return (0x01 == msgId) ? M8_UBX_ACK : M8_UBX_NAK;
+    case 0x06:
+        return M8_UBX_CFG;
+    case 0x0A:
+        return M8_UBX_MON;
+    case 0x13:
+        return M8_UBX_MGA;
+    default:
+        return M8_UBX_OTHER;
+    }
+}
@@ -0,0 +1,117 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QAtomicInteger>
+#include "m8_metrics.h"
+
+class QByteArray;
+
+/**
+ * @brief Counter that may be read from any thread
+ *
+ * Every counter has a single writer thread, so updates are a relaxed load and store instead of
+ * a locked read-modify-write.
+ */
+class MetricsCounter
+{
+public:
+    MetricsCounter() : m_value(0) { }
+
+    inline void add(quint64 n = 1) { m_value.storeRelaxed(m_value.loadRelaxed() + n); }
+    inline void set(quint64 value) { m_value.storeRelaxed(value); }
+    inline quint64 value() const { return m_value.loadRelaxed(); }
+
+private:
+    QAtomicInteger<quint64> m_value;
+};
+
+/**
+ * @brief Latency histogram with power of two microsecond bins
+ */
+class LatencyHistogram
+{
+public:
+    void add(qint64 ns);
+    M8_LATENCY_HISTOGRAM snapshot() const;
+
+private:
+    MetricsCounter m_count;
+    MetricsCounter m_sumNs;
+    MetricsCounter m_maxNs;
+    MetricsCounter m_bins[M8_LATENCY_BINS];
+};
+
+/**
+ * @brief Runtime counters of one receiver
+ *
+ * Counters written by the device thread are padded off the cache lines written by the control
+ * thread.
+ */
+class Metrics
+{
+public:
+    M8_METRICS snapshot() const;
+
+    static void merge(M8_METRICS &total, const M8_METRICS &m);
+    static M8_NMEA_MSG nmeaType(const QByteArray &nmea);
+    static M8_UBX_MSG ubxType(char msgClass, char msgId);
+    static qint64 timestamp();
+    static qint64 threadCpuTime();
+
+    /* Device thread */
+    MetricsCounter bytesRead;
+    MetricsCounter readCalls;
+    MetricsCounter bytesWritten;
+    MetricsCounter writeCalls;
+    MetricsCounter writeErrors;
+    MetricsCounter rxWakeups;
+    MetricsCounter rxQueueStalls;
+    MetricsCounter deviceThreadCpuNs;
+
+private:
+    char m_padding[64];
+
+public:
+    /* Control thread */
+    MetricsCounter nmeaFrames[M8_NMEA_MSG_TYPES];
+    MetricsCounter ubxFrames[M8_UBX_MSG_TYPES];
+    MetricsCounter nmeaChecksumErrors;
+    MetricsCounter ubxChecksumErrors;
+    MetricsCounter framesRecovered;
+    MetricsCounter resyncs;
+    MetricsCounter bytesDiscarded;
+    MetricsCounter messagesSent;
+    MetricsCounter ackTimeouts;
+    MetricsCounter sendQueueDepth;
+    MetricsCounter sendQueueMaxDepth;
+    MetricsCounter txQueueDrops;
+    MetricsCounter recordDrops;
+    MetricsCounter recordedBytes; /* Written by the recorder thread */
+    MetricsCounter parserThreadCpuNs;
+    LatencyHistogram latency[M8_LATENCY_STAGES];
+};
+
+#endif // METRICS_H
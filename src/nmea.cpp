@@ -22,41 +22,106 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "nmea.h"
+#include "kernels.h"
+#include "sinks.h"
+#include <string.h>
 
-NMEA::NMEA(QObject *parent) : QObject(parent) { }
+NMEA::NMEA(QObject *parent) : QObject(parent), p_sinks(nullptr) { }
 
 bool NMEA::crcCheck(const QByteArray &nmea)
 {
+    if (nmea.size() < 6 || '*' != nmea.at(nmea.size() - 4))
+        return false;
+
     bool ok;
     quint8 crcStr = static_cast<quint8>(nmea.mid(nmea.length() - 3, 2).toInt(&ok, 16));
-    if (ok) {
-        quint8 crcCalc = 0;
-        for (int i = 1; i < (nmea.size() - 4); ++i) {
-            crcCalc ^= nmea.at(i);
-        }
-        return (crcStr == crcCalc);
-    }
+    if (ok)
+        return (crcStr == Kernels::nmeaChecksum(nmea.constData() + 1, nmea.size() - 5));
     return false;
 }
 
-void NMEA::parse(const QByteArray &nmea)
+/* GGA with fix quality 0, which decodeGga() rejects */
+static bool ggaWithoutFix(const QByteArray &nmea)
+{
+    if (nmea.size() < 6 || nmea.at(3) != 'G' || nmea.at(4) != 'G' || nmea.at(5) != 'A')
+        return false;
+
+    const QList<QByteArray> nmeaFields = nmea.split(',');
+    return nmeaFields.count() >= 10 && nmeaFields.at(6).toInt() <= 0;
+}
+
+/**
+ * @brief NMEA::parse
+ * @param nmea
+ * @param timestamp CLOCK_MONOTONIC time [ns] the sentence was read from the device
+ */
+void NMEA::parse(const QByteArray &nmea, qint64 timestamp)
+{
+    M8_FIX fix;
+    if (decodeGga(nmea, &fix)) {
+        fix.timestamp = timestamp;
+        if (p_sinks)
+            p_sinks->fix(fix);
+        emit newFix(fix);
+    } else if (ggaWithoutFix(nmea)) {
+        emit fixLost(timestamp);
+    }
+}
+
+/**
+ * @brief NMEA::setFixSinks
+ * @param sinks Called with every decoded fix before any signal, or nullptr. Not owned.
+ */
+void NMEA::setFixSinks(Sinks *sinks)
+{
+    p_sinks = sinks;
+}
+
+/**
+ * @brief NMEA::decodeGga
+ * @param nmea Sentence of any type
+ * @param fix Timestamp not set
+ * @return false if the sentence is not a GGA with a fix
+ *
+ * GGA does not tell 2D from 3D fixes, so fixes with fewer than four satellites are taken as 2D.
+ */
+bool NMEA::decodeGga(const QByteArray &nmea, M8_FIX *fix)
 {
-    if (nmea.size() >= 6 && nmea.at(3) == 'G' && nmea.at(4) == 'G' && nmea.at(5) == 'A') {
-        const QList<QByteArray> nmeaFields = nmea.split(',');
-        if (nmeaFields.count() >= 10 && nmeaFields.at(6).toInt() > 0) {
-            /*          time       lat         lon
-             * $GPGGA,130153.00,5538.937814,N,01232.581883,E,1,05,1.4,61.7,M,40.5,M,,*5E
-             *    0       1          2      3       4      5 6  7   8   9  10  11 12  13
-             */
-            double latitude =
-                    (nmeaFields.at(2).left(2).toInt() + ((nmeaFields.at(2).mid(2).toDouble()) / 60))
-                    * ((nmeaFields.at(3) == "S") ? -1 : 1);
-            double longitude =
-                    (nmeaFields.at(4).left(3).toInt() + ((nmeaFields.at(4).mid(3).toDouble()) / 60))
-                    * ((nmeaFields.at(5) == "W") ? -1 : 1);
-            float altitude = nmeaFields.at(9).toFloat();
-            quint8 satellites = static_cast<quint8>(nmeaFields.at(7).toUInt());
-            emit newPosition(latitude, longitude, altitude, satellites);
-        }
+    if (nmea.size() < 6 || nmea.at(3) != 'G' || nmea.at(4) != 'G' || nmea.at(5) != 'A')
+        return false;
+
+    const QList<QByteArray> nmeaFields = nmea.split(',');
+    if (nmeaFields.count() < 10 || nmeaFields.at(6).toInt() <= 0)
+        return false;
+
+    memset(fix, 0, sizeof(*fix));
+    /*          time       lat         lon
+     * $GPGGA,130153.00,5538.937814,N,01232.581883,E,1,05,1.4,61.7,M,40.5,M,,*5E
+     *    0       1          2      3       4      5 6  7   8   9  10  11 12  13
+     */
+    fix->latitude = (nmeaFields.at(2).left(2).toInt() + ((nmeaFields.at(2).mid(2).toDouble()) / 60))
+            * ((nmeaFields.at(3) == "S") ? -1 : 1);
+    fix->longitude =
+            (nmeaFields.at(4).left(3).toInt() + ((nmeaFields.at(4).mid(3).toDouble()) / 60))
+            * ((nmeaFields.at(5) == "W") ? -1 : 1);
+    fix->altitude = nmeaFields.at(9).toFloat();
+    fix->satellites = static_cast<quint8>(nmeaFields.at(7).toUInt());
+    fix->quality = static_cast<quint8>(nmeaFields.at(6).toUInt());
+    if (M8_FIX_QUALITY_DEAD_RECKONING == fix->quality)
+        fix->fixType = M8_FIX_DEAD_RECKONING;
+    else
+        fix->fixType = (fix->satellites < 4) ? M8_FIX_2D : M8_FIX_3D;
+    fix->hdop = nmeaFields.at(8).toFloat();
+    fix->fields |= M8_FIX_HAS_HDOP;
+    const QByteArray &time = nmeaFields.at(1);
+    if (time.size() >= 6) {
+        fix->utcTimeOfDay = ((time.left(2).toInt() * 60 + time.mid(2, 2).toInt()) * 60) * 1000
+                + qRound(time.mid(4).toDouble() * 1000);
+        fix->fields |= M8_FIX_HAS_TIME;
+    }
+    if (nmeaFields.count() > 11 && !nmeaFields.at(11).isEmpty()) {
+        fix->height = fix->altitude + nmeaFields.at(11).toFloat();
+        fix->fields |= M8_FIX_HAS_HEIGHT;
     }
+    return true;
 }
@@ -25,6 +25,9 @@ SOFTWARE.
 #define NMEA_H
 
 #include <QObject>
+#include "m8_fix.h"
+
+class Sinks;
 
 class NMEA : public QObject
 {
@@ -32,11 +35,17 @@ class NMEA : public QObject
 public:
     explicit NMEA(QObject *parent = nullptr);
 
-    bool crcCheck(const QByteArray &nmea);
-    void parse(const QByteArray &nmea);
+    static bool crcCheck(const QByteArray &nmea);
+    static bool decodeGga(const QByteArray &nmea, M8_FIX *fix);
+    void parse(const QByteArray &nmea, qint64 timestamp);
+    void setFixSinks(Sinks *sinks);
 
 signals:
-    void newPosition(double latitude, double longitude, float altitude, quint8 satellites);
+    void newFix(const M8_FIX &fix);
+    void fixLost(qint64 timestamp);
+
+private:
+    Sinks *p_sinks;
 };
 
 #endif // NMEA_H
@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "ntpshm.h"
+#include "ubx.h"
+#include <atomic>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <time.h>
+
+//#define NTPSHM_DEBUG
+#ifdef NTPSHM_DEBUG
+#include <QDebug>
+#define NTPSHM_D(x) qDebug() << "[NtpShm] " << x
+#else
+#define NTPSHM_D(x)
+#endif
+
+#define NTPD_BASE 0x4E545030 /* "NTP0" */
+#define LEAP_NOWARNING 0
+#define DEFAULT_PRECISION (-20)
+
+struct shmTime {
+    int mode; /* 1: reader checks count before and after reading */
+    int count;
+    time_t clockTimeStampSec; /* Receiver time */
+    int clockTimeStampUSec;
+    time_t receiveTimeStampSec; /* Host time */
+    int receiveTimeStampUSec;
+    int leap;
+    int precision;
+    int nsamples;
+    int valid;
+    unsigned clockTimeStampNSec;
+    unsigned receiveTimeStampNSec;
+    int dummy[8];
+};
+
+/**
+ * @brief NtpShm::NtpShm
+ * @param unit Refclock unit, the segment key is NTPD_BASE + unit
+ * @param latency Time from the navigation epoch until the receiver sends NAV-TIMEUTC [ns]
+ * @param ubx Source of the samples, or nullptr when they are fed with timeSample()
+ * @param parent
+ */
+NtpShm::NtpShm(int unit, qint64 latency, UBX *ubx, QObject *parent)
+    : QObject(parent), m_shm(nullptr), m_latency(latency)
+{
+    // Units 0 and 1 are reserved for privileged processes by convention
+    int perms = (unit <= 1) ? 0600 : 0666;
+    int shmid = shmget(static_cast<key_t>(NTPD_BASE + unit), sizeof(shmTime), IPC_CREAT | perms);
+    if (shmid < 0) {
+        qWarning("[NtpShm] Could not get shared memory segment for unit %d", unit);
+        return;
+    }
+
+    void *p = shmat(shmid, nullptr, 0);
+    if (p == reinterpret_cast<void *>(-1)) {
+        qWarning("[NtpShm] Could not attach shared memory segment for unit %d", unit);
+        return;
+    }
+
+    m_shm = static_cast<shmTime *>(p);
+    m_shm->valid = 0;
+    m_shm->mode = 1;
+    m_shm->nsamples = 3;
+    m_shm->leap = LEAP_NOWARNING;
+    m_shm->precision = DEFAULT_PRECISION;
+    NTPSHM_D("Attached unit " << unit);
+
+    if (ubx) {
+        connect(ubx, &UBX::timeSample, this, &NtpShm::timeSample);
+        ubx->setTimeSubscription(true);
+    }
+}
+
+NtpShm::~NtpShm()
+{
+    if (m_shm)
+        shmdt(const_cast<shmTime *>(m_shm));
+}
+
+bool NtpShm::isAvailable()
+{
+    return (m_shm != nullptr);
+}
+
+void NtpShm::timeSample(M8_TIME_SAMPLE sample)
+{
+    if (!m_shm)
+        return;
+    if (!(sample.valid & M8_TIME_VALID_UTC)) {
+        NTPSHM_D("Skipping sample without valid UTC");
+        return;
+    }
+
+    int precision = DEFAULT_PRECISION;
+    if (sample.accuracy > 0) {
+        precision = -30; /* ~1 ns */
+        while (precision < 0 && (1000000000ULL >> -precision) < sample.accuracy)
+            ++precision;
+    }
+
+    qint64 clockSec = sample.receiverTime / 1000000000LL;
+    qint64 clockNsec = sample.receiverTime % 1000000000LL;
+    // The host time of the epoch, not of the message that reported it
+    qint64 receiveTime = sample.hostTime - m_latency;
+    qint64 receiveSec = receiveTime / 1000000000LL;
+    qint64 receiveNsec = receiveTime % 1000000000LL;
+
+    // Mode 1: readers discard the sample if count changed while they read it
+    m_shm->valid = 0;
+    m_shm->count = m_shm->count + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_shm->clockTimeStampSec = static_cast<time_t>(clockSec);
+    m_shm->clockTimeStampUSec = static_cast<int>(clockNsec / 1000);
+    m_shm->clockTimeStampNSec = static_cast<unsigned>(clockNsec);
+    m_shm->receiveTimeStampSec = static_cast<time_t>(receiveSec);
+    m_shm->receiveTimeStampUSec = static_cast<int>(receiveNsec / 1000);
+    m_shm->receiveTimeStampNSec = static_cast<unsigned>(receiveNsec);
+    m_shm->leap = LEAP_NOWARNING;
+    m_shm->precision = precision;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_shm->count = m_shm->count + 1;
+    m_shm->valid = 1;
+    NTPSHM_D("Sample offset: " << sample.offset << " ns, precision: " << precision);
+}
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef NTPSHM_H
+#define NTPSHM_H
+
+#include <QObject>
+#include "m8_time.h"
+
+struct shmTime;
+class UBX;
+
+/**
+ * @brief Feeds receiver time into an NTP shared memory refclock segment
+ *
+ * Uses the shmTime layout shared by ntpd and chrony ("refclock SHM <unit>" in chrony.conf).
+ * Samples come from a periodic UBX-NAV-TIMEUTC subscription. The receiver outputs the message
+ * some milliseconds after the navigation epoch it describes, so the receive time is moved back
+ * by a configured latency ("ntpshmlatency:" in microseconds), or chrony's offset option is used.
+ */
+class NtpShm : public QObject
+{
+    Q_OBJECT
+public:
+    NtpShm(int unit, qint64 latency, UBX *ubx, QObject *parent = nullptr);
+    ~NtpShm();
+
+    bool isAvailable();
+
+public slots:
+    void timeSample(M8_TIME_SAMPLE sample);
+
+private:
+    volatile shmTime *m_shm;
+    qint64 m_latency;
+};
+
+#endif // NTPSHM_H
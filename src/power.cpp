@@ -23,35 +23,209 @@ SOFTWARE.
 */
 #include "power.h"
 #include "config.h"
-#include "nmea.h"
 #include "ubx.h"
+#include <QTimer>
+#include <algorithm>
+#include <cstring>
 
-Power::Power(NMEA *nmea, UBX *ubx, Config *cfg, QObject *parent)
-    : QObject(parent), p_ubx(ubx), p_config(cfg), m_gnssActiveRequested(true), m_psmActive(false)
+//#define POWER_DEBUG
+#ifdef POWER_DEBUG
+#include <QDebug>
+#define POWER_D(x) qDebug() << "[Power] " << x
+#else
+#define POWER_D(x)
+#endif
+
+/* Typical user equivalent range error for converting HDOP to an accuracy estimate */
+#define UERE_M 2.5f
+#define DEFAULT_DWELL_MS 10000
+#define SATELLITE_POLL_MS 10000
+
+/**
+ * @brief Power::Power
+ * @param ubx
+ * @param cfg
+ * @param parent
+ *
+ * Fixes are not taken from a decoder here; newFix() and fixLost() are connected to the one that
+ * delivers the application's fixes.
+ */
+Power::Power(UBX *ubx, Config *cfg, QObject *parent)
+    : QObject(parent),
+      p_ubx(ubx),
+      p_config(cfg),
+      m_gnssActiveRequested(true),
+      m_policy(nullptr),
+      m_defaultPolicy(nullptr),
+      m_dwellTimeMs(DEFAULT_DWELL_MS)
+{
+    memset(&m_input, 0, sizeof(m_input));
+    m_input.horizontalAccuracy = -1;
+    m_input.requestedPeriodMs = 1000;
+    m_settings.mode = M8_POWER_CONTINUOUS;
+    m_settings.updatePeriodMs = 1000;
+    m_settings.searchPeriodMs = 10000;
+    m_settings.onTimeS = 0;
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_stats.mode = M8_POWER_CONTINUOUS;
+    m_accountTimer.start();
+    m_dwellTimer.start();
+
+    m_satelliteTimer = new QTimer(this);
+    m_satelliteTimer->setInterval(SATELLITE_POLL_MS);
+    connect(m_satelliteTimer, &QTimer::timeout, ubx, &UBX::requestSatelliteInfo);
+
+    connect(ubx, &UBX::satelliteInfo, this, &Power::satelliteInfo);
+
+    if (cfg->powerSave()) {
+        m_defaultPolicy = new M8SatelliteCountPolicy();
+        setPolicy(m_defaultPolicy);
+    }
+}
+
+Power::~Power()
 {
-    if (cfg->powerSave())
-        connect(nmea, &NMEA::newPosition, this, &Power::newPosition);
+    delete m_defaultPolicy;
 }
 
 void Power::setPower(bool on)
 {
     if (on != m_gnssActiveRequested) {
+        account();
         p_ubx->setEngineState(on);
         m_gnssActiveRequested = on;
+        emit engineStateChanged(on);
     }
 }
 
-void Power::newPosition(double latitude, double longitude, float altitude, quint8 satellites)
+/**
+ * @brief Power::setPolicy
+ * @param policy Policy to use, not owned. nullptr returns the receiver to continuous mode.
+ */
+void Power::setPolicy(M8PowerPolicy *policy)
 {
-    Q_UNUSED(latitude)
-    Q_UNUSED(longitude)
-    Q_UNUSED(altitude)
+    m_policy = policy;
+    if (m_policy && m_policy->needsSatelliteInfo()) {
+        m_satelliteTimer->start();
+    } else {
+        m_satelliteTimer->stop();
+    }
 
-    if (!m_psmActive && satellites >= 10) {
-        m_psmActive = true;
-        p_ubx->setPowerSave(true);
-    } else if (m_psmActive && satellites <= 6) {
-        m_psmActive = false;
-        p_ubx->setPowerSave(false);
+    if (!m_policy && M8_POWER_CONTINUOUS != m_settings.mode) {
+        M8_POWER_SETTINGS settings = m_settings;
+        settings.mode = M8_POWER_CONTINUOUS;
+        apply(settings);
+    }
+}
+
+void Power::setRequestedPeriod(quint32 periodMs)
+{
+    m_input.requestedPeriodMs = periodMs;
+    evaluate();
+}
+
+void Power::setDwellTime(int dwellMs)
+{
+    m_dwellTimeMs = dwellMs;
+}
+
+M8_POWER_STATS Power::statistics()
+{
+    account();
+    return m_stats;
+}
+
+/**
+ * @brief Power::horizontalAccuracy
+ * @param fix
+ * @return The receiver's accuracy estimate of a UBX fix, or one from HDOP [m], negative if unknown
+ */
+float Power::horizontalAccuracy(const M8_FIX &fix)
+{
+    if (fix.fields & M8_FIX_HAS_ACCURACY)
+        return fix.horizontalAccuracy;
+    if ((fix.fields & M8_FIX_HAS_HDOP) && fix.hdop > 0)
+        return fix.hdop * UERE_M;
+    return -1;
+}
+
+void Power::newFix(const M8_FIX &fix)
+{
+    m_input.satellites = fix.satellites;
+    m_input.horizontalAccuracy = horizontalAccuracy(fix);
+    m_input.fix = true;
+    evaluate();
+}
+
+void Power::fixLost()
+{
+    m_input.satellites = 0;
+    m_input.horizontalAccuracy = -1;
+    m_input.fix = false;
+    evaluate();
+}
+
+void Power::satelliteInfo(M8_SV_INFO info)
+{
+    QList<quint8> cno;
+    for (const M8_SV &sat : info.satellites) {
+        if (sat.cno > 0)
+            cno.append(sat.cno);
+    }
+    std::sort(cno.begin(), cno.end(), std::greater<quint8>());
+
+    m_input.trackedSatellites = static_cast<quint8>(qMin(cno.size(), 255));
+    int strongest = qMin(cno.size(), 4);
+    if (strongest > 0) {
+        int sum = 0;
+        for (int i = 0; i < strongest; ++i)
+            sum += cno.at(i);
+        m_input.meanCno = static_cast<float>(sum) / strongest;
+        m_input.minCno = cno.at(strongest - 1);
+    } else {
+        m_input.meanCno = 0;
+        m_input.minCno = 0;
+        m_input.fix = false;
+    }
+    evaluate();
+}
+
+void Power::evaluate()
+{
+    if (!m_policy || !m_gnssActiveRequested)
+        return;
+
+    M8_POWER_SETTINGS settings = m_policy->select(m_input, m_settings);
+    bool changed = settings.mode != m_settings.mode
+            || (M8_POWER_CONTINUOUS != settings.mode
+                && (settings.updatePeriodMs != m_settings.updatePeriodMs
+                    || settings.searchPeriodMs != m_settings.searchPeriodMs
+                    || settings.onTimeS != m_settings.onTimeS));
+    if (changed && m_dwellTimer.elapsed() >= m_dwellTimeMs)
+        apply(settings);
+}
+
+void Power::apply(const M8_POWER_SETTINGS &settings)
+{
+    POWER_D("Power mode " << m_settings.mode << " -> " << settings.mode << ", period "
+                          << settings.updatePeriodMs << " ms");
+    account();
+    bool modeChanged = settings.mode != m_settings.mode;
+    m_settings = settings;
+    m_stats.mode = settings.mode;
+    ++m_stats.transitions;
+    m_dwellTimer.start();
+    p_ubx->setPowerMode(settings);
+    if (modeChanged)
+        emit powerModeChange(settings.mode);
+}
+
+void Power::account()
+{
+    qint64 elapsed = m_accountTimer.restart();
+    if (m_gnssActiveRequested) {
+        m_stats.timeInModeMs[m_settings.mode] += static_cast<quint64>(elapsed);
+    } else {
+        m_stats.timeStoppedMs += static_cast<quint64>(elapsed);
     }
 }
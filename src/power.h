@@ -24,28 +24,59 @@ SOFTWARE.
 #ifndef POWER_H
 #define POWER_H
 
+#include <QElapsedTimer>
 #include <QObject>
+#include "m8_fix.h"
+#include "m8_power.h"
+#include "m8_sv_info.h"
 
 class Config;
-class NMEA;
+class QTimer;
 class UBX;
 
 class Power : public QObject
 {
     Q_OBJECT
 public:
-    explicit Power(NMEA *nmea, UBX *ubx, Config *cfg, QObject *parent = nullptr);
+    explicit Power(UBX *ubx, Config *cfg, QObject *parent = nullptr);
+    ~Power();
 
     void setPower(bool on);
+    void setPolicy(M8PowerPolicy *policy);
+    void setRequestedPeriod(quint32 periodMs);
+    void setDwellTime(int dwellMs);
+    M8_POWER_STATS statistics();
+    static float horizontalAccuracy(const M8_FIX &fix);
+
+public slots:
+    void newFix(const M8_FIX &fix);
+    void fixLost();
+
+signals:
+    void engineStateChanged(bool on);
+    void powerModeChange(M8_POWER_MODE mode);
 
 private slots:
-    void newPosition(double latitude, double longitude, float altitude, quint8 satellites);
+    void satelliteInfo(M8_SV_INFO info);
+
+private:
+    void evaluate();
+    void apply(const M8_POWER_SETTINGS &settings);
+    void account();
 
 private:
     UBX *p_ubx;
     Config *p_config;
     bool m_gnssActiveRequested;
-    bool m_psmActive;
+    M8PowerPolicy *m_policy;
+    M8SatelliteCountPolicy *m_defaultPolicy;
+    M8_POWER_INPUT m_input;
+    M8_POWER_SETTINGS m_settings;
+    M8_POWER_STATS m_stats;
+    QElapsedTimer m_accountTimer;
+    QElapsedTimer m_dwellTimer;
+    int m_dwellTimeMs;
+    QTimer *m_satelliteTimer;
 };
 
 #endif // POWER_H
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_power.h"
+
+#define CYCLIC_SEARCH_PERIOD_MS 10000
+
+M8PowerPolicy::~M8PowerPolicy() { }
+
+bool M8PowerPolicy::needsSatelliteInfo() const
+{
+    return false;
+}
+
+M8SatelliteCountPolicy::M8SatelliteCountPolicy(quint8 enterSatellites, quint8 leaveSatellites)
+    : m_enterSatellites(enterSatellites), m_leaveSatellites(leaveSatellites)
+{
+}
+
+M8_POWER_SETTINGS M8SatelliteCountPolicy::select(const M8_POWER_INPUT &input,
+                                                 const M8_POWER_SETTINGS &current)
+{
+    M8_POWER_SETTINGS settings = current;
+    if (M8_POWER_CONTINUOUS == current.mode && input.satellites >= m_enterSatellites) {
+        settings.mode = M8_POWER_CYCLIC_TRACKING;
+        settings.updatePeriodMs = 1000;
+        settings.searchPeriodMs = CYCLIC_SEARCH_PERIOD_MS;
+        settings.onTimeS = 0;
+    } else if (M8_POWER_CONTINUOUS != current.mode && input.satellites <= m_leaveSatellites) {
+        settings.mode = M8_POWER_CONTINUOUS;
+    }
+    return settings;
+}
+
+M8SignalQualityPolicy::M8SignalQualityPolicy(float enterCno, float leaveCno, float maxAccuracy,
+                                             quint32 onOffPeriodMs, quint16 onTimeS)
+    : m_enterCno(enterCno),
+      m_leaveCno(leaveCno),
+      m_maxAccuracy(maxAccuracy),
+      m_onOffPeriodMs(onOffPeriodMs),
+      m_onTimeS(onTimeS)
+{
+}
+
+M8_POWER_SETTINGS M8SignalQualityPolicy::select(const M8_POWER_INPUT &input,
+                                                const M8_POWER_SETTINGS &current)
+{
+    bool knownAccuracy = (input.horizontalAccuracy >= 0);
+    bool good = input.fix && input.meanCno >= m_enterCno && input.minCno >= m_leaveCno
+            && (!knownAccuracy || input.horizontalAccuracy <= m_maxAccuracy);
+    bool bad = !input.fix || input.meanCno < m_leaveCno
+            || (knownAccuracy && input.horizontalAccuracy > 1.5f * m_maxAccuracy);
+
+    M8_POWER_SETTINGS settings = current;
+    if ((M8_POWER_CONTINUOUS == current.mode && !good) || bad) {
+        settings.mode = M8_POWER_CONTINUOUS;
+        return settings;
+    }
+
+    settings.updatePeriodMs = qMax(input.requestedPeriodMs, static_cast<quint32>(1000));
+    if (settings.updatePeriodMs >= m_onOffPeriodMs) {
+        settings.mode = M8_POWER_ON_OFF;
+        settings.searchPeriodMs = settings.updatePeriodMs;
+        settings.onTimeS = m_onTimeS;
+    } else {
+        settings.mode = M8_POWER_CYCLIC_TRACKING;
+        settings.searchPeriodMs = CYCLIC_SEARCH_PERIOD_MS;
+        settings.onTimeS = 0;
+    }
+    return settings;
+}
+
+bool M8SignalQualityPolicy::needsSatelliteInfo() const
+{
+    return true;
+}
@@ -0,0 +1,223 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "recorder.h"
+#include <QDateTime>
+#include <QDir>
+#include <time.h>
+
+//#define RECORDER_DEBUG
+#ifdef RECORDER_DEBUG
+#include <QDebug>
+#define REC_D(x) qDebug() << "[Recorder] " << x
+#else
+#define REC_D(x)
+#endif
+
+#define FLUSH_INTERVAL_MS 100
+#define WAKE_BYTES (64 * 1024)
+#define MAX_PENDING_BYTES (8 * 1024 * 1024)
+
+/**
+ * @brief Recorder::Recorder
+ * @param directory Created if missing
+ * @param maxFileBytes Size that starts a new file, 0 for no limit
+ * @param maxFileMs Age that starts a new file, 0 for no limit
+ * @param baudRate Stored in the file headers
+ * @param metrics
+ * @param parent
+ */
+Recorder::Recorder(QString directory, qint64 maxFileBytes, qint64 maxFileMs, int baudRate,
+                   Metrics *metrics, QObject *parent)
+    : QThread(parent),
+      p_metrics(metrics),
+      m_directory(directory),
+      m_maxFileBytes(maxFileBytes),
+      m_maxFileMs(maxFileMs),
+      m_baudRate(static_cast<quint32>(baudRate)),
+      m_stop(false),
+      m_fileStart(0),
+      m_lastIndexTimestamp(0),
+      m_lastIndexOffset(0)
+{
+    setObjectName("m8 recorder");
+    if (!QDir().mkpath(m_directory))
+        qWarning("[Recorder] Could not create %s", m_directory.toUtf8().constData());
+    m_pending.reserve(WAKE_BYTES * 2);
+}
+
+Recorder::~Recorder()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stop = true;
+        m_wake.wakeOne();
+    }
+    wait();
+}
+
+/**
+ * @brief Recorder::record
+ * @param direction
+ * @param timestamp CLOCK_MONOTONIC time [ns]
+ * @param data
+ * @param size
+ *
+ * Chunks are dropped while the writer is more than MAX_PENDING_BYTES behind.
+ */
+void Recorder::record(M8_RECORD_DIRECTION direction, qint64 timestamp, const char *data, int size)
+{
+    M8_RECORD_CHUNK chunk;
+    chunk.timestamp = timestamp;
+    chunk.size = static_cast<quint32>(size);
+    chunk.direction = static_cast<quint8>(direction);
+    chunk.reserved[0] = chunk.reserved[1] = chunk.reserved[2] = 0;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.size() + size > MAX_PENDING_BYTES) {
+        p_metrics->recordDrops.add();
+        return;
+    }
+    m_pending.append(reinterpret_cast<const char *>(&chunk), sizeof(chunk));
+    m_pending.append(data, size);
+    if (m_pending.size() >= WAKE_BYTES)
+        m_wake.wakeOne();
+}
+
+void Recorder::run()
+{
+    QByteArray batch;
+    batch.reserve(WAKE_BYTES * 2);
+    bool stop = false;
+    while (!stop) {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.size() < WAKE_BYTES && !m_stop)
+                m_wake.wait(&m_mutex, FLUSH_INTERVAL_MS);
+            batch.swap(m_pending);
+            stop = m_stop;
+        }
+        if (!batch.isEmpty()) {
+            writeBatch(batch);
+            batch.resize(0);
+        }
+    }
+    closeFile();
+}
+
+/**
+ * @brief Recorder::writeBatch
+ * @param batch Chunks as queued by record()
+ *
+ * Rotates before the first chunk that exceeds the limits and indexes chunks as it goes. When no
+ * file can be opened, the rest of the batch is counted as dropped.
+ */
+void Recorder::writeBatch(const QByteArray &batch)
+{
+    const char *data = batch.constData();
+    int position = 0;
+    while (position + static_cast<int>(sizeof(M8_RECORD_CHUNK)) <= batch.size()) {
+        M8_RECORD_CHUNK chunk;
+        memcpy(&chunk, data + position, sizeof(chunk));
+        int length = static_cast<int>(sizeof(chunk) + chunk.size);
+
+        bool rotate = !m_file.isOpen()
+                || (m_maxFileBytes > 0 && m_file.pos() + length > m_maxFileBytes)
+                || (m_maxFileMs > 0 && chunk.timestamp - m_fileStart >= m_maxFileMs * 1000000);
+        if (rotate && !openFile(chunk.timestamp)) {
+            while (position + static_cast<int>(sizeof(M8_RECORD_CHUNK)) <= batch.size()) {
+                memcpy(&chunk, data + position, sizeof(chunk));
+                position += static_cast<int>(sizeof(chunk) + chunk.size);
+                p_metrics->recordDrops.add();
+            }
+            return;
+        }
+
+        qint64 offset = m_file.pos();
+        if (chunk.timestamp - m_lastIndexTimestamp >= M8_RECORD_INDEX_INTERVAL_MS * 1000000LL
+            || offset - m_lastIndexOffset >= M8_RECORD_INDEX_INTERVAL_BYTES
+            || offset == static_cast<qint64>(sizeof(M8_RECORD_HEADER))) {
+            M8_RECORD_INDEX_ENTRY entry;
+            entry.timestamp = chunk.timestamp;
+            entry.offset = static_cast<quint64>(offset);
+            m_index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            m_lastIndexTimestamp = chunk.timestamp;
+            m_lastIndexOffset = offset;
+        }
+
+        m_file.write(data + position, length);
+        p_metrics->recordedBytes.add(static_cast<quint64>(length));
+        position += length;
+    }
+    m_file.flush();
+    m_index.flush();
+}
+
+bool Recorder::openFile(qint64 timestamp)
+{
+    closeFile();
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    qint64 realtime = static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    realtime -= Metrics::timestamp() - timestamp;
+
+    QString base = m_directory + "/m8-"
+            + QDateTime::fromMSecsSinceEpoch(realtime / 1000000, Qt::UTC)
+                      .toString("yyyyMMdd-hhmmss-zzz");
+    m_file.setFileName(base + ".m8rec");
+    m_index.setFileName(base + ".m8idx");
+    if (!m_file.open(QIODevice::WriteOnly) || !m_index.open(QIODevice::WriteOnly)) {
+        qWarning("[Recorder] Could not create %s", base.toUtf8().constData());
+        closeFile();
+        return false;
+    }
+    REC_D("Recording to" << base);
+
+    M8_RECORD_HEADER header;
+    header.magic = M8_RECORD_MAGIC;
+    header.version = M8_RECORD_VERSION;
+    header.headerSize = sizeof(header);
+    header.startTimestamp = timestamp;
+    header.startRealtime = realtime;
+    header.baudRate = m_baudRate;
+    header.reserved = 0;
+    m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    M8_RECORD_INDEX_HEADER indexHeader;
+    indexHeader.magic = M8_RECORD_INDEX_MAGIC;
+    indexHeader.version = M8_RECORD_VERSION;
+    indexHeader.reserved = 0;
+    m_index.write(reinterpret_cast<const char *>(&indexHeader), sizeof(indexHeader));
+
+    m_fileStart = timestamp;
+    return true;
+}
+
+void Recorder::closeFile()
+{
+    if (m_file.isOpen())
+        m_file.close();
+    if (m_index.isOpen())
+        m_index.close();
+}
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "m8_record.h"
+#include "metrics.h"
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+/**
+ * @brief Appends the raw receiver stream to rotating files in the format of m8_record.h
+ *
+ * record() only copies the chunk into a pending buffer. A writer thread takes the whole buffer
+ * every flush interval, or earlier when it grows large, and writes it out.
+ */
+class Recorder : public QThread
+{
+    Q_OBJECT
+public:
+    explicit Recorder(QString directory, qint64 maxFileBytes, qint64 maxFileMs, int baudRate,
+                      Metrics *metrics, QObject *parent = nullptr);
+    ~Recorder();
+
+    void record(M8_RECORD_DIRECTION direction, qint64 timestamp, const char *data, int size);
+
+protected:
+    void run() override;
+
+private:
+    void writeBatch(const QByteArray &batch);
+    bool openFile(qint64 timestamp);
+    void closeFile();
+
+private:
+    Metrics *p_metrics;
+    QString m_directory;
+    qint64 m_maxFileBytes;
+    qint64 m_maxFileMs;
+    quint32 m_baudRate;
+
+    // Shared with the producers
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QByteArray m_pending;
+    bool m_stop;
+
+    // Writer thread
+    QFile m_file;
+    QFile m_index;
+    qint64 m_fileStart;
+    qint64 m_lastIndexTimestamp;
+    qint64 m_lastIndexOffset;
+};
+
+#endif // RECORDER_H
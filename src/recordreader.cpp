@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "recordreader.h"
+#include <algorithm>
+
+//#define RECORDREADER_DEBUG
+#ifdef RECORDREADER_DEBUG
+#include <QDebug>
+#define RR_D(x) qDebug() << "[RecordReader] " << x
+#else
+#define RR_D(x)
+#endif
+
+RecordReader::RecordReader(const QString &path) : m_file(path)
+{
+    memset(&m_header, 0, sizeof(m_header));
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+
+    if (m_file.read(reinterpret_cast<char *>(&m_header), sizeof(m_header)) != sizeof(m_header)
+        || M8_RECORD_MAGIC != m_header.magic || M8_RECORD_VERSION != m_header.version) {
+        qWarning("[RecordReader] Not a recording: %s", path.toUtf8().constData());
+        m_file.close();
+        return;
+    }
+    m_file.seek(m_header.headerSize);
+
+    // Without an index, seeking scans from the start
+    QString indexPath = path;
+    if (indexPath.endsWith(".m8rec"))
+        indexPath.chop(6);
+    QFile index(indexPath + ".m8idx");
+    M8_RECORD_INDEX_HEADER indexHeader;
+    if (index.open(QIODevice::ReadOnly)
+        && index.read(reinterpret_cast<char *>(&indexHeader), sizeof(indexHeader))
+                == sizeof(indexHeader)
+        && M8_RECORD_INDEX_MAGIC == indexHeader.magic) {
+        QByteArray entries = index.readAll();
+        int count = entries.size() / static_cast<int>(sizeof(M8_RECORD_INDEX_ENTRY));
+        m_index.resize(count);
+        memcpy(m_index.data(), entries.constData(),
+               static_cast<size_t>(count) * sizeof(M8_RECORD_INDEX_ENTRY));
+    }
+    RR_D(path << "with" << m_index.size() << "index entries");
+}
+
+bool RecordReader::isOpen()
+{
+    return m_file.isOpen();
+}
+
+const M8_RECORD_HEADER &RecordReader::header()
+{
+    return m_header;
+}
+
+/**
+ * @brief RecordReader::seek
+ * @param timestamp CLOCK_MONOTONIC time of the recording [ns]
+ * @return false if no chunk is at or after the time
+ *
+ * Positions the reader at the first chunk at or after the time.
+ */
+bool RecordReader::seek(qint64 timestamp)
+{
+    if (!isOpen())
+        return false;
+
+    auto after = std::upper_bound(m_index.constBegin(), m_index.constEnd(), timestamp,
+                                  [](qint64 t, const M8_RECORD_INDEX_ENTRY &entry) {
+                                      return t < entry.timestamp;
+                                  });
+    qint64 offset = m_header.headerSize;
+    if (after != m_index.constBegin())
+        offset = static_cast<qint64>((after - 1)->offset);
+    m_file.seek(offset);
+
+    M8_RECORD_CHUNK chunk;
+    while (readChunkHeader(&chunk)) {
+        if (chunk.timestamp >= timestamp) {
+            m_file.seek(m_file.pos() - static_cast<qint64>(sizeof(chunk)));
+            return true;
+        }
+        m_file.seek(m_file.pos() + chunk.size);
+    }
+    return false;
+}
+
+/**
+ * @brief RecordReader::next
+ * @param chunk
+ * @param data Replaced by the chunk data
+ * @return false at the end of the file or on a truncated chunk
+ */
+bool RecordReader::next(M8_RECORD_CHUNK *chunk, QByteArray *data)
+{
+    if (!isOpen() || !readChunkHeader(chunk))
+        return false;
+
+    data->resize(static_cast<int>(chunk->size));
+    return (m_file.read(data->data(), chunk->size) == chunk->size);
+}
+
+bool RecordReader::readChunkHeader(M8_RECORD_CHUNK *chunk)
+{
+    return (m_file.read(reinterpret_cast<char *>(chunk), sizeof(*chunk)) == sizeof(*chunk));
+}
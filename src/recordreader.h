@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef RECORDREADER_H
+#define RECORDREADER_H
+
+#include "m8_record.h"
+#include <QFile>
+#include <QVector>
+
+/**
+ * @brief Reads one .m8rec file, using its .m8idx file to seek by time
+ */
+class RecordReader
+{
+public:
+    explicit RecordReader(const QString &path);
+
+    bool isOpen();
+    const M8_RECORD_HEADER &header();
+    bool seek(qint64 timestamp);
+    bool next(M8_RECORD_CHUNK *chunk, QByteArray *data);
+
+private:
+    bool readChunkHeader(M8_RECORD_CHUNK *chunk);
+
+private:
+    QFile m_file;
+    M8_RECORD_HEADER m_header;
+    QVector<M8_RECORD_INDEX_ENTRY> m_index;
+};
+
+#endif // RECORDREADER_H
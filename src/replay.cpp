@@ -0,0 +1,190 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "replay.h"
+#include "metrics.h"
+#include "recorder.h"
+#include "recordreader.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QTimer>
+
+//#define REPLAY_DEBUG
+#ifdef REPLAY_DEBUG
+#include <QDebug>
+#define REPLAY_D(x) qDebug() << "[Replay] " << x
+#else
+#define REPLAY_D(x)
+#endif
+
+#define STALL_RETRY_MS 1
+
+Replay::Replay(QString source, M8DeviceRxQueue *queue, Metrics *metrics, QObject *parent)
+    : QObject(parent),
+      p_queue(queue),
+      p_metrics(metrics),
+      p_recorder(nullptr),
+      m_reader(nullptr),
+      m_speed(1.0),
+      m_baudRate(0),
+      m_start(0),
+      m_firstTimestamp(-1),
+      m_offset(0),
+      m_pending(false)
+{
+    int at = source.lastIndexOf('@');
+    if (at >= 0) {
+        m_speed = qMax(source.mid(at + 1).toDouble(), 0.0);
+        source = source.left(at);
+    }
+
+    QFileInfo info(source);
+    if (info.isDir()) {
+        QDir dir(source);
+        for (const QString &name : dir.entryList(QStringList("*.m8rec"), QDir::Files, QDir::Name))
+            m_files.append(dir.filePath(name));
+    } else if (info.exists()) {
+        m_files.append(source);
+    }
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &Replay::feed);
+    if (openNext()) {
+        m_baudRate = static_cast<int>(m_reader->header().baudRate);
+        m_timer->start(0);
+    } else {
+        qWarning("[Replay] No recording at %s", source.toUtf8().constData());
+    }
+}
+
+Replay::~Replay()
+{
+    delete m_reader;
+}
+
+bool Replay::isAvailable()
+{
+    return (m_reader != nullptr);
+}
+
+/**
+ * @brief Replay::baudRate
+ * @return Baud rate of the recorded device, 0 if unknown
+ */
+int Replay::baudRate()
+{
+    return m_baudRate;
+}
+
+/**
+ * @brief Replay::setRecorder
+ * @param recorder Gets every chunk as it is delivered, or nullptr
+ */
+void Replay::setRecorder(Recorder *recorder)
+{
+    p_recorder.storeRelease(recorder);
+}
+
+/**
+ * @brief Replay::feed
+ *
+ * Delivers every chunk that is due, and schedules itself for the next one.
+ */
+void Replay::feed()
+{
+    while (m_pending || readNext()) {
+        qint64 now = Metrics::timestamp();
+        if (m_firstTimestamp < 0) {
+            m_firstTimestamp = m_chunk.timestamp;
+            m_start = now;
+        }
+        if (m_speed > 0) {
+            qint64 due = m_start
+                    + static_cast<qint64>((m_chunk.timestamp - m_firstTimestamp) / m_speed);
+            if (due > now) {
+                m_timer->start(static_cast<int>((due - now + 999999) / 1000000));
+                return;
+            }
+        }
+
+        // Recorded chunks may be larger than the slots when they come from other transports
+        while (m_offset < m_data.size()) {
+            M8DeviceChunk *slot = p_queue->writeSlot();
+            if (!slot) {
+                p_metrics->rxQueueStalls.add();
+                m_timer->start(STALL_RETRY_MS);
+                return;
+            }
+            int size = qMin(m_data.size() - m_offset, MAX_READ_DATA);
+            memcpy(slot->data, m_data.constData() + m_offset, static_cast<size_t>(size));
+            slot->size = size;
+            slot->timestamp = Metrics::timestamp();
+            if (Recorder *recorder = p_recorder.loadAcquire())
+                recorder->record(M8_RECORD_RX, slot->timestamp, slot->data, size);
+            p_metrics->readCalls.add();
+            p_metrics->bytesRead.add(static_cast<quint64>(size));
+            if (p_queue->commitWrite())
+                p_metrics->rxWakeups.add();
+            m_offset += size;
+        }
+        m_pending = false;
+    }
+
+    REPLAY_D("Replay finished");
+    emit finished();
+}
+
+/**
+ * @brief Replay::readNext
+ * @return false when all files are played
+ */
+bool Replay::readNext()
+{
+    while (m_reader) {
+        if (m_reader->next(&m_chunk, &m_data)) {
+            if (M8_RECORD_RX != m_chunk.direction)
+                continue;
+            m_offset = 0;
+            m_pending = true;
+            return true;
+        }
+        openNext();
+    }
+    return false;
+}
+
+bool Replay::openNext()
+{
+    delete m_reader;
+    m_reader = nullptr;
+    while (!m_files.isEmpty()) {
+        RecordReader *reader = new RecordReader(m_files.takeFirst());
+        if (reader->isOpen()) {
+            m_reader = reader;
+            return true;
+        }
+        delete reader;
+    }
+    return false;
+}
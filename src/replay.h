@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "m8_record.h"
+#include "m8device.h"
+#include <QObject>
+#include <QAtomicPointer>
+#include <QStringList>
+
+class Metrics;
+class Recorder;
+class QTimer;
+class RecordReader;
+
+/**
+ * @brief Feeds a recording into a receive ring in place of a device
+ *
+ * The source is "<path>[@<speed>]", where path is a .m8rec file or a directory of them, played
+ * in name order. Chunks are delivered at the recorded pace divided by speed, which defaults to 1.
+ * A speed of 0 delivers them as fast as the consumer drains the ring. Only received data is
+ * replayed.
+ */
+class Replay : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Replay(QString source, M8DeviceRxQueue *queue, Metrics *metrics,
+                    QObject *parent = nullptr);
+    ~Replay();
+
+    bool isAvailable();
+    int baudRate();
+    void setRecorder(Recorder *recorder);
+
+signals:
+    void finished();
+
+private slots:
+    void feed();
+
+private:
+    bool readNext();
+    bool openNext();
+
+private:
+    M8DeviceRxQueue *p_queue;
+    Metrics *p_metrics;
+    QAtomicPointer<Recorder> p_recorder;
+    QStringList m_files;
+    RecordReader *m_reader;
+    QTimer *m_timer;
+    double m_speed;
+    int m_baudRate;
+    qint64 m_start; /* When the first chunk was delivered [ns] */
+    qint64 m_firstTimestamp; /* Recorded time of the first chunk [ns] */
+    M8_RECORD_CHUNK m_chunk;
+    QByteArray m_data;
+    int m_offset; /* Bytes of m_data already delivered */
+    bool m_pending;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,259 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "scheduler.h"
+#include "power.h"
+#include "ttff.h"
+#include <QTimer>
+#include <climits>
+#include <cstring>
+
+//#define SCHED_DEBUG
+#ifdef SCHED_DEBUG
+#include <QDebug>
+#define SCHED_D(x) qDebug() << "[Scheduler] " << x
+#else
+#define SCHED_D(x)
+#endif
+
+/* Expected time to first fix before any has been measured */
+#define DEFAULT_TTFF_MS 30000
+
+/* Longest wait that consecutive misses back off to, unless the interval itself is longer */
+#define MAX_BACKOFF_MS (24 * 60 * 60 * 1000LL)
+
+/**
+ * @brief Scheduler::Scheduler
+ * @param power
+ * @param ttff
+ * @param parent
+ *
+ * newFix() is connected to the decoder that delivers the application's fixes.
+ */
+Scheduler::Scheduler(Power *power, TTFF *ttff, QObject *parent)
+    : QObject(parent),
+      p_power(power),
+      p_ttff(ttff),
+      m_deadlineMs(0),
+      m_wakeMs(0),
+      m_timeoutMs(0),
+      m_active(false),
+      m_attempting(false)
+{
+    memset(&m_schedule, 0, sizeof(m_schedule));
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_stats.lastTimeToFixMs = -1;
+
+    m_wakeTimer = new QTimer(this);
+    m_wakeTimer->setSingleShot(true);
+    m_wakeTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_wakeTimer, &QTimer::timeout, this, &Scheduler::wake);
+    m_timeoutTimer = new QTimer(this);
+    m_timeoutTimer->setSingleShot(true);
+    m_timeoutTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &Scheduler::timeout);
+}
+
+/**
+ * @brief Scheduler::setSchedule
+ * @param schedule
+ *
+ * The first deadline is one interval from now. The engine is stopped until then.
+ */
+void Scheduler::setSchedule(const M8_FIX_SCHEDULE &schedule)
+{
+    clear();
+    m_schedule = schedule;
+    m_schedule.intervalS = qMax(m_schedule.intervalS, static_cast<quint32>(1));
+    m_active = true;
+    m_stats.consecutiveMisses = 0;
+    m_clock.start();
+    SCHED_D("Schedule every " << m_schedule.intervalS << " s");
+    scheduleNext(m_schedule.intervalS * 1000LL);
+}
+
+/**
+ * @brief Scheduler::clear
+ *
+ * Stops scheduling and leaves the engine in its current state.
+ */
+void Scheduler::clear()
+{
+    if (m_attempting)
+        m_stats.engineOnMs += static_cast<quint64>(m_onTimer.elapsed());
+
+    m_active = false;
+    m_attempting = false;
+    m_wakeTimer->stop();
+    m_timeoutTimer->stop();
+}
+
+bool Scheduler::isActive()
+{
+    return m_active;
+}
+
+M8_SCHEDULE_STATS Scheduler::statistics()
+{
+    M8_SCHEDULE_STATS stats = m_stats;
+    if (m_attempting)
+        stats.engineOnMs += static_cast<quint64>(m_onTimer.elapsed());
+    return stats;
+}
+
+void Scheduler::wake()
+{
+    if (!m_active || m_attempting)
+        return;
+
+    qint64 wakeIn = m_wakeMs - m_clock.elapsed();
+    if (wakeIn > 0) {
+        armTimer(m_wakeTimer, wakeIn);
+        return;
+    }
+
+    SCHED_D("Starting engine " << (m_deadlineMs - m_clock.elapsed()) << " ms before deadline");
+    m_attempting = true;
+    ++m_stats.attempts;
+    m_onTimer.start();
+    m_timeoutMs = m_deadlineMs + m_schedule.timeoutS * 1000LL;
+    armTimer(m_timeoutTimer, m_timeoutMs - m_clock.elapsed());
+    p_power->setPower(true);
+}
+
+void Scheduler::timeout()
+{
+    if (!m_attempting)
+        return;
+
+    qint64 timeoutIn = m_timeoutMs - m_clock.elapsed();
+    if (timeoutIn > 0)
+        armTimer(m_timeoutTimer, timeoutIn);
+    else
+        finish(false);
+}
+
+void Scheduler::newFix(const M8_FIX &fix)
+{
+    if (!m_attempting)
+        return;
+
+    float accuracy = Power::horizontalAccuracy(fix);
+    if (m_schedule.accuracyM <= 0 || (accuracy >= 0 && accuracy <= m_schedule.accuracyM))
+        finish(true);
+}
+
+/**
+ * @brief Scheduler::leadTimeMs
+ * @return How long before a deadline to start the engine
+ *
+ * Uses the mean measured time to first fix of the most assisted start type seen, with half of it
+ * again as headroom for reaching the accuracy.
+ */
+qint64 Scheduler::leadTimeMs()
+{
+    M8_TTFF_STATS ttff = p_ttff->statistics();
+    qint64 expected = DEFAULT_TTFF_MS;
+    for (int type = M8_START_HOT; type >= M8_START_COLD; --type) {
+        if (ttff.firstFix[type].count > 0) {
+            expected = static_cast<qint64>(ttff.firstFix[type].sumMs / ttff.firstFix[type].count);
+            break;
+        }
+    }
+
+    qint64 lead = expected + expected / 2 + m_schedule.marginS * 1000LL;
+    return qMin(lead, m_schedule.intervalS * 1000LL);
+}
+
+void Scheduler::scheduleNext(qint64 deadlineMs)
+{
+    m_deadlineMs = deadlineMs;
+    m_wakeMs = m_deadlineMs - leadTimeMs();
+    qint64 wakeIn = m_wakeMs - m_clock.elapsed();
+    SCHED_D("Next deadline in " << (m_deadlineMs - m_clock.elapsed()) << " ms, wake in " << wakeIn
+                                << " ms");
+    if (wakeIn > 0) {
+        p_power->setPower(false);
+        armTimer(m_wakeTimer, wakeIn);
+    } else {
+        wake();
+    }
+}
+
+/**
+ * @brief Scheduler::finish
+ * @param success
+ *
+ * Successes keep the cadence of deadlines. Each consecutive miss doubles the wait before the next
+ * attempt, up to 2^maxBackoff intervals and no longer than MAX_BACKOFF_MS or one interval.
+ */
+void Scheduler::finish(bool success)
+{
+    m_attempting = false;
+    m_timeoutTimer->stop();
+    qint64 onTime = m_onTimer.elapsed();
+    m_stats.engineOnMs += static_cast<quint64>(onTime);
+    p_power->setPower(false);
+
+    qint64 now = m_clock.elapsed();
+    qint64 interval = m_schedule.intervalS * 1000LL;
+    qint64 next;
+    if (success) {
+        ++m_stats.fixes;
+        if (now > m_deadlineMs)
+            ++m_stats.late;
+        m_stats.consecutiveMisses = 0;
+        m_stats.lastTimeToFixMs = onTime;
+        next = m_deadlineMs + interval;
+        while (next - leadTimeMs() <= now)
+            next += interval;
+    } else {
+        ++m_stats.missed;
+        ++m_stats.consecutiveMisses;
+        // Doubled step by step, so the wait saturates instead of shifting out of range
+        quint32 doublings = qMin(m_stats.consecutiveMisses,
+                                 static_cast<quint32>(m_schedule.maxBackoff));
+        qint64 wait = interval;
+        for (quint32 i = 0; i < doublings && wait < MAX_BACKOFF_MS; ++i)
+            wait *= 2;
+        next = now + qMax(interval, qMin(wait, MAX_BACKOFF_MS));
+    }
+    SCHED_D((success ? "Fix after " : "Missed after ") << onTime << " ms");
+    emit scheduledFix(success);
+    if (m_active)
+        scheduleNext(next);
+}
+
+/**
+ * @brief Scheduler::armTimer
+ * @param timer
+ * @param ms
+ *
+ * QTimer takes an int, so waits longer than INT_MAX ms are cut short and the slot re-arms the
+ * timer until the real time is reached.
+ */
+void Scheduler::armTimer(QTimer *timer, qint64 ms)
+{
+    timer->start(static_cast<int>(qBound(static_cast<qint64>(0), ms,
+                                         static_cast<qint64>(INT_MAX))));
+}
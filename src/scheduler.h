@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include "m8_fix.h"
+#include "m8_schedule.h"
+
+class Power;
+class QTimer;
+class TTFF;
+
+class Scheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Scheduler(Power *power, TTFF *ttff, QObject *parent = nullptr);
+
+    void setSchedule(const M8_FIX_SCHEDULE &schedule);
+    void clear();
+    bool isActive();
+    M8_SCHEDULE_STATS statistics();
+
+public slots:
+    void newFix(const M8_FIX &fix);
+
+signals:
+    void scheduledFix(bool success);
+
+private slots:
+    void wake();
+    void timeout();
+
+private:
+    qint64 leadTimeMs();
+    void scheduleNext(qint64 deadlineMs);
+    void finish(bool success);
+    static void armTimer(QTimer *timer, qint64 ms);
+
+private:
+    Power *p_power;
+    TTFF *p_ttff;
+    M8_FIX_SCHEDULE m_schedule;
+    M8_SCHEDULE_STATS m_stats;
+    QTimer *m_wakeTimer;
+    QTimer *m_timeoutTimer;
+    QElapsedTimer m_clock;
+    QElapsedTimer m_onTimer;
+    qint64 m_deadlineMs;
+    qint64 m_wakeMs;
+    qint64 m_timeoutMs;
+    bool m_active;
+    bool m_attempting;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "shmpublisher.h"
+#include "metrics.h"
+#include <sys/stat.h>
+
+//#define SHMPUBLISHER_DEBUG
+#ifdef SHMPUBLISHER_DEBUG
+#include <QDebug>
+#define SHMP_D(x) qDebug() << "[ShmPublisher] " << x
+#else
+#define SHMP_D(x)
+#endif
+
+ShmPublisher::ShmPublisher(const QByteArray &name) : m_name(name), m_segment(nullptr)
+{
+    int fd = shm_open(m_name.constData(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        qWarning("[ShmPublisher] Could not open %s", m_name.constData());
+        return;
+    }
+
+    void *mem = MAP_FAILED;
+    if (ftruncate(fd, sizeof(M8_SHM_SEGMENT)) == 0)
+        mem = mmap(nullptr, sizeof(M8_SHM_SEGMENT), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mem) {
+        qWarning("[ShmPublisher] Could not map %s", m_name.constData());
+        shm_unlink(m_name.constData());
+        return;
+    }
+
+    // Readers only trust the segment once the magic is set, after everything else
+    m_segment = static_cast<M8_SHM_SEGMENT *>(mem);
+    __atomic_store_n(&m_segment->magic, 0, __ATOMIC_RELEASE);
+    memset(static_cast<void *>(m_segment), 0, sizeof(M8_SHM_SEGMENT));
+    m_segment->version = M8_SHM_VERSION;
+    m_segment->size = sizeof(M8_SHM_SEGMENT);
+    m_segment->fixSlots = M8_SHM_FIX_SLOTS;
+    __atomic_store_n(&m_segment->magic, M8_SHM_MAGIC, __ATOMIC_RELEASE);
+    SHMP_D("Publishing" << sizeof(M8_SHM_SEGMENT) << "bytes at" << m_name);
+}
+
+ShmPublisher::~ShmPublisher()
+{
+    if (m_segment) {
+        __atomic_store_n(&m_segment->magic, 0, __ATOMIC_RELEASE);
+        munmap(m_segment, sizeof(M8_SHM_SEGMENT));
+        shm_unlink(m_name.constData());
+    }
+}
+
+bool ShmPublisher::isAvailable()
+{
+    return (m_segment != nullptr);
+}
+
+void ShmPublisher::fix(const M8_FIX &fix)
+{
+    if (!m_segment)
+        return;
+
+    uint64_t count = m_segment->fixCount;
+    M8_SHM_FIX_RECORD &record = m_segment->fixes[count & (M8_SHM_FIX_SLOTS - 1)];
+    beginWrite(&record.seq);
+    record.fix.timestamp = fix.timestamp;
+    record.fix.latitude = fix.latitude;
+    record.fix.longitude = fix.longitude;
+    record.fix.altitude = fix.altitude;
+    record.fix.satellites = fix.satellites;
+    endWrite(&record.seq);
+    __atomic_store_n(&m_segment->fixCount, count + 1, __ATOMIC_RELEASE);
+}
+
+void ShmPublisher::satelliteInfo(const M8_SV_INFO &info)
+{
+    if (!m_segment)
+        return;
+
+    M8_SHM_SV_INFO_RECORD &record = m_segment->satellites;
+    int count = qMin(info.satellites.size(), M8_SHM_MAX_SVS);
+    beginWrite(&record.seq);
+    record.info.timestamp = Metrics::timestamp();
+    record.info.iTOW = info.iTOW;
+    record.info.version = info.version;
+    record.info.numSvs = static_cast<uint8_t>(count);
+    for (int i = 0; i < count; ++i) {
+        const M8_SV &sv = info.satellites.at(i);
+        M8_SHM_SV &out = record.info.sv[i];
+        out.gnssId = sv.gnssId;
+        out.svId = sv.svId;
+        out.cno = sv.cno;
+        out.elev = sv.elev;
+        out.azim = sv.azim;
+        out.prRes = sv.prRes;
+        out.flags = sv.flags;
+    }
+    endWrite(&record.seq);
+}
+
+void ShmPublisher::timeSample(const M8_TIME_SAMPLE &sample)
+{
+    if (!m_segment)
+        return;
+
+    M8_SHM_TIME_RECORD &record = m_segment->time;
+    beginWrite(&record.seq);
+    record.time.captureTimestamp = sample.captureTimestamp;
+    record.time.hostTime = sample.hostTime;
+    record.time.receiverTime = sample.receiverTime;
+    record.time.offset = sample.offset;
+    record.time.accuracy = sample.accuracy;
+    record.time.valid = sample.valid;
+    endWrite(&record.seq);
+}
+
+void ShmPublisher::beginWrite(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void ShmPublisher::endWrite(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
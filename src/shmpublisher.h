@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SHMPUBLISHER_H
+#define SHMPUBLISHER_H
+
+#include "m8_shm.h"
+#include "m8_sink.h"
+
+/**
+ * @brief Publishes fixes, satellites and time samples in the shared memory layout of m8_shm.h
+ *
+ * Registered as a sink, so records are written on the parser thread as the data is decoded.
+ */
+class ShmPublisher : public M8Sink
+{
+public:
+    explicit ShmPublisher(const QByteArray &name);
+    ~ShmPublisher() override;
+
+    bool isAvailable();
+
+    void fix(const M8_FIX &fix) override;
+    void satelliteInfo(const M8_SV_INFO &info) override;
+    void timeSample(const M8_TIME_SAMPLE &sample) override;
+
+private:
+    static void beginWrite(uint32_t *seq);
+    static void endWrite(uint32_t *seq);
+
+private:
+    QByteArray m_name;
+    M8_SHM_SEGMENT *m_segment;
+};
+
+#endif // SHMPUBLISHER_H
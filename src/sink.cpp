@@ -0,0 +1,51 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_sink.h"
+
+M8Sink::~M8Sink() { }
+
+void M8Sink::fix(const M8_FIX &fix)
+{
+    Q_UNUSED(fix)
+}
+
+void M8Sink::satelliteInfo(const M8_SV_INFO &info)
+{
+    Q_UNUSED(info)
+}
+
+void M8Sink::timeSample(const M8_TIME_SAMPLE &sample)
+{
+    Q_UNUSED(sample)
+}
+
+void M8Sink::nmea(const QByteArray &sentence)
+{
+    Q_UNUSED(sentence)
+}
+
+void M8Sink::ubx(const QByteArray &frame)
+{
+    Q_UNUSED(frame)
+}
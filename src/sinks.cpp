@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "sinks.h"
+
+/**
+ * @brief Sinks::add
+ * @param sink Not owned. It must stay valid until removed.
+ */
+void Sinks::add(M8Sink *sink)
+{
+    if (sink && !m_sinks.contains(sink))
+        m_sinks.append(sink);
+}
+
+void Sinks::remove(M8Sink *sink)
+{
+    m_sinks.removeAll(sink);
+}
+
+void Sinks::fix(const M8_FIX &fix)
+{
+    const QVector<M8Sink *> sinks = m_sinks;
+    for (M8Sink *sink : sinks)
+        sink->fix(fix);
+}
+
+void Sinks::satelliteInfo(const M8_SV_INFO &info)
+{
+    const QVector<M8Sink *> sinks = m_sinks;
+    for (M8Sink *sink : sinks)
+        sink->satelliteInfo(info);
+}
+
+void Sinks::timeSample(const M8_TIME_SAMPLE &sample)
+{
+    const QVector<M8Sink *> sinks = m_sinks;
+    for (M8Sink *sink : sinks)
+        sink->timeSample(sample);
+}
+
+void Sinks::nmea(const QByteArray &sentence)
+{
+    const QVector<M8Sink *> sinks = m_sinks;
+    for (M8Sink *sink : sinks)
+        sink->nmea(sentence);
+}
+
+void Sinks::ubx(const QByteArray &frame)
+{
+    const QVector<M8Sink *> sinks = m_sinks;
+    for (M8Sink *sink : sinks)
+        sink->ubx(frame);
+}
@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SINKS_H
+#define SINKS_H
+
+#include <QVector>
+#include "m8_sink.h"
+
+/**
+ * @brief The sinks of one receiver, called by the decoders as soon as data is decoded
+ *
+ * Each call goes over a copy of the list, so a sink may add or remove sinks from within its
+ * callback. Those changes take effect from the next call on. The copy shares the data of the
+ * list until it changes, so calls do not allocate.
+ */
+class Sinks
+{
+public:
+    void add(M8Sink *sink);
+    void remove(M8Sink *sink);
+
+    void fix(const M8_FIX &fix);
+    void satelliteInfo(const M8_SV_INFO &info);
+    void timeSample(const M8_TIME_SAMPLE &sample);
+    void nmea(const QByteArray &sentence);
+    void ubx(const QByteArray &frame);
+
+private:
+    QVector<M8Sink *> m_sinks;
+};
+
+#endif // SINKS_H
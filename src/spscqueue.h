@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+#include <QAtomicInteger>
+#include <qplatformdefs.h>
+#include <sys/eventfd.h>
+
+/**
+ * Lock-free ring of Size slots between exactly one producer thread and one consumer thread.
+ *
+ * Slots are filled and drained in place, so a push or pop never allocates. The consumer is woken
+ * through an eventfd, which is only written when the consumer has gone idle. A burst of pushes
+ * costs one wakeup: the consumer clears the wakeup with clearWakeup() and then drains the ring
+ * until it is empty.
+ */
+template<typename T, quint32 Size>
+class SpscQueue
+{
+    static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+
+public:
+    SpscQueue() : m_head(0), m_tail(0), m_wakeup(0)
+    {
+        m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    ~SpscQueue()
+    {
+        if (m_eventFd >= 0)
+            QT_CLOSE(m_eventFd);
+    }
+
+    /** File descriptor that becomes readable when the consumer should drain the ring */
+    int eventFd() const { return m_eventFd; }
+
+    /** Producer: free slot to fill, or nullptr if the ring is full */
+    T *writeSlot()
+    {
+        quint32 tail = m_tail.loadRelaxed();
+        if (tail - m_head.loadAcquire() == Size)
+            return nullptr;
+        return &m_slots[tail & (Size - 1)];
+    }
+
+    /** Producer: up to max free slots to fill in order, for a single batched read */
+    int writeSlots(T **batch, int max)
+    {
+        quint32 tail = m_tail.loadRelaxed();
+        int count = qMin(static_cast<int>(Size - (tail - m_head.loadAcquire())), max);
+        for (int i = 0; i < count; ++i)
+            batch[i] = &m_slots[(tail + static_cast<quint32>(i)) & (Size - 1)];
+        return count;
+    }
+
+    /**
+     * Producer: publish the first count slots returned by writeSlot() or writeSlots()
+     * @return true if the consumer was woken
+     */
+    bool commitWrite(quint32 count = 1)
+    {
+        m_tail.storeRelease(m_tail.loadRelaxed() + count);
+        if (m_wakeup.fetchAndStoreOrdered(1) != 0)
+            return false;
+        quint64 one = 1;
+        return (QT_WRITE(m_eventFd, &one, sizeof(one)) == sizeof(one));
+    }
+
+    /** Consumer: acknowledge the wakeup. Drain the ring completely afterwards */
+    void clearWakeup()
+    {
+        quint64 count;
+        ssize_t bytesRead = QT_READ(m_eventFd, &count, sizeof(count));
+        Q_UNUSED(bytesRead)
+        m_wakeup.fetchAndStoreOrdered(0);
+    }
+
+    /** Consumer: oldest published slot, or nullptr if the ring is empty */
+    T *readSlot()
+    {
+        quint32 head = m_head.loadRelaxed();
+        if (head == m_tail.loadAcquire())
+            return nullptr;
+        return &m_slots[head & (Size - 1)];
+    }
+
+    /** Consumer: up to max published slots in order */
+    int readSlots(T **batch, int max)
+    {
+        quint32 head = m_head.loadRelaxed();
+        int count = qMin(static_cast<int>(m_tail.loadAcquire() - head), max);
+        for (int i = 0; i < count; ++i)
+            batch[i] = &m_slots[(head + static_cast<quint32>(i)) & (Size - 1)];
+        return count;
+    }
+
+    /** Consumer: hand the first count slots returned by readSlot() or readSlots() back */
+    void releaseSlot(quint32 count = 1) { m_head.storeRelease(m_head.loadRelaxed() + count); }
+
+private:
+    T m_slots[Size];
+    int m_eventFd;
+
+    // Consumer side
+    QAtomicInteger<quint32> m_head;
+    char m_padding[64];
+
+    // Producer side
+    QAtomicInteger<quint32> m_tail;
+    char m_padding2[64];
+
+    // Shared, but only written when the consumer goes idle
+    QAtomicInteger<quint32> m_wakeup;
+};
+
+#endif // SPSCQUEUE_H
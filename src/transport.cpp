@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "transport.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <qplatformdefs.h>
+#include <sys/socket.h>
+#include <termios.h>
+
+//#define TRANSPORT_DEBUG
+#ifdef TRANSPORT_DEBUG
+#include <QDebug>
+#define TRANSPORT_D(x) qDebug() << "[Transport] " << x
+#else
+#define TRANSPORT_D(x)
+#endif
+
+/**
+ * @brief Transport::create
+ * @param device
+ * @return Transport for the device name, not opened yet
+ */
+Transport *Transport::create(const QString &device)
+{
+    if (device.startsWith("pty:"))
+        return new PtyTransport(device.mid(4));
+    if (device.startsWith("fd:"))
+        return new FdTransport(device.mid(3).toInt());
+    if (device.startsWith("file:"))
+        return new FileTransport(device.mid(5));
+    if (device.startsWith("tcp:")) {
+        int colon = device.lastIndexOf(':');
+        QString host = device.mid(4, colon - 4);
+        if (host.startsWith(QChar('[')) && host.endsWith(QChar(']')))
+            host = host.mid(1, host.size() - 2);
+        return new TcpTransport(host, static_cast<quint16>(device.mid(colon + 1).toInt()));
+    }
+    return new DeviceTransport(device);
+}
+
+Transport::Transport(const QString &name) : m_fd(-1), m_name(name) { }
+
+Transport::~Transport()
+{
+    close();
+}
+
+void Transport::close()
+{
+    if (m_fd >= 0)
+        QT_CLOSE(m_fd);
+    m_fd = -1;
+}
+
+QString Transport::name() const
+{
+    return m_name;
+}
+
+/**
+ * @brief Transport::fd
+ * @return Descriptor that becomes readable when there is data, -1 if not open
+ */
+int Transport::fd() const
+{
+    return m_fd;
+}
+
+/**
+ * @brief Transport::pollable
+ * @return Whether epoll can watch fd(). QSocketNotifier works for every transport.
+ */
+bool Transport::pollable() const
+{
+    return true;
+}
+
+/**
+ * @brief Transport::baudRate
+ * @return Baud rate of the link, 0 if unknown or not a serial link
+ */
+int Transport::baudRate()
+{
+    return 0;
+}
+
+ssize_t Transport::read(const struct iovec *iov, int count)
+{
+    return readv(m_fd, iov, count);
+}
+
+ssize_t Transport::write(const struct iovec *iov, int count)
+{
+    return writev(m_fd, iov, count);
+}
+
+DeviceTransport::DeviceTransport(const QString &path) : Transport(path) { }
+
+bool DeviceTransport::open()
+{
+    m_fd = QT_OPEN(m_name.toUtf8().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    return (m_fd >= 0);
+}
+
+static int readBaudRate(int fd)
+{
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+        return 0;
+
+    switch (cfgetispeed(&tio)) {
+    case B4800:
+        return 4800;
+    case B9600:
+        return 9600;
+    case B19200:
+        return 19200;
+    case B38400:
+        return 38400;
+    case B57600:
+        return 57600;
+    case B115200:
+        return 115200;
+    case B230400:
+        return 230400;
+    case B460800:
+        return 460800;
+    case B921600:
+        return 921600;
+    default:
+        return 0;
+    }
+}
+
+int DeviceTransport::baudRate()
+{
+    return readBaudRate(m_fd);
+}
+
+PtyTransport::PtyTransport(const QString &path) : DeviceTransport(path) { }
+
+bool PtyTransport::open()
+{
+    if (!DeviceTransport::open())
+        return false;
+
+    // Echo and CR/LF translation would corrupt binary UBX frames
+    struct termios tio;
+    if (tcgetattr(m_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(m_fd, TCSANOW, &tio);
+    }
+    return true;
+}
+
+FdTransport::FdTransport(int fd) : Transport(QString("fd:%1").arg(fd))
+{
+    m_fd = fd;
+}
+
+bool FdTransport::open()
+{
+    if (m_fd < 0)
+        return false;
+    int flags = fcntl(m_fd, F_GETFL);
+    return (flags >= 0 && fcntl(m_fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+int FdTransport::baudRate()
+{
+    return readBaudRate(m_fd);
+}
+
+TcpTransport::TcpTransport(const QString &host, quint16 port)
+    : Transport(QString(host.contains(QChar(':')) ? "tcp:[%1]:%2" : "tcp:%1:%2")
+                    .arg(host)
+                    .arg(port)),
+      m_host(host),
+      m_port(port)
+{
+}
+
+bool TcpTransport::open()
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *addresses = nullptr;
+    QByteArray port = QByteArray::number(m_port);
+    if (getaddrinfo(m_host.toUtf8().constData(), port.constData(), &hints, &addresses) != 0)
+        return false;
+
+    for (struct addrinfo *address = addresses; address; address = address->ai_next) {
+        m_fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                      address->ai_protocol);
+        if (m_fd < 0)
+            continue;
+        // Completes in the background, the I/O thread must not wait for it
+        if (::connect(m_fd, address->ai_addr, address->ai_addrlen) == 0 || errno == EINPROGRESS)
+            break;
+        close();
+    }
+    freeaddrinfo(addresses);
+    if (m_fd < 0)
+        return false;
+
+    // Commands are small and latency matters more than segment count
+    int one = 1;
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    TRANSPORT_D("Connecting to" << m_name);
+    return true;
+}
+
+FileTransport::FileTransport(const QString &path) : Transport(path) { }
+
+bool FileTransport::open()
+{
+    m_fd = QT_OPEN(m_name.toUtf8().constData(), O_RDONLY);
+    return (m_fd >= 0);
+}
+
+bool FileTransport::pollable() const
+{
+    return false;
+}
+
+ssize_t FileTransport::write(const struct iovec *iov, int count)
+{
+    ssize_t size = 0;
+    for (int i = 0; i < count; ++i)
+        size += static_cast<ssize_t>(iov[i].iov_len);
+    return size;
+}
@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <QString>
+#include <sys/uio.h>
+
+/**
+ * @brief Byte stream to and from a receiver
+ *
+ * A transport is a descriptor that signals readiness, with scatter/gather reads and writes so a
+ * caller can read straight into its own buffers. Descriptors are nonblocking, so read() and write()
+ * fail with EAGAIN rather than wait. create() picks the implementation from the device name:
+ *  - "pty:<path>"        pseudo terminal, switched to raw mode
+ *  - "tcp:<host>:<port>" TCP connection, e.g. to a local serial-to-network bridge. An IPv6
+ *    address is written in brackets, as in "tcp:[::1]:5000".
+ *  - "fd:<n>"            descriptor opened by the caller, owned by the transport from then on
+ *  - "file:<path>"       raw receiver output in a regular file, read once, writes discarded
+ *  - anything else       character device path, such as a serial port
+ */
+class Transport
+{
+public:
+    static Transport *create(const QString &device);
+    virtual ~Transport();
+
+    virtual bool open() = 0;
+    void close();
+
+    QString name() const;
+    int fd() const;
+    virtual bool pollable() const;
+    virtual int baudRate();
+
+    /* Like readv and writev. 0 from read() means the stream has ended. */
+    virtual ssize_t read(const struct iovec *iov, int count);
+    virtual ssize_t write(const struct iovec *iov, int count);
+
+protected:
+    explicit Transport(const QString &name);
+
+    int m_fd;
+    QString m_name;
+};
+
+/**
+ * @brief Character device, such as a UART
+ */
+class DeviceTransport : public Transport
+{
+public:
+    explicit DeviceTransport(const QString &path);
+
+    bool open() override;
+    int baudRate() override;
+};
+
+/**
+ * @brief Pseudo terminal, with line discipline processing turned off
+ */
+class PtyTransport : public DeviceTransport
+{
+public:
+    explicit PtyTransport(const QString &path);
+
+    bool open() override;
+};
+
+/**
+ * @brief Descriptor handed in by the caller
+ */
+class FdTransport : public Transport
+{
+public:
+    explicit FdTransport(int fd);
+
+    bool open() override;
+    int baudRate() override;
+};
+
+/**
+ * @brief TCP connection
+ *
+ * open() only starts connecting. Reads and writes fail with EAGAIN until the connection is up,
+ * and a refused connection shows up as a read error.
+ */
+class TcpTransport : public Transport
+{
+public:
+    TcpTransport(const QString &host, quint16 port);
+
+    bool open() override;
+
+private:
+    QString m_host;
+    quint16 m_port;
+};
+
+/**
+ * @brief Regular file, which can not be watched by epoll
+ */
+class FileTransport : public Transport
+{
+public:
+    explicit FileTransport(const QString &path);
+
+    bool open() override;
+    bool pollable() const override;
+    ssize_t write(const struct iovec *iov, int count) override;
+};
+
+#endif // TRANSPORT_H
@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "ttff.h"
+#include "assistance.h"
+#include "power.h"
+#include "ubx.h"
+#include <cstring>
+
+//#define TTFF_DEBUG
+#ifdef TTFF_DEBUG
+#include <QDebug>
+#define TTFF_D(x) qDebug() << "[TTFF] " << x
+#else
+#define TTFF_D(x)
+#endif
+
+/**
+ * @brief TTFF::TTFF
+ * @param ubx
+ * @param power
+ * @param assistance
+ * @param parent
+ *
+ * newFix() is connected to the decoder that delivers the application's fixes.
+ */
+TTFF::TTFF(UBX *ubx, Power *power, Assistance *assistance, QObject *parent)
+    : QObject(parent), p_ubx(ubx), p_assistance(assistance), m_hadFix(false)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    for (int type = 0; type < M8_START_TYPES; ++type) {
+        m_stats.firstFix[type].minMs = 0xFFFFFFFF;
+        m_stats.first3dFix[type].minMs = 0xFFFFFFFF;
+        m_stats.firstTime[type].minMs = 0xFFFFFFFF;
+    }
+
+    connect(ubx, &UBX::systemTimeDrift, this, &TTFF::timeValid);
+    connect(power, &Power::engineStateChanged, this, &TTFF::engineStateChanged);
+
+    // The library is constructed when the receiver is powered, so this is the first start
+    start();
+}
+
+M8_TTFF_STATS TTFF::statistics()
+{
+    return m_stats;
+}
+
+void TTFF::engineStateChanged(bool on)
+{
+    if (on) {
+        start();
+    } else if (m_timer.isValid()) {
+        if (m_current.firstFixMs < 0)
+            ++m_stats.aborted[m_current.startType];
+        m_timer.invalidate();
+    }
+}
+
+/**
+ * @brief TTFF::newFix
+ * @param fix
+ *
+ * UBX-NAV-PVT reports the fix type; for GGA it is assumed 3D once four satellites are used.
+ */
+void TTFF::newFix(const M8_FIX &fix)
+{
+    m_hadFix = true;
+    if (!m_timer.isValid())
+        return;
+
+    bool updated = false;
+    if (m_current.firstFixMs < 0) {
+        m_current.firstFixMs = m_timer.elapsed();
+        addSample(m_stats.firstFix[m_current.startType], m_current.firstFixMs);
+        updated = true;
+    }
+    bool fix3d = M8_FIX_3D == fix.fixType || M8_FIX_GNSS_DEAD_RECKONING == fix.fixType;
+    if (m_current.first3dFixMs < 0 && fix3d) {
+        m_current.first3dFixMs = m_timer.elapsed();
+        addSample(m_stats.first3dFix[m_current.startType], m_current.first3dFixMs);
+        updated = true;
+    }
+
+    if (updated) {
+        TTFF_D("Fix after " << m_current.firstFixMs << " ms, 3D fix after "
+                            << m_current.first3dFixMs << " ms");
+        emit ttff(m_current);
+        if (isComplete())
+            m_timer.invalidate();
+    }
+}
+
+void TTFF::timeValid(qint64 offsetMilliseconds)
+{
+    Q_UNUSED(offsetMilliseconds)
+
+    if (m_timer.isValid() && m_current.firstTimeMs < 0) {
+        m_current.firstTimeMs = m_timer.elapsed();
+        addSample(m_stats.firstTime[m_current.startType], m_current.firstTimeMs);
+        TTFF_D("Valid time after " << m_current.firstTimeMs << " ms");
+        emit ttff(m_current);
+        if (isComplete())
+            m_timer.invalidate();
+    }
+}
+
+void TTFF::start()
+{
+    if (m_timer.isValid() && m_current.firstFixMs < 0)
+        ++m_stats.aborted[m_current.startType];
+
+    m_current.startType = startType();
+    m_current.firstFixMs = -1;
+    m_current.first3dFixMs = -1;
+    m_current.firstTimeMs = -1;
+    ++m_stats.starts[m_current.startType];
+    m_timer.start();
+    TTFF_D("Measurement started, type: " << m_current.startType);
+
+    // Valid time is only reported when polled
+    p_ubx->requestTime();
+}
+
+bool TTFF::isComplete()
+{
+    return (m_current.firstFixMs >= 0 && m_current.first3dFixMs >= 0
+            && m_current.firstTimeMs >= 0);
+}
+
+/**
+ * @brief TTFF::startType
+ * @return Start type
+ *
+ * A restart of the engine after a fix is hot, as the receiver keeps its ephemeris while stopped.
+ */
+M8_START_TYPE TTFF::startType()
+{
+    if (m_hadFix || p_assistance->uploadedEntries() > 0)
+        return M8_START_HOT;
+
+    if (p_assistance->timeInjected())
+        return M8_START_WARM;
+
+    return M8_START_COLD;
+}
+
+void TTFF::addSample(M8_TTFF_HISTOGRAM &histogram, qint64 ms)
+{
+    quint32 value = static_cast<quint32>(qMin(ms, static_cast<qint64>(0xFFFFFFFE)));
+    ++histogram.count;
+    histogram.sumMs += value;
+    histogram.minMs = qMin(histogram.minMs, value);
+    histogram.maxMs = qMax(histogram.maxMs, value);
+    for (int bin = 0; bin < M8_TTFF_HISTOGRAM_BINS; ++bin) {
+        if (value <= M8_TTFF_HISTOGRAM_LIMITS[bin]) {
+            ++histogram.bins[bin];
+            break;
+        }
+    }
+}
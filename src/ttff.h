@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef TTFF_H
+#define TTFF_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include "m8_fix.h"
+#include "m8_ttff.h"
+
+class Assistance;
+class Power;
+class UBX;
+
+class TTFF : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TTFF(UBX *ubx, Power *power, Assistance *assistance, QObject *parent = nullptr);
+
+    M8_TTFF_STATS statistics();
+
+public slots:
+    void newFix(const M8_FIX &fix);
+
+signals:
+    void ttff(M8_TTFF ttff);
+
+private slots:
+    void engineStateChanged(bool on);
+    void timeValid(qint64 offsetMilliseconds);
+
+private:
+    void start();
+    bool isComplete();
+    M8_START_TYPE startType();
+    void addSample(M8_TTFF_HISTOGRAM &histogram, qint64 ms);
+
+private:
+    UBX *p_ubx;
+    Assistance *p_assistance;
+    QElapsedTimer m_timer;
+    M8_TTFF m_current;
+    M8_TTFF_STATS m_stats;
+    bool m_hadFix;
+};
+
+#endif // TTFF_H
@@ -22,9 +22,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "ubx.h"
+#include "kernels.h"
 #include "m8device.h"
+#include "metrics.h"
+#include "sinks.h"
 #include <QDateTime>
 #include <QTimer>
+#include <string.h>
+#include <time.h>
 
 //#define UBX_DEBUG
 #ifdef UBX_DEBUG
@@ -35,11 +40,50 @@ SOFTWARE.
 #define UBX_D(x)
 #endif
 
-UBX::UBX(M8Device *device, QObject *parent) : QObject(parent), m_autonomousAssist(false)
+static inline quint16 readU16(const QByteArray &msg, int i)
+{
+    return static_cast<quint16>((msg.at(i) & 0xFF) | ((msg.at(i + 1) & 0xFF) << 8));
+}
+
+static inline qint16 readI16(const QByteArray &msg, int i)
+{
+    return static_cast<qint16>(readU16(msg, i));
+}
+
+static inline qint32 readI32(const QByteArray &msg, int i)
+{
+    return static_cast<qint32>((msg.at(i) & 0xFF) | ((msg.at(i + 1) & 0xFF) << 8)
+                               | ((msg.at(i + 2) & 0xFF) << 16)
+                               | (static_cast<quint32>(msg.at(i + 3) & 0xFF) << 24));
+}
+
+UBX::UBX(M8Device *device, Metrics *metrics, QObject *parent)
+    : QObject(parent),
+      p_device(device),
+      p_metrics(metrics),
+      p_sinks(nullptr),
+      m_fixSinks(false),
+      m_baudRate(device->baudRate()),
+      m_autonomousAssist(false),
+      m_timeSubscription(false),
+      m_powerModePending(false),
+      m_gnssSystems(0),
+      m_gnssSystemsPending(false),
+      m_engineOn(true),
+      m_dopITow(0),
+      m_hdop(0),
+      m_vdop(0)
 {
     UBX_D("constructor");
     m_ackQueue.message.clear();
     m_ackQueue.ack = false;
+    m_gnssConfig.valid = false;
+    m_gnssConfig.numTrkChHw = 0;
+    m_gnssConfig.numTrkChUse = 0;
+    m_gnssConfig.supported = 0;
+    m_gnssConfig.defaultGnss = 0;
+    m_gnssConfig.enabled = 0;
+    m_gnssConfig.simultaneous = 0;
     m_ackTimer = new QTimer(this);
     m_ackTimer->setInterval(3000);
     m_ackTimer->setSingleShot(true);
@@ -48,148 +92,160 @@ UBX::UBX(M8Device *device, QObject *parent) : QObject(parent), m_autonomousAssis
     m_timeTimer->setInterval(3000);
     connect(m_timeTimer, &QTimer::timeout, this, &UBX::requestTime);
     m_timeTimer->stop();
-    connect(this, &UBX::writeMessage, device, &M8Device::write);
 }
 
 bool UBX::crcCheck(const QByteArray &msg)
 {
-    quint8 ck_a = 0;
-    quint8 ck_b = 0;
-    int len = msg.at(2) | (msg.at(3) << 8);
+    int len = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
+    if (msg.size() < len + 6)
+        return false;
 
-    for (int i = 0; i < (msg.size() - 2); ++i) {
-        ck_a += msg.at(i);
-        ck_b += ck_a;
-    }
-    /*UBX_D("ck_a(" << QString::number(msg.at(len + 4)).toLatin1() << ", " << ck_a << "), ck_b("
-                  << QString::number(msg.at(len + 5)).toLatin1() << ", " << ck_b << ")");*/
-    if ((ck_a == msg.at(len + 4)) && (ck_b == msg.at(len + 5)))
-        return true;
+    quint16 checksum = Kernels::ubxChecksum(msg.constData(), msg.size() - 2);
+    // Compared as unsigned, as char is signed on some platforms
+    return ((checksum & 0xFF) == static_cast<quint8>(msg.at(len + 4)))
+            && ((checksum >> 8) == static_cast<quint8>(msg.at(len + 5)));
+}
 
-    return false;
+/**
+ * @brief UBX::setSinks
+ * @param sinks Called with decoded satellite info and time samples before any signal, or
+ * nullptr. Not owned.
+ * @param fixes Also call them with the fixes of UBX-NAV-PVT
+ */
+void UBX::setSinks(Sinks *sinks, bool fixes)
+{
+    p_sinks = sinks;
+    m_fixSinks = fixes;
 }
 
-void UBX::parse(const QByteArray &msg)
+/**
+ * @brief UBX::parse
+ * @param msg Message without sync chars, including checksum
+ * @param timestamp CLOCK_MONOTONIC time [ns] the message was read from the device
+ */
+void UBX::parse(const QByteArray &msg, qint64 timestamp)
 {
     switch (msg.at(0)) {
     case 0x01:
         if (0x21 == msg.at(1)) {
             UBX_D("UBX-NAV-TIMEUTC");
-            if ((msg.size() >= 24)) {
-                if (((msg.at(23) & 0x04) > 0) || ((msg.at(23) & 0x03) == 0x03)) {
-                    QTime t(msg.at(20) & 0xFF, msg.at(21) & 0xFF, msg.at(22) & 0xFF,
-                            (static_cast<qint32>((msg.at(12) & 0xFF) | ((msg.at(13) & 0xFF) << 8)
-                                                 | ((msg.at(14) & 0xFF) << 16)
-                                                 | ((msg.at(15) & 0xFF) << 24)))
-                                    / 1000000);
-                    QDate d((msg.at(16) & 0xFF) | ((msg.at(17) & 0xFF) << 8), msg.at(18) & 0xFF,
-                            msg.at(19) & 0xFF);
-                    if (t.isValid() && d.isValid()) {
-                        QDateTime dt(d, t);
-                        emit systemTimeDrift(QDateTime::currentDateTimeUtc().msecsTo(dt));
-                        m_timeTimer->stop();
-                        UBX_D("New UTC time: " << dt);
-                    } else {
-                        UBX_D("Time not valid yet: " << QDateTime(d, t) << "\tt: " << t.isValid()
-                                                     << ",\td: " << d.isValid());
-                    }
-                } else {
-#ifdef UBX_DEBUG
-                    QTime t(msg.at(20) & 0xFF, msg.at(21) & 0xFF, msg.at(22) & 0xFF,
-                            ((qint32)((msg.at(12) & 0xFF) | ((msg.at(13) & 0xFF) << 8)
-                                      | ((msg.at(14) & 0xFF) << 16) | ((msg.at(15) & 0xFF) << 24)))
-                                    / 1000000);
-                    QDate d((msg.at(16) & 0xFF) | ((msg.at(17) & 0xFF) << 8), msg.at(18) & 0xFF,
-                            msg.at(19) & 0xFF);
-                    QDateTime dt(d, t);
-                    UBX_D("Still waiting for accurate time. Invalid time is: "
-                          << dt << "\t\tvalidity flags: "
-                          << QString::number((uint)(msg.at(23) & 0xFF), 16).toLatin1());
-#endif
-                }
+            M8_TIME_SAMPLE sample;
+            if (decodeTimeUtc(msg, &sample)) {
+                sample.captureTimestamp = timestamp;
+                sample.hostTime = hostTime(timestamp, msg.size() + 2);
+                sample.offset = sample.receiverTime - sample.hostTime;
+                if (p_sinks)
+                    p_sinks->timeSample(sample);
+                emit timeSample(sample);
+                emit systemTimeDrift(qRound64(sample.offset / 1000000.0));
+                m_timeTimer->stop();
+                UBX_D("New UTC time: " << sample.receiverTime << " offset: " << sample.offset
+                                       << " ns, accuracy: " << sample.accuracy << " ns");
+            } else {
+                UBX_D("Still waiting for accurate time, validity flags: "
+                      << QString::number((uint)(msg.at(23) & 0xFF), 16).toLatin1());
             }
         } else if (0x35 == msg.at(1)) {
             UBX_D("UBX-NAV-SAT");
-            int payloadLen = msg.at(2) | (msg.at(3) << 8);
-            if (msg.size() >= (payloadLen + 6)) {
-                M8_SV_INFO info;
-                info.iTOW = static_cast<quint32>(msg.at(4) | (msg.at(5) << 8) | (msg.at(6) << 16)
-                                                 | (msg.at(7) << 24));
-                info.version = static_cast<quint8>(msg.at(8));
-                info.numSvs = static_cast<quint8>(msg.at(9));
-                for (int i = 12; i <= (msg.size() - 14); i += 12) {
-                    M8_SV sat;
-                    sat.gnssId = static_cast<quint8>(msg.at(i));
-                    sat.svId = static_cast<quint8>(msg.at(i + 1));
-                    sat.cno = static_cast<quint8>(msg.at(i + 2));
-                    sat.elev = static_cast<qint8>(msg.at(i + 3));
-                    sat.azim = static_cast<qint16>(msg.at(i + 4) | (msg.at(i + 5) << 8));
-                    sat.prRes = static_cast<qint16>(msg.at(i + 6) | (msg.at(i + 7) << 8));
-                    sat.flags =
-                            static_cast<quint32>(msg.at(i + 8) | (msg.at(i + 9) << 8)
-                                                 | (msg.at(i + 10) << 16) | (msg.at(i + 11) << 24));
-                    info.satellites.append(sat);
-                }
+            M8_SV_INFO info;
+            if (decodeSatelliteInfo(msg, &info)) {
+                if (p_sinks)
+                    p_sinks->satelliteInfo(info);
                 emit satelliteInfo(info);
             } else {
                 UBX_D("Error: wrong message size for UBX-NAV-SAT");
             }
+        } else if (0x04 == msg.at(1)) {
+            UBX_D("UBX-NAV-DOP");
+            // Sent before UBX-NAV-PVT of the same epoch, which picks it up by iTOW
+            if (msg.size() >= 24) {
+                m_dopITow = static_cast<quint32>(readI32(msg, 4));
+                m_vdop = readU16(msg, 14) * 0.01f;
+                m_hdop = readU16(msg, 16) * 0.01f;
+            }
+        } else if (0x07 == msg.at(1)) {
+            UBX_D("UBX-NAV-PVT");
+            M8_FIX fix;
+            quint32 iTOW;
+            if (decodeNavPvt(msg, &fix, &iTOW)) {
+                fix.timestamp = timestamp;
+                if (iTOW == m_dopITow) {
+                    fix.hdop = m_hdop;
+                    fix.vdop = m_vdop;
+                    fix.fields |= M8_FIX_HAS_HDOP | M8_FIX_HAS_VDOP;
+                }
+                if (p_sinks && m_fixSinks)
+                    p_sinks->fix(fix);
+                emit newFix(fix);
+            } else if (msg.size() >= 98) {
+                emit fixLost(timestamp);
+            }
         } else if (0x60 == msg.at(1)) {
             UBX_D("Autonomous assist enabled: " << QString::number(msg.at(8)).toLatin1());
             UBX_D("Autonomous assist active:  " << QString::number(msg.at(9)).toLatin1());
         }
         break;
     case 0x05:
-        if (0x01 == msg.at(1)) {
+        if (msg.size() < 6) {
+            break;
+        } else if (0x01 == msg.at(1)) {
             UBX_D("ack");
-            ack();
+            ack(true, msg.at(4), msg.at(5));
         } else if (0x00 == msg.at(1)) {
             UBX_D("nack");
-            ack();
+            ack(false, msg.at(4), msg.at(5));
         }
         break;
     case 0x06:
         if (0x23 == msg.at(1)) {
             UBX_D("UBX-CFG-NAVX5");
-            int payloadLen = msg.at(2) | (msg.at(3) << 8);
+            int payloadLen = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
             if (msg.size() >= (payloadLen + 6)) {
                 m_UbxCfgNavx5 = msg.mid(4, payloadLen);
                 setAutonomousAssist(m_autonomousAssist);
             } else {
                 UBX_D("Error: wrong message size for UBX-CFG-NAVX5");
             }
+        } else if (0x3B == msg.at(1)) {
+            UBX_D("UBX-CFG-PM2");
+            int payloadLen = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
+            if (msg.size() >= (payloadLen + 6) && payloadLen >= 44) {
+                m_UbxCfgPm2 = msg.mid(4, payloadLen);
+                if (m_powerModePending)
+                    setPowerMode(m_powerSettings);
+            } else {
+                UBX_D("Error: wrong message size for UBX-CFG-PM2");
+            }
         } else if (0x3E == msg.at(1)) {
-#ifdef UBX_DEBUG
-            UBX_D("GNSS configuration:");
-            UBX_D("Version:\t\t" << QString::number(msg.at(4) & 0xFF).toLatin1());
-            UBX_D("numTrkChHw:\t" << QString::number(msg.at(5) & 0xFF).toLatin1());
-            UBX_D("numTrkChUse:\t" << QString::number(msg.at(6) & 0xFF).toLatin1());
-            UBX_D("numConfigBlocks:\t" << QString::number(msg.at(7) & 0xFF).toLatin1());
-            const QStringList gnssNames = (QStringList() << "GPS"
-                                                         << "SBAS"
-                                                         << "Galileo"
-                                                         << "BeiDou"
-                                                         << "IMES"
-                                                         << "QZSS"
-                                                         << "GLONASS"
-                                                         << "IRNSS");
-            int len = (msg.at(2) & 0xFF) | (msg.at(3) << 8);
-            int i = 8;
-            while ((i + 8) <= (len + 4) && (i + 8) < msg.size()) {
-                if (msg.at(i) < gnssNames.size()) {
-                    UBX_D("System:\t\t" << gnssNames.at(msg.at(i++)));
+            UBX_D("UBX-CFG-GNSS");
+            int payloadLen = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
+            if (msg.size() >= (payloadLen + 6) && payloadLen >= 4) {
+                m_gnssConfig.numTrkChHw = static_cast<quint8>(msg.at(5));
+                m_gnssConfig.numTrkChUse = static_cast<quint8>(msg.at(6));
+                m_gnssConfig.blocks.clear();
+                for (int i = 8; (i + 8) <= (payloadLen + 4); i += 8) {
+                    M8_GNSS_BLOCK block;
+                    block.gnssId = static_cast<quint8>(msg.at(i));
+                    block.resTrkCh = static_cast<quint8>(msg.at(i + 1));
+                    block.maxTrkCh = static_cast<quint8>(msg.at(i + 2));
+                    block.flags = static_cast<quint32>(
+                            (msg.at(i + 4) & 0xFF) | ((msg.at(i + 5) & 0xFF) << 8)
+                            | ((msg.at(i + 6) & 0xFF) << 16) | ((msg.at(i + 7) & 0xFF) << 24));
+                    block.enabled = (block.flags & 0x01);
+                    m_gnssConfig.blocks.append(block);
+                    UBX_D("System " << block.gnssId << " enabled: " << block.enabled
+                                    << " resTrkCh: " << block.resTrkCh
+                                    << " maxTrkCh: " << block.maxTrkCh);
+                }
+                m_gnssConfig.valid = true;
+                if (m_gnssSystemsPending) {
+                    setGnssSystems(m_gnssSystems);
                 } else {
-                    UBX_D("System:\t\t" << QString::number(msg.at(i++) & 0xFF).toLatin1());
+                    emit gnssConfig(m_gnssConfig);
                 }
-                UBX_D("\tresTrkCh:\t" << QString::number(msg.at(i++) & 0xFF).toLatin1());
-                UBX_D("\tmaxTrkCh:\t" << QString::number(msg.at(i++) & 0xFF).toLatin1());
-                ++i; // Skip reserved byte
-                UBX_D("\tEnabled:\t" << (msg.at(i++) & 0xFF));
-                ++i; // Skip empty byte
-                UBX_D("\tFlags (hex):\t" << QString::number(msg.at(i++) & 0xFF, 16).toLatin1());
-                ++i; // Skip empty byte
+            } else {
+                UBX_D("Error: wrong message size for UBX-CFG-GNSS");
             }
-#endif
         }
         break;
     case 0x0A:
@@ -201,12 +257,18 @@ void UBX::parse(const QByteArray &msg)
             UBX_D("GNSS default:\t\t" << QString::number(msg.at(6) & 0xFF).toLatin1());
             UBX_D("GNSS enabled:\t\t" << QString::number(msg.at(7) & 0xFF).toLatin1());
             UBX_D("GNSS simultaneous:\t" << QString::number(msg.at(8) & 0xFF).toLatin1());
+            if (msg.size() >= 14) {
+                m_gnssConfig.supported = static_cast<quint8>(msg.at(5));
+                m_gnssConfig.defaultGnss = static_cast<quint8>(msg.at(6));
+                m_gnssConfig.enabled = static_cast<quint8>(msg.at(7));
+                m_gnssConfig.simultaneous = static_cast<quint8>(msg.at(8));
+            }
         }
         break;
     case 0x13:
         if (static_cast<char>(0x80) == msg.at(1)) {
             UBX_D("UBX-MGA-DBD");
-            int payloadLen = msg.at(2) | (msg.at(3) << 8);
+            int payloadLen = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
             if (msg.size() >= (payloadLen + 6)) {
                 emit saveNavigationEntry(msg.mid(4, payloadLen));
             } else {
@@ -220,6 +282,141 @@ void UBX::parse(const QByteArray &msg)
     }
 }
 
+/**
+ * @brief UBX::decodeTimeUtc
+ * @param msg UBX-NAV-TIMEUTC without sync chars
+ * @param sample Receiver time, accuracy and validity are set
+ * @return false if the receiver has not resolved UTC yet
+ */
+bool UBX::decodeTimeUtc(const QByteArray &msg, M8_TIME_SAMPLE *sample)
+{
+    if (msg.size() < 24 || !(((msg.at(23) & 0x04) > 0) || ((msg.at(23) & 0x03) == 0x03)))
+        return false;
+
+    QTime t(msg.at(20) & 0xFF, msg.at(21) & 0xFF, msg.at(22) & 0xFF);
+    QDate d((msg.at(16) & 0xFF) | ((msg.at(17) & 0xFF) << 8), msg.at(18) & 0xFF,
+            msg.at(19) & 0xFF);
+    if (!t.isValid() || !d.isValid()) {
+        UBX_D("Time not valid yet: " << QDateTime(d, t) << "\tt: " << t.isValid()
+                                     << ",\td: " << d.isValid());
+        return false;
+    }
+
+    QDateTime dt(d, t, Qt::UTC);
+    qint32 nano = static_cast<qint32>((msg.at(12) & 0xFF) | ((msg.at(13) & 0xFF) << 8)
+                                      | ((msg.at(14) & 0xFF) << 16) | ((msg.at(15) & 0xFF) << 24));
+    sample->receiverTime = dt.toMSecsSinceEpoch() * 1000000LL + nano;
+    sample->accuracy = static_cast<quint32>((msg.at(8) & 0xFF) | ((msg.at(9) & 0xFF) << 8)
+                                            | ((msg.at(10) & 0xFF) << 16)
+                                            | ((msg.at(11) & 0xFF) << 24));
+    sample->valid = static_cast<quint8>(msg.at(23) & 0x07);
+    return true;
+}
+
+/**
+ * @brief UBX::decodeSatelliteInfo
+ * @param msg UBX-NAV-SAT without sync chars
+ * @param info
+ * @return false if the message is shorter than its length field
+ */
+bool UBX::decodeSatelliteInfo(const QByteArray &msg, M8_SV_INFO *info)
+{
+    int payloadLen = (msg.at(2) & 0xFF) | ((msg.at(3) & 0xFF) << 8);
+    if (msg.size() < (payloadLen + 6))
+        return false;
+
+    info->iTOW = static_cast<quint32>(readI32(msg, 4));
+    info->version = static_cast<quint8>(msg.at(8));
+    info->numSvs = static_cast<quint8>(msg.at(9));
+    info->satellites.clear();
+    for (int i = 12; i <= (msg.size() - 14); i += 12) {
+        M8_SV sat;
+        sat.gnssId = static_cast<quint8>(msg.at(i));
+        sat.svId = static_cast<quint8>(msg.at(i + 1));
+        sat.cno = static_cast<quint8>(msg.at(i + 2));
+        sat.elev = static_cast<qint8>(msg.at(i + 3));
+        sat.azim = readI16(msg, i + 4);
+        sat.prRes = readI16(msg, i + 6);
+        sat.flags = static_cast<quint32>(readI32(msg, i + 8));
+        info->satellites.append(sat);
+    }
+    return true;
+}
+
+/**
+ * @brief UBX::decodeNavPvt
+ * @param msg UBX-NAV-PVT without sync chars
+ * @param fix Timestamp not set
+ * @param iTOW GPS time of week of the epoch [ms]
+ * @return false if the message is too short or the receiver has no valid fix
+ */
+bool UBX::decodeNavPvt(const QByteArray &msg, M8_FIX *fix, quint32 *iTOW)
+{
+    if (msg.size() < 98)
+        return false;
+
+    quint8 fixType = static_cast<quint8>(msg.at(24));
+    quint8 flags = static_cast<quint8>(msg.at(25));
+    if (!(flags & 0x01) || M8_FIX_NONE == fixType || fixType >= M8_FIX_TIME_ONLY)
+        return false; /* gnssFixOK not set */
+
+    memset(fix, 0, sizeof(*fix));
+    *iTOW = static_cast<quint32>(readI32(msg, 4));
+    fix->fixType = fixType;
+    if (M8_FIX_DEAD_RECKONING == fixType)
+        fix->quality = M8_FIX_QUALITY_DEAD_RECKONING;
+    else if (0x80 == (flags & 0xC0))
+        fix->quality = M8_FIX_QUALITY_RTK_FIXED;
+    else if (0x40 == (flags & 0xC0))
+        fix->quality = M8_FIX_QUALITY_RTK_FLOAT;
+    else
+        fix->quality = (flags & 0x02) ? M8_FIX_QUALITY_DGNSS : M8_FIX_QUALITY_GNSS;
+    fix->satellites = static_cast<quint8>(msg.at(27));
+    fix->longitude = readI32(msg, 28) * 1e-7;
+    fix->latitude = readI32(msg, 32) * 1e-7;
+    fix->height = readI32(msg, 36) * 0.001f;
+    fix->altitude = readI32(msg, 40) * 0.001f;
+    fix->horizontalAccuracy = static_cast<quint32>(readI32(msg, 44)) * 0.001f;
+    fix->verticalAccuracy = static_cast<quint32>(readI32(msg, 48)) * 0.001f;
+    fix->velocityNorth = readI32(msg, 52) * 0.001f;
+    fix->velocityEast = readI32(msg, 56) * 0.001f;
+    fix->velocityDown = readI32(msg, 60) * 0.001f;
+    fix->groundSpeed = readI32(msg, 64) * 0.001f;
+    fix->heading = readI32(msg, 68) * 1e-5f;
+    fix->pdop = readU16(msg, 80) * 0.01f;
+    fix->fields = M8_FIX_HAS_HEIGHT | M8_FIX_HAS_ACCURACY | M8_FIX_HAS_VELOCITY
+            | M8_FIX_HAS_HEADING | M8_FIX_HAS_PDOP;
+    if (msg.at(15) & 0x02) { /* validTime */
+        qint32 ms = (((msg.at(12) & 0xFF) * 60 + (msg.at(13) & 0xFF)) * 60 + (msg.at(14) & 0xFF))
+                        * 1000
+                + qRound(readI32(msg, 20) / 1000000.0);
+        fix->utcTimeOfDay = (ms + 86400000) % 86400000;
+        fix->fields |= M8_FIX_HAS_TIME;
+    }
+    return true;
+}
+
+/**
+ * @brief UBX::hostTime
+ * @param timestamp CLOCK_MONOTONIC time [ns] the message was read from the device
+ * @param frameSize Size of the message including sync chars and checksum
+ * @return CLOCK_REALTIME [ns] when the receiver started sending the message
+ *
+ * The message is complete when read, so it started transmission 10 bits per byte earlier.
+ */
+qint64 UBX::hostTime(qint64 timestamp, int frameSize)
+{
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    qint64 now = Metrics::timestamp();
+    qint64 hostTime = static_cast<qint64>(realtime.tv_sec) * 1000000000LL + realtime.tv_nsec
+            - (now - timestamp);
+    if (m_baudRate > 0)
+        hostTime -= (frameSize * 10 * 1000000000LL) / m_baudRate;
+
+    return hostTime;
+}
+
 void UBX::configureNMEA()
 {
     // Disable all NMEA messsages except GGA
@@ -329,22 +526,36 @@ void UBX::configureNMEA()
     addMessage(msgNMEAConf);
 
 #ifdef UBX_DEBUG1
-    /* Get enabled GNSS systems */
-    UBXMessage msgGNSS;
-    msgGNSS.ack = false;
-    msgGNSS.message.append(0x0A); /* Message class */
-    msgGNSS.message.append(0x28); /* Message id */
-    msgGNSS.message.append(static_cast<char>(0x00)); /* Payload size */
-    msgGNSS.message.append(static_cast<char>(0x00)); /* Payload size */
-    addMessage(msgGNSS);
-
-    /* Get individual GNSS configurations */
-    msgGNSS.message[0] = 0x06;
-    msgGNSS.message[1] = 0x3E;
-    addMessage(msgGNSS);
+    requestGnssConfig(true);
 #endif
 }
 
+/**
+ * @brief UBX::enableNavigationSolution
+ *
+ * Turns on UBX-NAV-DOP and UBX-NAV-PVT every epoch on the current port, for fixes with
+ * velocity and accuracy.
+ */
+void UBX::enableNavigationSolution()
+{
+    UBXMessage msgCfgMsg;
+    msgCfgMsg.ack = true;
+    msgCfgMsg.message.append(0x06); /* Message class */
+    msgCfgMsg.message.append(0x01); /* Message id */
+    msgCfgMsg.message.append(0x03); /* Payload size */
+    msgCfgMsg.message.append(static_cast<char>(0x00)); /* Payload size */
+    msgCfgMsg.message.append(0x01); /* msgClass */
+    msgCfgMsg.message.append(0x04); /* msgID */
+    msgCfgMsg.message.append(0x01); /* rate on current port */
+
+    /* Message: NAV-DOP */
+    addMessage(msgCfgMsg);
+
+    /* Message: NAV-PVT */
+    msgCfgMsg.message[5] = 0x07; /* msgID */
+    addMessage(msgCfgMsg);
+}
+
 void UBX::injectTimeAssistance()
 {
     UBX_D(__PRETTY_FUNCTION__);
@@ -384,6 +595,7 @@ void UBX::injectTimeAssistance()
 
 void UBX::setEngineState(bool on)
 {
+    m_engineOn = on;
     quint8 mode = (on) ? 0x09 : 0x08;
     UBXMessage msgRST;
     msgRST.ack = false;
@@ -398,28 +610,54 @@ void UBX::setEngineState(bool on)
     addMessage(msgRST);
 }
 
-void UBX::setPowerSave(bool on)
-{
-    quint8 mode = 0;
-    if (on) {
-        mode = 1;
-        UBXMessage msgPMS;
-        msgPMS.ack = false;
-        msgPMS.message.append(0x06); /* Message class */
-        msgPMS.message.append(0x86); /* Message id */
-        msgPMS.message.append(0x08); /* Payload size */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Payload size */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Message version */
-        msgPMS.message.append(0x03); /* Aggressive with 1Hz */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Period, for interval mode */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Period, for interval mode */
-        msgPMS.message.append(static_cast<char>(0x00)); /* onTime, for interval mode */
-        msgPMS.message.append(static_cast<char>(0x00)); /* onTime, for interval mode */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Reserved1 */
-        msgPMS.message.append(static_cast<char>(0x00)); /* Reserved1 */
-        addMessage(msgPMS);
+/**
+ * @brief UBX::setPowerMode
+ * @param settings
+ *
+ * Power save timing is written to the receiver's own UBX-CFG-PM2, which is polled first.
+ */
+void UBX::setPowerMode(const M8_POWER_SETTINGS &settings)
+{
+    m_powerSettings = settings;
+    if (M8_POWER_CONTINUOUS == settings.mode) {
+        m_powerModePending = false;
+        setLowPowerMode(false);
+    } else if (m_UbxCfgPm2.isEmpty()) {
+        m_powerModePending = true;
+        UBXMessage msgReqPm2;
+        msgReqPm2.ack = false;
+        msgReqPm2.message.append(0x06); /* Message class */
+        msgReqPm2.message.append(0x3B); /* Message id */
+        msgReqPm2.message.append(static_cast<char>(0x00)); /* Payload size */
+        msgReqPm2.message.append(static_cast<char>(0x00)); /* Payload size */
+        addMessage(msgReqPm2);
+    } else {
+        m_powerModePending = false;
+        /* flags bits 17-18: 0 = ON/OFF operation, 1 = cyclic tracking */
+        m_UbxCfgPm2[6] = (m_UbxCfgPm2.at(6) & ~0x06)
+                | ((M8_POWER_CYCLIC_TRACKING == settings.mode) ? 0x02 : 0x00);
+        for (int i = 0; i < 4; ++i) {
+            m_UbxCfgPm2[8 + i] = (settings.updatePeriodMs >> (8 * i)) & 0xFF; /* updatePeriod */
+            m_UbxCfgPm2[12 + i] = (settings.searchPeriodMs >> (8 * i)) & 0xFF; /* searchPeriod */
+        }
+        m_UbxCfgPm2[20] = settings.onTimeS & 0xFF; /* onTime */
+        m_UbxCfgPm2[21] = (settings.onTimeS >> 8) & 0xFF; /* onTime */
+
+        int payloadLen = m_UbxCfgPm2.length();
+        UBXMessage msgSetPm2;
+        msgSetPm2.ack = false;
+        msgSetPm2.message.append(0x06); /* Message class */
+        msgSetPm2.message.append(0x3B); /* Message id */
+        msgSetPm2.message.append(payloadLen & 0xFF); /* Payload size */
+        msgSetPm2.message.append((payloadLen >> 8) & 0xFF); /* Payload size */
+        msgSetPm2.message.append(m_UbxCfgPm2);
+        addMessage(msgSetPm2);
+        setLowPowerMode(true);
     }
+}
 
+void UBX::setLowPowerMode(bool on)
+{
     UBXMessage msgRXM;
     msgRXM.ack = false;
     msgRXM.message.append(0x06); /* Message class */
@@ -427,7 +665,7 @@ void UBX::setPowerSave(bool on)
     msgRXM.message.append(0x02); /* Payload size */
     msgRXM.message.append(static_cast<char>(0x00)); /* Payload size */
     msgRXM.message.append(static_cast<char>(0x00)); /* Reserved1 */
-    msgRXM.message.append(mode); /* lpMode */
+    msgRXM.message.append((on) ? 0x01 : 0x00); /* lpMode */
     addMessage(msgRXM);
 }
 
@@ -456,6 +694,209 @@ void UBX::setAutonomousAssist(bool enabled)
     }
 }
 
+/**
+ * @brief UBX::setTimeSubscription
+ * @param on Output UBX-NAV-TIMEUTC every navigation epoch
+ *
+ * While subscribed, requestTime() does not poll.
+ */
+void UBX::setTimeSubscription(bool on)
+{
+    m_timeSubscription = on;
+    if (on)
+        m_timeTimer->stop();
+
+    UBXMessage msgCfgMsg;
+    msgCfgMsg.ack = true;
+    msgCfgMsg.message.append(0x06); /* Message class */
+    msgCfgMsg.message.append(0x01); /* Message id */
+    msgCfgMsg.message.append(0x03); /* Payload size */
+    msgCfgMsg.message.append(static_cast<char>(0x00)); /* Payload size */
+    msgCfgMsg.message.append(0x01); /* msgClass */
+    msgCfgMsg.message.append(0x21); /* msgID */
+    msgCfgMsg.message.append((on) ? 0x01 : 0x00); /* rate on current port */
+    addMessage(msgCfgMsg);
+}
+
+/**
+ * @brief UBX::timeSubscription
+ * @return true if UBX-NAV-TIMEUTC was asked for every epoch. A receiver that powers up again has
+ * forgotten it, so it is sent again then.
+ */
+bool UBX::timeSubscription()
+{
+    return m_timeSubscription;
+}
+
+/**
+ * @brief UBX::gnssConfiguration
+ * @return Cached GNSS configuration, not valid until read from the receiver
+ */
+M8_GNSS_CONFIG UBX::gnssConfiguration()
+{
+    return m_gnssConfig;
+}
+
+/**
+ * @brief UBX::requestGnssConfig
+ * @param force Poll the receiver even if the configuration is cached
+ *
+ * gnssConfig is emitted from the cache when possible.
+ */
+void UBX::requestGnssConfig(bool force)
+{
+    if (m_gnssConfig.valid && !force) {
+        emit gnssConfig(m_gnssConfig);
+        return;
+    }
+
+    /* Get enabled GNSS systems */
+    UBXMessage msgGNSS;
+    msgGNSS.ack = false;
+    msgGNSS.message.append(0x0A); /* Message class */
+    msgGNSS.message.append(0x28); /* Message id */
+    msgGNSS.message.append(static_cast<char>(0x00)); /* Payload size */
+    msgGNSS.message.append(static_cast<char>(0x00)); /* Payload size */
+    addMessage(msgGNSS);
+
+    /* Get individual GNSS configurations */
+    msgGNSS.message[0] = 0x06;
+    msgGNSS.message[1] = 0x3E;
+    addMessage(msgGNSS);
+}
+
+/**
+ * @brief UBX::setGnssConfig
+ * @param config
+ * @return False if the tracking channel budget is invalid
+ *
+ * The enabled systems may not reserve more channels than are used. The GNSS engine is restarted
+ * for the configuration to take effect. The cache is only updated when the receiver
+ * acknowledges the configuration, a rejected one is read back from the receiver instead.
+ */
+bool UBX::setGnssConfig(const M8_GNSS_CONFIG &config)
+{
+    int channels = (0xFF == config.numTrkChUse) ? m_gnssConfig.numTrkChHw : config.numTrkChUse;
+    int reserved = 0;
+    bool major = false;
+    for (const M8_GNSS_BLOCK &block : config.blocks) {
+        if (block.maxTrkCh < block.resTrkCh)
+            return false;
+
+        if (block.enabled) {
+            reserved += block.resTrkCh;
+            major = major || M8_GNSS_GPS == block.gnssId || M8_GNSS_GALILEO == block.gnssId
+                    || M8_GNSS_BEIDOU == block.gnssId || M8_GNSS_GLONASS == block.gnssId;
+        }
+    }
+    if (!major || (channels > 0 && reserved > channels)) {
+        qWarning("[UBX] Invalid GNSS configuration, %d of %d channels reserved", reserved,
+                 channels);
+        return false;
+    }
+
+    int payloadLen = 4 + 8 * config.blocks.size();
+    UBXMessage msgCfgGnss;
+    msgCfgGnss.ack = true;
+    msgCfgGnss.message.append(0x06); /* Message class */
+    msgCfgGnss.message.append(0x3E); /* Message id */
+    msgCfgGnss.message.append(payloadLen & 0xFF); /* Payload size */
+    msgCfgGnss.message.append((payloadLen >> 8) & 0xFF); /* Payload size */
+    msgCfgGnss.message.append(static_cast<char>(0x00)); /* Message version */
+    msgCfgGnss.message.append(static_cast<char>(0x00)); /* numTrkChHw (read only) */
+    msgCfgGnss.message.append(config.numTrkChUse); /* numTrkChUse */
+    msgCfgGnss.message.append(config.blocks.size() & 0xFF); /* numConfigBlocks */
+    for (const M8_GNSS_BLOCK &block : config.blocks) {
+        quint32 flags = (block.flags & ~0x01u) | ((block.enabled) ? 0x01 : 0x00);
+        msgCfgGnss.message.append(block.gnssId); /* gnssId */
+        msgCfgGnss.message.append(block.resTrkCh); /* resTrkCh */
+        msgCfgGnss.message.append(block.maxTrkCh); /* maxTrkCh */
+        msgCfgGnss.message.append(static_cast<char>(0x00)); /* Reserved1 */
+        msgCfgGnss.message.append(flags & 0xFF); /* flags */
+        msgCfgGnss.message.append((flags >> 8) & 0xFF); /* flags */
+        msgCfgGnss.message.append((flags >> 16) & 0xFF); /* flags */
+        msgCfgGnss.message.append((flags >> 24) & 0xFF); /* flags */
+    }
+    addMessage(msgCfgGnss);
+
+    if (m_engineOn) {
+        /* Controlled software reset (GNSS only), keeping all navigation data */
+        UBXMessage msgRST;
+        msgRST.ack = false;
+        msgRST.message.append(0x06); /* Message class */
+        msgRST.message.append(0x04); /* Message id */
+        msgRST.message.append(0x04); /* Payload size */
+        msgRST.message.append(static_cast<char>(0x00)); /* Payload size */
+        msgRST.message.append(static_cast<char>(0x00)); /* navBbrMask */
+        msgRST.message.append(static_cast<char>(0x00)); /* navBbrMask */
+        msgRST.message.append(0x02); /* resetMode */
+        msgRST.message.append(static_cast<char>(0x00)); /* Reserved1 */
+        addMessage(msgRST);
+    }
+
+    // Cached by ack() once the receiver has accepted it
+    m_gnssConfigPending = config;
+    m_gnssConfigPending.valid = true;
+    m_gnssConfigPending.numTrkChHw = m_gnssConfig.numTrkChHw;
+    m_gnssConfigPending.supported = m_gnssConfig.supported;
+    m_gnssConfigPending.defaultGnss = m_gnssConfig.defaultGnss;
+    m_gnssConfigPending.simultaneous = m_gnssConfig.simultaneous;
+    m_gnssConfigPending.enabled = 0;
+    for (const M8_GNSS_BLOCK &block : config.blocks) {
+        if (!block.enabled)
+            continue;
+
+        switch (block.gnssId) {
+        case M8_GNSS_GPS:
+            m_gnssConfigPending.enabled |= 0x01;
+            break;
+        case M8_GNSS_GLONASS:
+            m_gnssConfigPending.enabled |= 0x02;
+            break;
+        case M8_GNSS_BEIDOU:
+            m_gnssConfigPending.enabled |= 0x04;
+            break;
+        case M8_GNSS_GALILEO:
+            m_gnssConfigPending.enabled |= 0x08;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief UBX::setGnssSystems
+ * @param mask Systems to enable, M8_GNSS_MASK() bits
+ * @return False if no major system is enabled or the configuration is invalid
+ *
+ * Keeps the channel reservations of the receiver's current configuration, which is read first
+ * if not cached. The channel budget can only be checked once it has been read.
+ */
+bool UBX::setGnssSystems(quint32 mask)
+{
+    quint32 major = M8_GNSS_MASK(M8_GNSS_GPS) | M8_GNSS_MASK(M8_GNSS_GALILEO)
+            | M8_GNSS_MASK(M8_GNSS_BEIDOU) | M8_GNSS_MASK(M8_GNSS_GLONASS);
+    if (!(mask & major)) {
+        qWarning("[UBX] Invalid GNSS systems, no major system enabled");
+        return false;
+    }
+
+    m_gnssSystems = mask;
+    if (!m_gnssConfig.valid) {
+        m_gnssSystemsPending = true;
+        requestGnssConfig(true);
+        return true;
+    }
+
+    m_gnssSystemsPending = false;
+    M8_GNSS_CONFIG config = m_gnssConfig;
+    for (M8_GNSS_BLOCK &block : config.blocks)
+        block.enabled = (mask & M8_GNSS_MASK(block.gnssId));
+    return setGnssConfig(config);
+}
+
 void UBX::requestSatelliteInfo()
 {
     UBXMessage msgReqSvInfo;
@@ -467,6 +908,36 @@ void UBX::requestSatelliteInfo()
     addMessage(msgReqSvInfo);
 }
 
+/**
+ * @brief UBX::sendMessage
+ * @param message Class, id, length and payload of a UBX message
+ *
+ * Queues a message built outside the library. CFG messages wait for their acknowledgement,
+ * except UBX-CFG-RST, which the receiver does not acknowledge. Writes of UBX-CFG-GNSS and
+ * UBX-CFG-PM2 are refused, as they would bypass the cached configurations. Use setGnssConfig()
+ * and setPowerMode() instead.
+ */
+void UBX::sendMessage(const QByteArray &message)
+{
+    if (message.size() < 4) {
+        qWarning("[UBX] Message too short to send");
+        return;
+    }
+
+    bool cfg = (0x06 == message.at(0));
+    bool poll = (0 == message.at(2) && 0 == message.at(3));
+    if (cfg && !poll && (0x3E == message.at(1) || 0x3B == message.at(1))) {
+        qWarning("[UBX] Refusing UBX-CFG-%s, configure it through the library",
+                 (0x3E == message.at(1)) ? "GNSS" : "PM2");
+        return;
+    }
+
+    UBXMessage msg;
+    msg.ack = cfg && 0x04 != message.at(1);
+    msg.message = message;
+    addMessage(msg);
+}
+
 void UBX::requestNavigationDatabase()
 {
     UBXMessage msgReqMgaDbd;
@@ -493,6 +964,9 @@ void UBX::uploadNavigationDatabase(QByteArray payload)
 void UBX::requestTime()
 {
     UBX_D(__PRETTY_FUNCTION__);
+    if (m_timeSubscription)
+        return;
+
     if (!m_timeTimer->isActive())
         m_timeTimer->start();
 
@@ -512,6 +986,9 @@ void UBX::addMessage(UBXMessage message, bool priority)
     } else {
         m_sendQueue.append(message);
     }
+    p_metrics->sendQueueDepth.set(static_cast<quint64>(m_sendQueue.size()));
+    if (p_metrics->sendQueueDepth.value() > p_metrics->sendQueueMaxDepth.value())
+        p_metrics->sendQueueMaxDepth.set(p_metrics->sendQueueDepth.value());
     sendNext();
 }
 
@@ -522,6 +999,8 @@ void UBX::sendNext()
     } else {
         if (!m_sendQueue.isEmpty()) {
             UBXMessage ubxMessage = m_sendQueue.takeFirst();
+            p_metrics->sendQueueDepth.set(static_cast<quint64>(m_sendQueue.size()));
+            p_metrics->messagesSent.add();
             // UBX_D("Sending: " << QByteArray::number(ubxMessage.message[0], 16) << ", " <<
             // QByteArray::number(ubxMessage.message[1], 16));
             encodeAndSend(ubxMessage.message);
@@ -537,23 +1016,26 @@ void UBX::sendNext()
     }
 }
 
-void UBX::encodeAndSend(const QByteArray &message)
+/**
+ * @brief UBX::encode
+ * @param message Class, id, length and payload
+ * @return Message with sync chars and checksum, ready for the device
+ */
+QByteArray UBX::encode(const QByteArray &message)
 {
-    quint8 ck_a = 0;
-    quint8 ck_b = 0;
-    for (int i = 0; i < message.size(); ++i) {
-        ck_a += (message.at(i) & 0xFF);
-        ck_a = ck_a & 0xFF;
-        ck_b += ck_a;
-        ck_b = ck_b & 0xFF;
-    }
+    quint16 checksum = Kernels::ubxChecksum(message.constData(), message.size());
     QByteArray data;
     data.append(static_cast<char>(0xB5));
     data.append(static_cast<char>(0x62));
     data.append(message);
-    data.append(static_cast<char>(ck_a));
-    data.append(static_cast<char>(ck_b));
+    data.append(static_cast<char>(checksum & 0xFF));
+    data.append(static_cast<char>(checksum >> 8));
+    return data;
+}
 
+void UBX::encodeAndSend(const QByteArray &message)
+{
+    QByteArray data = encode(message);
 #ifdef UBX_DEBUG
     /*UBX_D("encodeAndSend(");
     for (int i = 0; i < data.size(); ++i) {
@@ -561,30 +1043,67 @@ void UBX::encodeAndSend(const QByteArray &message)
     }
     UBX_D(")");*/
 #endif
-    emit writeMessage(data);
+    if (!p_device->send(data)) {
+        p_metrics->txQueueDrops.add();
+        qWarning("[UBX] Transmit queue full, message dropped");
+    }
 }
 
-void UBX::ack()
+/**
+ * @brief UBX::ack
+ * @param acknowledged false for UBX-ACK-NAK
+ * @param messageClass Class of the message acknowledged
+ * @param id Id of the message acknowledged
+ *
+ * Only an acknowledgement of the message waited for counts, so a late one for a message that
+ * was resent without waiting is ignored. A GNSS configuration is cached when acknowledged. When
+ * rejected, the cache is read back from the receiver, as a NAK does not tell what it kept.
+ */
+void UBX::ack(bool acknowledged, char messageClass, char id)
 {
-    if (m_ackTimer->isActive()) {
+    if (m_ackTimer->isActive() && m_ackQueue.message.size() >= 2
+        && messageClass == m_ackQueue.message.at(0) && id == m_ackQueue.message.at(1)) {
         m_ackTimer->stop();
         // UBX_D("Ack/Nack received");
+        if (0x06 == m_ackQueue.message.at(0) && 0x3E == m_ackQueue.message.at(1)) {
+            if (acknowledged) {
+                m_gnssConfig = m_gnssConfigPending;
+                emit gnssConfig(m_gnssConfig);
+            } else {
+                qWarning("[UBX] GNSS configuration rejected by the receiver");
+                m_gnssConfig.valid = false;
+                requestGnssConfig(true);
+            }
+        }
         m_ackQueue.message.clear();
         m_ackQueue.ack = false;
         sendNext();
     } else {
-        UBX_D("Ack received when not expected");
+        UBX_D("Ack received when not expected, or for another message");
     }
 }
 
+/**
+ * @brief UBX::ackTimeout
+ *
+ * The message is sent once more without waiting for its acknowledgement. A GNSS configuration
+ * sent that way is read back from the receiver afterwards.
+ */
 void UBX::ackTimeout()
 {
     UBX_D("Ack timeout. Resending message");
+    p_metrics->ackTimeouts.add();
     if (!m_ackQueue.message.isEmpty()) {
+        bool gnss = (0x06 == m_ackQueue.message.at(0) && 0x3E == m_ackQueue.message.at(1));
         // Only try resend once
         m_ackQueue.ack = false;
         m_sendQueue.prepend(m_ackQueue);
         m_ackQueue.message.clear();
+        if (gnss) {
+            // Polled after the resend
+            m_gnssConfig.valid = false;
+            requestGnssConfig(true);
+        }
         sendNext();
     }
 }
@@ -27,25 +27,44 @@ SOFTWARE.
 #include <QList>
 #include <QObject>
 #include "ubxmessage.h"
+#include "m8_fix.h"
+#include "m8_gnss.h"
+#include "m8_power.h"
 #include "m8_sv_info.h"
+#include "m8_time.h"
 
 class M8Device;
+class Sinks;
+class Metrics;
 class QTimer;
 
 class UBX : public QObject
 {
     Q_OBJECT
 public:
-    explicit UBX(M8Device *device, QObject *parent = nullptr);
+    explicit UBX(M8Device *device, Metrics *metrics, QObject *parent = nullptr);
 
-    bool crcCheck(const QByteArray &msg);
-    void parse(const QByteArray &msg);
+    static QByteArray encode(const QByteArray &message);
+    static bool crcCheck(const QByteArray &msg);
+    static bool decodeTimeUtc(const QByteArray &msg, M8_TIME_SAMPLE *sample);
+    static bool decodeSatelliteInfo(const QByteArray &msg, M8_SV_INFO *info);
+    static bool decodeNavPvt(const QByteArray &msg, M8_FIX *fix, quint32 *iTOW);
+    void parse(const QByteArray &msg, qint64 timestamp);
+    void setSinks(Sinks *sinks, bool fixes);
     void configureNMEA();
+    void enableNavigationSolution();
     void injectTimeAssistance();
     void setEngineState(bool on);
-    void setPowerSave(bool on);
+    void setPowerMode(const M8_POWER_SETTINGS &settings);
     void setAutonomousAssist(bool enabled);
+    void setTimeSubscription(bool on);
+    bool timeSubscription();
+    M8_GNSS_CONFIG gnssConfiguration();
+    void requestGnssConfig(bool force = false);
+    bool setGnssConfig(const M8_GNSS_CONFIG &config);
+    bool setGnssSystems(quint32 mask);
     void requestSatelliteInfo();
+    void sendMessage(const QByteArray &message);
     void requestNavigationDatabase();
     void uploadNavigationDatabase(QByteArray payload);
 
@@ -54,24 +73,48 @@ public slots:
 
 signals:
     void systemTimeDrift(qint64 offsetMilliseconds);
-    void satelliteInfo(M8_SV_INFO info);
-    void writeMessage(const QByteArray &msg);
+    void timeSample(const M8_TIME_SAMPLE &sample);
+    void gnssConfig(M8_GNSS_CONFIG config);
+    void satelliteInfo(const M8_SV_INFO &info);
+    void newFix(const M8_FIX &fix);
+    void fixLost(qint64 timestamp);
     void saveNavigationEntry(QByteArray entry);
 
 private slots:
     void addMessage(UBXMessage message, bool priority = false);
     void sendNext();
     void encodeAndSend(const QByteArray &message);
-    void ack();
+    void ack(bool acknowledged, char messageClass, char id);
     void ackTimeout();
 
 private:
+    qint64 hostTime(qint64 timestamp, int frameSize);
+    void setLowPowerMode(bool on);
+
+private:
+    M8Device *p_device;
+    Metrics *p_metrics;
+    Sinks *p_sinks;
+    bool m_fixSinks;
+    int m_baudRate;
     UBXMessage m_ackQueue;
     QList<UBXMessage> m_sendQueue;
     QTimer *m_ackTimer;
     QTimer *m_timeTimer;
     QByteArray m_UbxCfgNavx5;
     bool m_autonomousAssist;
+    bool m_timeSubscription;
+    QByteArray m_UbxCfgPm2;
+    M8_POWER_SETTINGS m_powerSettings;
+    bool m_powerModePending;
+    M8_GNSS_CONFIG m_gnssConfig;
+    M8_GNSS_CONFIG m_gnssConfigPending;
+    quint32 m_gnssSystems;
+    bool m_gnssSystemsPending;
+    bool m_engineOn;
+    quint32 m_dopITow;
+    float m_hdop;
+    float m_vdop;
 };
 
 #endif // UBX_H
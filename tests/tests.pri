@@ -0,0 +1,21 @@
+QT -= gui
+QT += testlib
+
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+LIBS += -lrt
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Tests build the library sources they need, so they can reach classes that are not exported
+M8_SRC = $$PWD/../src
+
+INCLUDEPATH += \
+    $$PWD/../include/ \
+    $$M8_SRC
+
+DESTDIR = $$PWD/../bin/tests/
+OBJECTS_DIR = $$PWD/../build/tests/$$TARGET/.obj
+MOC_DIR = $$PWD/../build/tests/$$TARGET/.moc
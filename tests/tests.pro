@@ -0,0 +1,10 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_decoder \
+    tst_history \
+    tst_kernels \
+    tst_ntpshm \
+    tst_receiver \
+    tst_scheduler \
+    tst_track
@@ -0,0 +1,284 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_decoder.h"
+#include "m8_record.h"
+#include <QTemporaryDir>
+#include <QtTest>
+
+#define EPOCHS 2000
+
+static QByteArray nmea(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (char c : body)
+        checksum ^= static_cast<quint8>(c);
+    return '$' + body + '*' + QByteArray::number(checksum, 16).toUpper().rightJustified(2, '0')
+            + "\r\n";
+}
+
+static QByteArray ubx(quint8 messageClass, quint8 id, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.append(static_cast<char>(0xB5));
+    frame.append(0x62);
+    frame.append(static_cast<char>(messageClass));
+    frame.append(static_cast<char>(id));
+    frame.append(static_cast<char>(payload.size() & 0xFF));
+    frame.append(static_cast<char>(payload.size() >> 8));
+    frame.append(payload);
+    quint8 a = 0;
+    quint8 b = 0;
+    for (int i = 2; i < frame.size(); ++i) {
+        a += static_cast<quint8>(frame.at(i));
+        b += a;
+    }
+    frame.append(static_cast<char>(a));
+    frame.append(static_cast<char>(b));
+    return frame;
+}
+
+/**
+ * @brief Decodes one capture sequentially and in chunks and compares the results
+ */
+class TestDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sequential();
+    void chunked_data();
+    void chunked();
+    void recording();
+
+private:
+    quint32 random();
+    QByteArray epoch(int i);
+    void compare(const M8Decoder &actual, const M8Decoder &expected);
+
+private:
+    QTemporaryDir m_dir;
+    QString m_capture;
+    QString m_recording;
+    quint32 m_seed;
+    int m_positions;
+    M8Decoder m_sequential;
+};
+
+quint32 TestDecoder::random()
+{
+    m_seed = m_seed * 1664525u + 1013904223u;
+    return m_seed >> 8;
+}
+
+/**
+ * @brief TestDecoder::epoch
+ * @param i
+ * @return What the receiver sends in one navigation epoch, with some noise
+ *
+ * Every few epochs carry a long frame with a complete sentence and UBX frame inside its payload,
+ * so chunks can start within a frame.
+ */
+QByteArray TestDecoder::epoch(int i)
+{
+    QByteArray gga = "GPGGA," + QByteArray::number(100000 + i % 60) + ".00,5538."
+            + QByteArray::number(100000 + i) + ",N,01232." + QByteArray::number(500000 + i)
+            + ",E,1,0" + QByteArray::number(4 + i % 6) + ",1.4,61.7,M,40.5,M,,";
+    QByteArray data = nmea(gga);
+    m_positions++;
+
+    QByteArray timeUtc(20, 0);
+    timeUtc[12] = static_cast<char>(2026 & 0xFF);
+    timeUtc[13] = static_cast<char>(2026 >> 8);
+    timeUtc[14] = 10;
+    timeUtc[15] = 19;
+    timeUtc[16] = static_cast<char>(i / 3600 % 24);
+    timeUtc[17] = static_cast<char>(i / 60 % 60);
+    timeUtc[18] = static_cast<char>(i % 60);
+    timeUtc[19] = 0x07;
+    data += ubx(0x01, 0x21, timeUtc);
+
+    int satellites = 1 + static_cast<int>(random() % 40);
+    QByteArray sat(8 + 12 * satellites, 0);
+    sat[5] = static_cast<char>(satellites);
+    for (int s = 0; s < satellites; ++s) {
+        sat[8 + 12 * s + 2] = static_cast<char>(random() % 50);
+        sat[8 + 12 * s + 8] = static_cast<char>(random() & 0xFF);
+    }
+    data += ubx(0x01, 0x35, sat);
+
+    if (i % 7 == 0) {
+        QByteArray raw(1500, 0);
+        for (char &c : raw)
+            c = static_cast<char>(random() & 0xFF);
+        QByteArray inner = nmea(gga) + ubx(0x01, 0x21, timeUtc);
+        raw.replace(static_cast<int>(random() % 1000), inner.size(), inner);
+        data += ubx(0x02, 0x15, raw);
+    }
+    if (i % 11 == 0) {
+        // Noise without sync chars, then a sentence with a broken checksum
+        QByteArray noise(static_cast<int>(random() % 300), 0);
+        for (char &c : noise)
+            c = static_cast<char>('a' + random() % 26);
+        data += noise;
+        QByteArray broken = nmea(gga);
+        broken[broken.size() - 3] = (broken.at(broken.size() - 3) == '0') ? '1' : '0';
+        data += broken;
+    }
+    return data;
+}
+
+void TestDecoder::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_seed = 1;
+    m_positions = 0;
+    QByteArray capture;
+    for (int i = 0; i < EPOCHS; ++i)
+        capture += epoch(i);
+
+    m_capture = m_dir.filePath("capture.ubx");
+    QFile file(m_capture);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(capture), static_cast<qint64>(capture.size()));
+    file.close();
+
+    // The same stream as recorded, in reads of any size and with commands in between
+    m_recording = m_dir.filePath("capture.m8rec");
+    QFile recording(m_recording);
+    QVERIFY(recording.open(QIODevice::WriteOnly));
+    M8_RECORD_HEADER header;
+    memset(&header, 0, sizeof(header));
+    header.magic = M8_RECORD_MAGIC;
+    header.version = M8_RECORD_VERSION;
+    header.headerSize = sizeof(header);
+    recording.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    qint64 timestamp = 0;
+    for (int offset = 0; offset < capture.size();) {
+        M8_RECORD_CHUNK chunk;
+        memset(&chunk, 0, sizeof(chunk));
+        chunk.timestamp = timestamp++;
+        QByteArray data;
+        if (random() % 5 == 0) {
+            data = ubx(0x06, 0x08, QByteArray(6, 0));
+            chunk.direction = M8_RECORD_TX;
+        } else {
+            data = capture.mid(offset, 1 + static_cast<int>(random() % 512));
+            offset += data.size();
+            chunk.direction = M8_RECORD_RX;
+        }
+        chunk.size = static_cast<quint32>(data.size());
+        recording.write(reinterpret_cast<const char *>(&chunk), sizeof(chunk));
+        recording.write(data);
+    }
+    recording.close();
+
+    m_sequential.setThreads(1);
+    m_sequential.setChunkSize(capture.size() + 1);
+    QVERIFY(m_sequential.decode(m_capture));
+}
+
+void TestDecoder::compare(const M8Decoder &actual, const M8Decoder &expected)
+{
+    QCOMPARE(actual.positions().offset, expected.positions().offset);
+    QCOMPARE(actual.positions().utcTimeOfDay, expected.positions().utcTimeOfDay);
+    QCOMPARE(actual.positions().latitude, expected.positions().latitude);
+    QCOMPARE(actual.positions().longitude, expected.positions().longitude);
+    QCOMPARE(actual.positions().altitude, expected.positions().altitude);
+    QCOMPARE(actual.positions().satellites, expected.positions().satellites);
+    QCOMPARE(actual.positions().hdop, expected.positions().hdop);
+    QCOMPARE(actual.times().offset, expected.times().offset);
+    QCOMPARE(actual.times().receiverTime, expected.times().receiverTime);
+    QCOMPARE(actual.times().accuracy, expected.times().accuracy);
+    QCOMPARE(actual.times().valid, expected.times().valid);
+    QCOMPARE(actual.satellites().offset, expected.satellites().offset);
+    QCOMPARE(actual.satellites().iTOW, expected.satellites().iTOW);
+    QCOMPARE(actual.satellites().numSvs, expected.satellites().numSvs);
+    QCOMPARE(actual.satellites().used, expected.satellites().used);
+    QCOMPARE(actual.satellites().meanCno, expected.satellites().meanCno);
+
+    M8_DECODER_STATS a = actual.statistics();
+    M8_DECODER_STATS e = expected.statistics();
+    QCOMPARE(a.bytes, e.bytes);
+    QCOMPARE(a.nmeaFrames, e.nmeaFrames);
+    QCOMPARE(a.ubxFrames, e.ubxFrames);
+    QCOMPARE(a.nmeaChecksumErrors, e.nmeaChecksumErrors);
+    QCOMPARE(a.ubxChecksumErrors, e.ubxChecksumErrors);
+    QCOMPARE(a.framesRecovered, e.framesRecovered);
+    QCOMPARE(a.resyncs, e.resyncs);
+    QCOMPARE(a.bytesDiscarded, e.bytesDiscarded);
+}
+
+void TestDecoder::sequential()
+{
+    M8_DECODER_STATS stats = m_sequential.statistics();
+    QCOMPARE(stats.chunks, 1u);
+    QCOMPARE(m_sequential.positions().offset.size(), m_positions);
+    QCOMPARE(m_sequential.times().offset.size(), EPOCHS);
+    QCOMPARE(m_sequential.satellites().offset.size(), EPOCHS);
+    QCOMPARE(stats.nmeaChecksumErrors, static_cast<quint64>((EPOCHS + 10) / 11));
+}
+
+void TestDecoder::chunked_data()
+{
+    QTest::addColumn<qint64>("chunkSize");
+    QTest::addColumn<int>("threads");
+    QTest::newRow("4 KiB") << 4096LL << 4;
+    QTest::newRow("4 KiB + 1") << 4097LL << 3;
+    QTest::newRow("10000 bytes") << 10000LL << 8;
+    QTest::newRow("64 KiB") << 65536LL << 2;
+    QTest::newRow("one thread") << 4096LL << 1;
+}
+
+/**
+ * @brief TestDecoder::chunked
+ *
+ * Chunk boundaries fall at arbitrary places of the stream, so frames span them and some chunks
+ * start at a frame inside the payload of another.
+ */
+void TestDecoder::chunked()
+{
+    QFETCH(qint64, chunkSize);
+    QFETCH(int, threads);
+
+    M8Decoder decoder;
+    decoder.setThreads(threads);
+    decoder.setChunkSize(chunkSize);
+    QVERIFY(decoder.decode(m_capture));
+    QVERIFY(decoder.statistics().chunks > 1);
+    compare(decoder, m_sequential);
+}
+
+void TestDecoder::recording()
+{
+    M8Decoder decoder;
+    decoder.setThreads(4);
+    decoder.setChunkSize(4096);
+    QVERIFY(decoder.decode(m_recording));
+    compare(decoder, m_sequential);
+}
+
+QTEST_GUILESS_MAIN(TestDecoder)
+
+#include "tst_decoder.moc"
@@ -0,0 +1,32 @@
+TARGET = tst_decoder
+include(../tests.pri)
+
+SOURCES += \
+    tst_decoder.cpp \
+    $$M8_SRC/framer.cpp \
+    $$M8_SRC/ioreactor.cpp \
+    $$M8_SRC/kernels.cpp \
+    $$M8_SRC/m8decoder.cpp \
+    $$M8_SRC/m8device.cpp \
+    $$M8_SRC/metrics.cpp \
+    $$M8_SRC/nmea.cpp \
+    $$M8_SRC/recorder.cpp \
+    $$M8_SRC/recordreader.cpp \
+    $$M8_SRC/replay.cpp \
+    $$M8_SRC/sinks.cpp \
+    $$M8_SRC/transport.cpp \
+    $$M8_SRC/ubx.cpp
+
+HEADERS += \
+    $$M8_SRC/framer.h \
+    $$M8_SRC/ioreactor.h \
+    $$M8_SRC/kernels.h \
+    $$M8_SRC/m8device.h \
+    $$M8_SRC/metrics.h \
+    $$M8_SRC/nmea.h \
+    $$M8_SRC/recorder.h \
+    $$M8_SRC/recordreader.h \
+    $$M8_SRC/replay.h \
+    $$M8_SRC/sinks.h \
+    $$M8_SRC/transport.h \
+    $$M8_SRC/ubx.h
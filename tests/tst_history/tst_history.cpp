@@ -0,0 +1,221 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_history.h"
+#include <QtTest>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#define CAPACITY 5
+#define TIMESTAMP_STEP 1000
+
+/* Every field is derived from the fix number, so a fix mixing two writes shows */
+static M8_FIX fix(qint64 n)
+{
+    M8_FIX fix;
+    memset(&fix, 0, sizeof(fix));
+    fix.timestamp = n * TIMESTAMP_STEP;
+    fix.latitude = n * 1e-3;
+    fix.longitude = -n * 1e-3;
+    fix.altitude = static_cast<float>(n % 10000);
+    fix.satellites = static_cast<quint8>(n);
+    fix.fixType = static_cast<quint8>(n % 4);
+    fix.utcTimeOfDay = static_cast<qint32>(n);
+    fix.horizontalAccuracy = static_cast<float>(n % 1000);
+    fix.vdop = static_cast<float>(n % 100);
+    return fix;
+}
+
+static bool consistent(const M8_FIX &f)
+{
+    if (f.timestamp % TIMESTAMP_STEP)
+        return false;
+    M8_FIX expected = fix(f.timestamp / TIMESTAMP_STEP);
+    return f.latitude == expected.latitude && f.longitude == expected.longitude
+            && f.altitude == expected.altitude && f.satellites == expected.satellites
+            && f.fixType == expected.fixType && f.utcTimeOfDay == expected.utcTimeOfDay
+            && f.horizontalAccuracy == expected.horizontalAccuracy && f.vdop == expected.vdop;
+}
+
+/* Fix numbers of the result, or -1 for a fix that is not consistent */
+static QVector<qint64> numbers(const QVector<M8_FIX> &fixes)
+{
+    QVector<qint64> result;
+    for (const M8_FIX &f : fixes)
+        result.append(consistent(f) ? f.timestamp / TIMESTAMP_STEP : -1);
+    return result;
+}
+
+static QVector<qint64> range(qint64 first, qint64 last)
+{
+    QVector<qint64> result;
+    for (qint64 n = first; n <= last; ++n)
+        result.append(n);
+    return result;
+}
+
+/**
+ * @brief Queries M8FixHistory before and after the ring wraps, and while it is written
+ */
+class TestHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty();
+    void latest_data();
+    void latest();
+    void window_data();
+    void window();
+    void concurrentQueries();
+};
+
+void TestHistory::empty()
+{
+    M8FixHistory history(CAPACITY);
+    QCOMPARE(history.count(), 0ull);
+    QVERIFY(history.latest(CAPACITY).isEmpty());
+    QVERIFY(history.window(0, 1000000).isEmpty());
+    QVERIFY(history.window(1000000, 0).isEmpty());
+}
+
+void TestHistory::latest_data()
+{
+    QTest::addColumn<int>("added");
+    QTest::addColumn<int>("fixes");
+    QTest::addColumn<QVector<qint64>>("expected");
+
+    QTest::newRow("none requested") << 3 << 0 << QVector<qint64>();
+    QTest::newRow("negative") << 3 << -1 << QVector<qint64>();
+    QTest::newRow("fewer added") << 3 << CAPACITY << range(0, 2);
+    QTest::newRow("full") << CAPACITY << CAPACITY << range(0, CAPACITY - 1);
+    QTest::newRow("one") << 20 << 1 << range(19, 19);
+    QTest::newRow("wrapped") << 20 << 3 << range(17, 19);
+    QTest::newRow("wrapped, all") << 20 << CAPACITY << range(15, 19);
+    QTest::newRow("more than kept") << 20 << 100 << range(15, 19);
+}
+
+void TestHistory::latest()
+{
+    QFETCH(int, added);
+    QFETCH(int, fixes);
+    QFETCH(QVector<qint64>, expected);
+
+    M8FixHistory history(CAPACITY);
+    for (int n = 0; n < added; ++n)
+        history.fix(fix(n));
+    QCOMPARE(history.count(), static_cast<quint64>(added));
+    QCOMPARE(numbers(history.latest(fixes)), expected);
+}
+
+/**
+ * @brief TestHistory::window_data
+ *
+ * Fixes 0 to 19 are added with a capacity of 5, so 15 to 19 are kept in slots that have wrapped
+ * around several times.
+ */
+void TestHistory::window_data()
+{
+    QTest::addColumn<qint64>("from");
+    QTest::addColumn<qint64>("to");
+    QTest::addColumn<QVector<qint64>>("expected");
+
+    const qint64 step = TIMESTAMP_STEP;
+    QTest::newRow("all") << 0ll << 100 * step << range(15, 19);
+    QTest::newRow("exact bounds") << 16 * step << 18 * step << range(16, 18);
+    QTest::newRow("between fixes") << 16 * step + 1 << 18 * step - 1 << range(17, 17);
+    QTest::newRow("one instant") << 17 * step << 17 * step << range(17, 17);
+    QTest::newRow("no fix at instant") << 17 * step + 1 << 17 * step + 1 << QVector<qint64>();
+    QTest::newRow("no longer kept") << 0ll << 14 * step << QVector<qint64>();
+    QTest::newRow("partly kept") << 10 * step << 16 * step << range(15, 16);
+    QTest::newRow("after latest") << 20 * step << 30 * step << QVector<qint64>();
+    QTest::newRow("to before from") << 18 * step << 16 * step << QVector<qint64>();
+}
+
+void TestHistory::window()
+{
+    QFETCH(qint64, from);
+    QFETCH(qint64, to);
+    QFETCH(QVector<qint64>, expected);
+
+    M8FixHistory history(CAPACITY);
+    for (int n = 0; n < 20; ++n)
+        history.fix(fix(n));
+    QCOMPARE(numbers(history.window(from, to)), expected);
+}
+
+/**
+ * @brief TestHistory::concurrentQueries
+ *
+ * Results must be consistent fixes numbered without gaps. A query may give up after racing the
+ * writer too often and return nothing, but most must not.
+ */
+void TestHistory::concurrentQueries()
+{
+    const int capacity = 64;
+    M8FixHistory history(capacity);
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (qint64 n = 0; n < 2000000; ++n)
+            history.fix(fix(n));
+        done = true;
+    });
+
+    int queries = 0;
+    int answered = 0;
+    int bad = 0;
+    while (!done) {
+        ++queries;
+        QVector<qint64> latest = numbers(history.latest(capacity));
+        QVector<qint64> window;
+        qint64 count = static_cast<qint64>(history.count());
+        if (count > capacity) {
+            qint64 from = (count - capacity / 2) * TIMESTAMP_STEP;
+            window = numbers(history.window(from, from + 10 * TIMESTAMP_STEP));
+            for (qint64 n : window) {
+                if (n < from / TIMESTAMP_STEP || n > from / TIMESTAMP_STEP + 10)
+                    ++bad;
+            }
+        }
+        if (!latest.isEmpty())
+            ++answered;
+        for (const QVector<qint64> &result : { latest, window }) {
+            for (int i = 0; i < result.size(); ++i) {
+                if (result.at(i) < 0 || (i > 0 && result.at(i) != result.at(i - 1) + 1))
+                    ++bad;
+            }
+        }
+        if (latest.size() > capacity)
+            ++bad;
+    }
+    writer.join();
+
+    QCOMPARE(bad, 0);
+    QVERIFY(answered > queries / 2);
+    QCOMPARE(numbers(history.latest(capacity)), range(2000000 - capacity, 2000000 - 1));
+}
+
+QTEST_GUILESS_MAIN(TestHistory)
+
+#include "tst_history.moc"
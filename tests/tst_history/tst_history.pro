@@ -0,0 +1,7 @@
+TARGET = tst_history
+include(../tests.pri)
+
+SOURCES += \
+    tst_history.cpp \
+    $$M8_SRC/m8history.cpp \
+    $$M8_SRC/sink.cpp
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "kernels.h"
+#include <QtTest>
+
+#define BUFFER_SIZE 512
+#define MAX_OFFSET 64
+#define MAX_LENGTH 200
+
+/**
+ * @brief Runs every version of the kernels the CPU supports against the scalar ones
+ *
+ * Lengths and offsets cover the vector widths and the tails after them, at every alignment.
+ */
+class TestKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void findFrameStart_data();
+    void findFrameStart();
+    void checksums();
+
+private:
+    void fill(int density);
+
+private:
+    Kernels::Isa m_isa;
+    char m_buffer[BUFFER_SIZE];
+    quint32 m_seed;
+};
+
+void TestKernels::initTestCase()
+{
+    m_isa = Kernels::isa();
+    QVERIFY(Kernels::supported(Kernels::ISA_SCALAR));
+    QVERIFY(Kernels::supported(m_isa));
+    for (int isa = 0; isa < Kernels::ISA_COUNT; ++isa) {
+        qInfo("%s: %s", Kernels::name(static_cast<Kernels::Isa>(isa)),
+              Kernels::supported(static_cast<Kernels::Isa>(isa)) ? "supported" : "not supported");
+    }
+}
+
+void TestKernels::cleanupTestCase()
+{
+    QVERIFY(Kernels::setIsa(m_isa));
+}
+
+/**
+ * @brief TestKernels::fill
+ * @param density One byte in density is '$' or a UBX sync char, 0 for none
+ *
+ * The other bytes include the values next to them, which a wrong compare would also match.
+ */
+void TestKernels::fill(int density)
+{
+    m_seed = 1;
+    for (char &c : m_buffer) {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        quint32 r = m_seed >> 8;
+        if (density > 0 && r % static_cast<quint32>(density) == 0)
+            c = (r & 0x100) ? '$' : static_cast<char>(0xB5);
+        else if ((r & 0xFF) == '$' || (r & 0xFF) == 0xB5)
+            c = static_cast<char>((r & 0xFF) ^ 0x01);
+        else
+            c = static_cast<char>(r & 0xFF);
+    }
+}
+
+void TestKernels::findFrameStart_data()
+{
+    QTest::addColumn<int>("density");
+    QTest::newRow("none") << 0;
+    QTest::newRow("sparse") << 256;
+    QTest::newRow("dense") << 8;
+}
+
+void TestKernels::findFrameStart()
+{
+    QFETCH(int, density);
+    fill(density);
+
+    for (int isa = 0; isa < Kernels::ISA_COUNT; ++isa) {
+        if (!Kernels::setIsa(static_cast<Kernels::Isa>(isa)))
+            continue;
+        for (int offset = 0; offset < MAX_OFFSET; ++offset) {
+            for (int length = 0; length <= MAX_LENGTH; ++length) {
+                const char *data = m_buffer + offset;
+                int expected = length;
+                for (int i = 0; i < length; ++i) {
+                    if ('$' == data[i] || static_cast<char>(0xB5) == data[i]) {
+                        expected = i;
+                        break;
+                    }
+                }
+                int actual = Kernels::findFrameStart(data, length);
+                if (actual != expected) {
+                    qWarning("%s, offset %d, length %d", Kernels::name(Kernels::isa()), offset,
+                             length);
+                }
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+}
+
+void TestKernels::checksums()
+{
+    fill(16);
+    for (int offset = 0; offset < MAX_OFFSET; ++offset) {
+        for (int length = 0; length <= MAX_LENGTH; ++length) {
+            const char *data = m_buffer + offset;
+            QCOMPARE(Kernels::nmeaChecksum(data, length),
+                     Kernels::nmeaChecksumScalar(data, length));
+            QCOMPARE(Kernels::ubxChecksum(data, length), Kernels::ubxChecksumScalar(data, length));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKernels)
+
+#include "tst_kernels.moc"
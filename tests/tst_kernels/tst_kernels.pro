@@ -0,0 +1,9 @@
+TARGET = tst_kernels
+include(../tests.pri)
+
+SOURCES += \
+    tst_kernels.cpp \
+    $$M8_SRC/kernels.cpp
+
+HEADERS += \
+    $$M8_SRC/kernels.h
@@ -0,0 +1,221 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "ntpshm.h"
+#include <QtTest>
+#include <atomic>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <thread>
+
+#define NTPD_BASE 0x4E545030
+#define TEST_UNIT 42
+
+/* The segment as ntpd and chrony see it */
+struct NtpSegment {
+    int mode;
+    int count;
+    time_t clockTimeStampSec;
+    int clockTimeStampUSec;
+    time_t receiveTimeStampSec;
+    int receiveTimeStampUSec;
+    int leap;
+    int precision;
+    int nsamples;
+    int valid;
+    unsigned clockTimeStampNSec;
+    unsigned receiveTimeStampNSec;
+    int dummy[8];
+};
+
+static M8_TIME_SAMPLE timeSample(qint64 receiverTime, qint64 hostTime)
+{
+    M8_TIME_SAMPLE sample;
+    sample.captureTimestamp = 0;
+    sample.hostTime = hostTime;
+    sample.receiverTime = receiverTime;
+    sample.offset = receiverTime - hostTime;
+    sample.accuracy = 50;
+    sample.valid = M8_TIME_VALID_TOW | M8_TIME_VALID_WKN | M8_TIME_VALID_UTC;
+    return sample;
+}
+
+/**
+ * @brief Feeds NtpShm directly and reads the segment back the way a refclock driver does
+ */
+class TestNtpShm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void header();
+    void sample();
+    void invalidSample();
+    void latency();
+    void concurrentReads();
+
+private:
+    bool read(NtpSegment *out);
+
+private:
+    NtpShm *m_feeder;
+    volatile NtpSegment *m_segment;
+};
+
+void TestNtpShm::initTestCase()
+{
+    // A segment left by an earlier run may have another size
+    int shmid = shmget(static_cast<key_t>(NTPD_BASE + TEST_UNIT), 0, 0);
+    if (shmid >= 0)
+        shmctl(shmid, IPC_RMID, nullptr);
+
+    m_feeder = new NtpShm(TEST_UNIT, 0, nullptr, this);
+    QVERIFY(m_feeder->isAvailable());
+    shmid = shmget(static_cast<key_t>(NTPD_BASE + TEST_UNIT), sizeof(NtpSegment), 0);
+    QVERIFY(shmid >= 0);
+    void *p = shmat(shmid, nullptr, 0);
+    QVERIFY(p != reinterpret_cast<void *>(-1));
+    m_segment = static_cast<NtpSegment *>(p);
+}
+
+void TestNtpShm::cleanupTestCase()
+{
+    delete m_feeder;
+    shmdt(const_cast<NtpSegment *>(m_segment));
+    int shmid = shmget(static_cast<key_t>(NTPD_BASE + TEST_UNIT), 0, 0);
+    if (shmid >= 0)
+        shmctl(shmid, IPC_RMID, nullptr);
+}
+
+/**
+ * @brief TestNtpShm::read
+ * @param out
+ * @return true for a complete sample, which is then marked as consumed
+ *
+ * Mode 1 of the refclock drivers: a sample is only used when it is valid and the count did not
+ * change while it was copied.
+ */
+bool TestNtpShm::read(NtpSegment *out)
+{
+    int count = m_segment->count;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    *out = *const_cast<NtpSegment *>(m_segment);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!out->valid || count != m_segment->count)
+        return false;
+    m_segment->valid = 0;
+    return true;
+}
+
+void TestNtpShm::header()
+{
+    QCOMPARE(m_segment->mode, 1);
+    QCOMPARE(m_segment->valid, 0);
+}
+
+void TestNtpShm::sample()
+{
+    int count = m_segment->count;
+    m_feeder->timeSample(timeSample(1700000000123456789LL, 1700000000100000000LL));
+    QCOMPARE(m_segment->count, count + 2);
+
+    NtpSegment segment;
+    QVERIFY(read(&segment));
+    QCOMPARE(static_cast<qint64>(segment.clockTimeStampSec), 1700000000LL);
+    QCOMPARE(segment.clockTimeStampUSec, 123456);
+    QCOMPARE(segment.clockTimeStampNSec, 123456789u);
+    QCOMPARE(static_cast<qint64>(segment.receiveTimeStampSec), 1700000000LL);
+    QCOMPARE(segment.receiveTimeStampUSec, 100000);
+    QCOMPARE(segment.receiveTimeStampNSec, 100000000u);
+    QCOMPARE(segment.precision, -24); /* 2^-24 s is the first step of at least 50 ns */
+
+    // Consumed until the next sample
+    QVERIFY(!read(&segment));
+}
+
+void TestNtpShm::invalidSample()
+{
+    int count = m_segment->count;
+    M8_TIME_SAMPLE sample = timeSample(1700000001000000000LL, 1700000001000000000LL);
+    sample.valid &= ~M8_TIME_VALID_UTC;
+    m_feeder->timeSample(sample);
+    QCOMPARE(m_segment->count, count);
+    NtpSegment segment;
+    QVERIFY(!read(&segment));
+}
+
+void TestNtpShm::latency()
+{
+    NtpShm feeder(TEST_UNIT, 20000000, nullptr);
+    QVERIFY(feeder.isAvailable());
+    feeder.timeSample(timeSample(1700000002000000000LL, 1700000002010000000LL));
+
+    NtpSegment segment;
+    QVERIFY(read(&segment));
+    QCOMPARE(static_cast<qint64>(segment.clockTimeStampSec), 1700000002LL);
+    QCOMPARE(segment.clockTimeStampNSec, 0u);
+    QCOMPARE(static_cast<qint64>(segment.receiveTimeStampSec), 1700000001LL);
+    QCOMPARE(segment.receiveTimeStampNSec, 990000000u);
+}
+
+/**
+ * @brief TestNtpShm::concurrentReads
+ *
+ * Every sample has the same receiver and host time, so a sample that mixes two writes shows as
+ * a difference between them.
+ */
+void TestNtpShm::concurrentReads()
+{
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (qint64 i = 1; i <= 200000; ++i) {
+            qint64 time = 1700000000000000000LL + i * 1000001LL;
+            m_feeder->timeSample(timeSample(time, time));
+        }
+        done = true;
+    });
+
+    int samples = 0;
+    int torn = 0;
+    NtpSegment segment;
+    while (!done) {
+        if (!read(&segment))
+            continue;
+        ++samples;
+        if (segment.clockTimeStampSec != segment.receiveTimeStampSec
+            || segment.clockTimeStampNSec != segment.receiveTimeStampNSec
+            || segment.clockTimeStampUSec != segment.receiveTimeStampUSec
+            || segment.clockTimeStampNSec / 1000
+                    != static_cast<unsigned>(segment.clockTimeStampUSec))
+            ++torn;
+    }
+    writer.join();
+    QVERIFY(samples > 0);
+    QCOMPARE(torn, 0);
+}
+
+QTEST_GUILESS_MAIN(TestNtpShm)
+
+#include "tst_ntpshm.moc"
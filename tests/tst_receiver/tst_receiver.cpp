@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8.h"
+#include "simulator.h"
+#include <QtTest>
+
+/* UBX-ACK timeout of the library */
+#define ACK_TIMEOUT_MS 3000
+
+Q_DECLARE_METATYPE(M8_GNSS_CONFIG)
+
+static bool systemEnabled(const M8_GNSS_CONFIG &config, quint8 gnssId)
+{
+    for (const M8_GNSS_BLOCK &block : config.blocks) {
+        if (block.gnssId == gnssId)
+            return block.enabled;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs the library against m8sim on a pseudo terminal
+ *
+ * The simulator starts with GPS, SBAS and GLONASS enabled. Each test disables GLONASS and reads
+ * back what the simulated receiver kept.
+ */
+class TestReceiver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void acknowledged();
+    void rejected();
+    void ackTimeout();
+    void engineStop();
+
+private:
+    Simulator *m_simulator;
+    M8 *m_m8;
+};
+
+void TestReceiver::initTestCase()
+{
+    qRegisterMetaType<M8_GNSS_CONFIG>();
+}
+
+/**
+ * @brief TestReceiver::init
+ *
+ * Waits until the receiver is seen and the startup configuration has been acknowledged, which
+ * the GNSS configuration poll queues behind.
+ */
+void TestReceiver::init()
+{
+    m_simulator = new Simulator();
+    QVERIFY(m_simulator->open());
+    m_m8 = new M8(m_simulator->slavePath(), QByteArray());
+    QTRY_COMPARE_WITH_TIMEOUT(m_m8->status(), M8_STATUS_ON, 5000);
+
+    QSignalSpy config(m_m8, &M8::gnssConfigChange);
+    m_m8->requestGnssConfig();
+    QVERIFY(config.wait(5000));
+    M8_GNSS_CONFIG gnss = config.takeFirst().at(0).value<M8_GNSS_CONFIG>();
+    QVERIFY(systemEnabled(gnss, M8_GNSS_GPS));
+    QVERIFY(systemEnabled(gnss, M8_GNSS_GLONASS));
+}
+
+void TestReceiver::cleanup()
+{
+    delete m_m8;
+    delete m_simulator;
+}
+
+void TestReceiver::acknowledged()
+{
+    QSignalSpy config(m_m8, &M8::gnssConfigChange);
+    quint64 acks = m_m8->metrics().ubxFrames[M8_UBX_ACK];
+    QVERIFY(m_m8->setGnssSystems(M8_GNSS_MASK(M8_GNSS_GPS)));
+    QVERIFY(config.wait(2000));
+    M8_GNSS_CONFIG gnss = config.takeFirst().at(0).value<M8_GNSS_CONFIG>();
+    QVERIFY(systemEnabled(gnss, M8_GNSS_GPS));
+    QVERIFY(!systemEnabled(gnss, M8_GNSS_GLONASS));
+
+    M8_METRICS metrics = m_m8->metrics();
+    QCOMPARE(metrics.ubxFrames[M8_UBX_ACK], acks + 1);
+    QCOMPARE(metrics.ubxFrames[M8_UBX_NAK], 0ull);
+    QCOMPARE(metrics.ackTimeouts, 0ull);
+}
+
+/**
+ * @brief TestReceiver::rejected
+ *
+ * A NAK leaves the configuration unknown, so it is polled, and the receiver's unchanged one is
+ * reported.
+ */
+void TestReceiver::rejected()
+{
+    m_simulator->setFaults({ 1, 0, 0 });
+    QSignalSpy config(m_m8, &M8::gnssConfigChange);
+    QVERIFY(m_m8->setGnssSystems(M8_GNSS_MASK(M8_GNSS_GPS)));
+    QVERIFY(config.wait(2000));
+    M8_GNSS_CONFIG gnss = config.takeFirst().at(0).value<M8_GNSS_CONFIG>();
+    QVERIFY(systemEnabled(gnss, M8_GNSS_GLONASS));
+
+    M8_METRICS metrics = m_m8->metrics();
+    QCOMPARE(metrics.ubxFrames[M8_UBX_NAK], 1ull);
+    QCOMPARE(metrics.ackTimeouts, 0ull);
+}
+
+/**
+ * @brief TestReceiver::ackTimeout
+ *
+ * With the ACK later than the timeout, the message is sent once more without waiting and the
+ * configuration is polled after it. The late ACKs are ignored.
+ */
+void TestReceiver::ackTimeout()
+{
+    m_simulator->setAckLatency(ACK_TIMEOUT_MS + 500);
+    QSignalSpy config(m_m8, &M8::gnssConfigChange);
+    QVERIFY(m_m8->setGnssSystems(M8_GNSS_MASK(M8_GNSS_GPS)));
+    QVERIFY(config.wait(ACK_TIMEOUT_MS + 2000));
+    M8_GNSS_CONFIG gnss = config.takeFirst().at(0).value<M8_GNSS_CONFIG>();
+    QVERIFY(!systemEnabled(gnss, M8_GNSS_GLONASS));
+    QCOMPARE(m_m8->metrics().ackTimeouts, 1ull);
+
+    // Both transmissions are acknowledged in the end, without another timeout or report
+    quint64 acks = m_m8->metrics().ubxFrames[M8_UBX_ACK];
+    QTRY_COMPARE_WITH_TIMEOUT(m_m8->metrics().ubxFrames[M8_UBX_ACK], acks + 2,
+                              ACK_TIMEOUT_MS + 1000);
+    QCOMPARE(m_m8->metrics().ackTimeouts, 1ull);
+    QVERIFY(config.isEmpty());
+}
+
+/**
+ * @brief TestReceiver::engineStop
+ *
+ * UBX-CFG-RST stops and starts the navigation output and is never acknowledged.
+ */
+void TestReceiver::engineStop()
+{
+    QSignalSpy nmea(m_m8, &M8::nmea);
+    quint64 acks = m_m8->metrics().ubxFrames[M8_UBX_ACK];
+    m_m8->setPower(false);
+    // Output already on its way
+    QTest::qWait(200);
+    nmea.clear();
+    QTest::qWait(2500);
+    QVERIFY(nmea.isEmpty());
+
+    m_m8->setPower(true);
+    QVERIFY(nmea.wait(2500));
+    QCOMPARE(m_m8->metrics().ubxFrames[M8_UBX_ACK], acks);
+}
+
+QTEST_GUILESS_MAIN(TestReceiver)
+
+#include "tst_receiver.moc"
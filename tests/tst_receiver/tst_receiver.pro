@@ -0,0 +1,56 @@
+TARGET = tst_receiver
+include(../tests.pri)
+
+M8_SIM = $$PWD/../../tools/m8sim
+INCLUDEPATH += $$M8_SIM
+
+SOURCES += \
+    tst_receiver.cpp \
+    $$M8_SIM/simulator.cpp \
+    $$M8_SRC/assistance.cpp \
+    $$M8_SRC/config.cpp \
+    $$M8_SRC/framer.cpp \
+    $$M8_SRC/ioreactor.cpp \
+    $$M8_SRC/kernels.cpp \
+    $$M8_SRC/m8.cpp \
+    $$M8_SRC/m8control.cpp \
+    $$M8_SRC/m8device.cpp \
+    $$M8_SRC/metrics.cpp \
+    $$M8_SRC/nmea.cpp \
+    $$M8_SRC/ntpshm.cpp \
+    $$M8_SRC/power.cpp \
+    $$M8_SRC/powerpolicy.cpp \
+    $$M8_SRC/recorder.cpp \
+    $$M8_SRC/recordreader.cpp \
+    $$M8_SRC/replay.cpp \
+    $$M8_SRC/scheduler.cpp \
+    $$M8_SRC/shmpublisher.cpp \
+    $$M8_SRC/sink.cpp \
+    $$M8_SRC/sinks.cpp \
+    $$M8_SRC/transport.cpp \
+    $$M8_SRC/ttff.cpp \
+    $$M8_SRC/ubx.cpp
+
+HEADERS += \
+    $$M8_SIM/simulator.h \
+    $$PWD/../../include/m8.h \
+    $$M8_SRC/assistance.h \
+    $$M8_SRC/config.h \
+    $$M8_SRC/framer.h \
+    $$M8_SRC/ioreactor.h \
+    $$M8_SRC/kernels.h \
+    $$M8_SRC/m8control.h \
+    $$M8_SRC/m8device.h \
+    $$M8_SRC/metrics.h \
+    $$M8_SRC/nmea.h \
+    $$M8_SRC/ntpshm.h \
+    $$M8_SRC/power.h \
+    $$M8_SRC/recorder.h \
+    $$M8_SRC/recordreader.h \
+    $$M8_SRC/replay.h \
+    $$M8_SRC/scheduler.h \
+    $$M8_SRC/shmpublisher.h \
+    $$M8_SRC/sinks.h \
+    $$M8_SRC/transport.h \
+    $$M8_SRC/ttff.h \
+    $$M8_SRC/ubx.h
@@ -0,0 +1,233 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "assistance.h"
+#include "config.h"
+#include "m8device.h"
+#include "metrics.h"
+#include "power.h"
+#include "scheduler.h"
+#include "ttff.h"
+#include "ubx.h"
+#include <QtTest>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Time the first fix after construction is reported to TTFF, so the lead time is short */
+#define FIRST_FIX_MS 200
+
+static M8_FIX fix(float horizontalAccuracy, float hdop)
+{
+    M8_FIX fix;
+    memset(&fix, 0, sizeof(fix));
+    fix.fixType = M8_FIX_3D;
+    fix.quality = M8_FIX_QUALITY_GNSS;
+    fix.satellites = 8;
+    if (horizontalAccuracy >= 0) {
+        fix.horizontalAccuracy = horizontalAccuracy;
+        fix.fields |= M8_FIX_HAS_ACCURACY;
+    }
+    if (hdop > 0) {
+        fix.hdop = hdop;
+        fix.fields |= M8_FIX_HAS_HDOP;
+    }
+    return fix;
+}
+
+/**
+ * @brief Runs Scheduler on the library's Power and TTFF, with the receiver on a socket pair
+ *
+ * Engine starts and stops are seen through Power::engineStateChanged, and fixes are fed to the
+ * scheduler directly.
+ */
+class TestScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void leadTime();
+    void stopOnAccuracy();
+    void backoff();
+
+private:
+    qint64 expectedLeadTimeMs(const M8_FIX_SCHEDULE &schedule);
+
+private:
+    int m_receiver;
+    Metrics *m_metrics;
+    M8Device *m_device;
+    UBX *m_ubx;
+    Config *m_config;
+    Power *m_power;
+    Assistance *m_assistance;
+    TTFF *m_ttff;
+    Scheduler *m_scheduler;
+    QElapsedTimer m_clock;
+    QVector<qint64> m_engineOn;
+    QVector<qint64> m_engineOff;
+    QVector<qint64> m_misses;
+};
+
+void TestScheduler::init()
+{
+    int fds[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    m_receiver = fds[1];
+    m_metrics = new Metrics();
+    m_device = new M8Device(QString("fd:%1").arg(fds[0]), m_metrics);
+    QVERIFY(m_device->isAvailable());
+    m_ubx = new UBX(m_device, m_metrics);
+    m_config = new Config(QByteArray());
+    m_power = new Power(m_ubx, m_config);
+    m_assistance = new Assistance(m_ubx, m_config);
+    m_ttff = new TTFF(m_ubx, m_power, m_assistance);
+    m_scheduler = new Scheduler(m_power, m_ttff);
+
+    m_engineOn.clear();
+    m_engineOff.clear();
+    m_misses.clear();
+    connect(m_power, &Power::engineStateChanged, this, [this](bool on) {
+        (on ? m_engineOn : m_engineOff).append(m_clock.elapsed());
+    });
+    connect(m_scheduler, &Scheduler::scheduledFix, this, [this](bool success) {
+        if (!success)
+            m_misses.append(m_clock.elapsed());
+    });
+
+    QTest::qWait(FIRST_FIX_MS);
+    m_ttff->newFix(fix(5, 1));
+}
+
+void TestScheduler::cleanup()
+{
+    delete m_scheduler;
+    delete m_ttff;
+    delete m_assistance;
+    delete m_power;
+    delete m_config;
+    delete m_ubx;
+    delete m_device;
+    delete m_metrics;
+    close(m_receiver);
+}
+
+/**
+ * @brief TestScheduler::expectedLeadTimeMs
+ * @param schedule
+ * @return The measured time to first fix with half of it again and the margin, at most an interval
+ */
+qint64 TestScheduler::expectedLeadTimeMs(const M8_FIX_SCHEDULE &schedule)
+{
+    M8_TTFF_STATS stats = m_ttff->statistics();
+    qint64 ttff = -1;
+    for (int type = 0; type < M8_START_TYPES; ++type) {
+        if (stats.firstFix[type].count > 0)
+            ttff = static_cast<qint64>(stats.firstFix[type].sumMs / stats.firstFix[type].count);
+    }
+    if (ttff < FIRST_FIX_MS)
+        return -1;
+    return qMin(ttff + ttff / 2 + schedule.marginS * 1000LL, schedule.intervalS * 1000LL);
+}
+
+void TestScheduler::leadTime()
+{
+    M8_FIX_SCHEDULE schedule = { 2, 0, 0, 5, 0 };
+    qint64 lead = expectedLeadTimeMs(schedule);
+    QVERIFY(lead > 0);
+    QVERIFY(lead < 1000);
+
+    m_clock.start();
+    m_scheduler->setSchedule(schedule);
+    // Stopped until the engine has to start for the first deadline
+    QCOMPARE(m_engineOff.size(), 1);
+    QVERIFY(m_engineOn.isEmpty());
+
+    QTRY_COMPARE_WITH_TIMEOUT(m_engineOn.size(), 1, 4000);
+    qint64 wake = schedule.intervalS * 1000LL - lead;
+    QVERIFY2(m_engineOn.at(0) >= wake - 5 && m_engineOn.at(0) < wake + 200,
+             QByteArray::number(m_engineOn.at(0)).constData());
+    QCOMPARE(m_scheduler->statistics().attempts, 1u);
+}
+
+void TestScheduler::stopOnAccuracy()
+{
+    M8_FIX_SCHEDULE schedule = { 1, 5, 0, 5, 0 };
+    QSignalSpy fixes(m_scheduler, &Scheduler::scheduledFix);
+    m_clock.start();
+    m_scheduler->setSchedule(schedule);
+    QTRY_COMPARE_WITH_TIMEOUT(m_engineOn.size(), 1, 2000);
+
+    // 10 m from HDOP, then 8 m from the receiver's own estimate, which takes precedence
+    m_scheduler->newFix(fix(-1, 4));
+    m_scheduler->newFix(fix(8, 1));
+    QVERIFY(fixes.isEmpty());
+    QCOMPARE(m_engineOff.size(), 1);
+
+    m_scheduler->newFix(fix(3, 4));
+    QCOMPARE(fixes.size(), 1);
+    QCOMPARE(fixes.at(0).at(0).toBool(), true);
+    QCOMPARE(m_engineOff.size(), 2);
+
+    M8_SCHEDULE_STATS stats = m_scheduler->statistics();
+    QCOMPARE(stats.attempts, 1u);
+    QCOMPARE(stats.fixes, 1u);
+    QCOMPARE(stats.missed, 0u);
+    QVERIFY(stats.lastTimeToFixMs >= 0);
+}
+
+/**
+ * @brief TestScheduler::backoff
+ *
+ * Without a timeout every attempt is missed at its deadline. The first miss doubles the wait to
+ * two intervals, and maxBackoff keeps it there for the next.
+ */
+void TestScheduler::backoff()
+{
+    M8_FIX_SCHEDULE schedule = { 1, 0, 0, 0, 1 };
+    m_clock.start();
+    m_scheduler->setSchedule(schedule);
+    QTRY_COMPARE_WITH_TIMEOUT(m_misses.size(), 3, 8000);
+
+    QVERIFY2(qAbs(m_misses.at(0) - 1000) < 200, QByteArray::number(m_misses.at(0)).constData());
+    for (int i = 1; i < m_misses.size(); ++i) {
+        qint64 gap = m_misses.at(i) - m_misses.at(i - 1);
+        QVERIFY2(qAbs(gap - 2000) < 200, QByteArray::number(gap).constData());
+    }
+    QCOMPARE(m_engineOn.size(), 3);
+
+    M8_SCHEDULE_STATS stats = m_scheduler->statistics();
+    QCOMPARE(stats.missed, 3u);
+    QCOMPARE(stats.consecutiveMisses, 3u);
+    QCOMPARE(stats.fixes, 0u);
+
+    // A fix ends the backoff
+    QTRY_COMPARE_WITH_TIMEOUT(m_engineOn.size(), 4, 3000);
+    m_scheduler->newFix(fix(3, 1));
+    QCOMPARE(m_scheduler->statistics().consecutiveMisses, 0u);
+}
+
+QTEST_GUILESS_MAIN(TestScheduler)
+
+#include "tst_scheduler.moc"
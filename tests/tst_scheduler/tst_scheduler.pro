@@ -0,0 +1,38 @@
+TARGET = tst_scheduler
+include(../tests.pri)
+
+SOURCES += \
+    tst_scheduler.cpp \
+    $$M8_SRC/assistance.cpp \
+    $$M8_SRC/config.cpp \
+    $$M8_SRC/ioreactor.cpp \
+    $$M8_SRC/kernels.cpp \
+    $$M8_SRC/m8device.cpp \
+    $$M8_SRC/metrics.cpp \
+    $$M8_SRC/power.cpp \
+    $$M8_SRC/powerpolicy.cpp \
+    $$M8_SRC/recorder.cpp \
+    $$M8_SRC/recordreader.cpp \
+    $$M8_SRC/replay.cpp \
+    $$M8_SRC/scheduler.cpp \
+    $$M8_SRC/sinks.cpp \
+    $$M8_SRC/transport.cpp \
+    $$M8_SRC/ttff.cpp \
+    $$M8_SRC/ubx.cpp
+
+HEADERS += \
+    $$M8_SRC/assistance.h \
+    $$M8_SRC/config.h \
+    $$M8_SRC/ioreactor.h \
+    $$M8_SRC/kernels.h \
+    $$M8_SRC/m8device.h \
+    $$M8_SRC/metrics.h \
+    $$M8_SRC/power.h \
+    $$M8_SRC/recorder.h \
+    $$M8_SRC/recordreader.h \
+    $$M8_SRC/replay.h \
+    $$M8_SRC/scheduler.h \
+    $$M8_SRC/sinks.h \
+    $$M8_SRC/transport.h \
+    $$M8_SRC/ttff.h \
+    $$M8_SRC/ubx.h
@@ -0,0 +1,329 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_track.h"
+#include <QtTest>
+#include <cmath>
+
+#define POINTS 2000
+#define METRES_PER_DEGREE 111194.93
+#define TOLERANCE_M 3.0
+
+/**
+ * @brief Encodes tracks with M8TrackEncoder and decodes them again with M8TrackDecoder
+ */
+class TestTrack : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void lossless();
+    void negativeDeltas();
+    void simplified();
+    void chunked_data();
+    void chunked();
+    void badMagic();
+    void badVersion();
+    void longVarint();
+    void incompleteVarint();
+
+private:
+    static QByteArray encode(const QVector<M8_TRACK_POINT> &points, double tolerance = 0,
+                             M8_TRACK_STATS *stats = nullptr);
+    static QVector<M8_TRACK_POINT> decode(const QByteArray &data, int chunkSize);
+    static void compare(const QVector<M8_TRACK_POINT> &actual,
+                        const QVector<M8_TRACK_POINT> &expected);
+    static double distance(const M8_TRACK_POINT &point, const M8_TRACK_POINT &start,
+                           const M8_TRACK_POINT &end);
+
+private:
+    QVector<M8_TRACK_POINT> m_track;
+};
+
+/**
+ * @brief TestTrack::initTestCase
+ *
+ * A random walk with irregular time steps, so every delta and every change of the time step
+ * takes both signs. Steps are finer than the stored resolution, so points are rounded.
+ */
+void TestTrack::initTestCase()
+{
+    quint32 seed = 1;
+    M8_TRACK_POINT point;
+    point.timestamp = 1700000000000LL * 1000000;
+    point.latitude = 55.6489;
+    point.longitude = 12.5430;
+    point.altitude = 61.7f;
+    for (int i = 0; i < POINTS; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int r = static_cast<int>(seed >> 8);
+        point.timestamp += (1000 + r % 200 - 100) * 1000000LL;
+        point.latitude += ((r >> 4) % 2001 - 1000) * 3.7e-8;
+        point.longitude += ((r >> 8) % 2001 - 1000) * 3.7e-8;
+        point.altitude += static_cast<float>((r >> 12) % 201 - 100) * 0.0037f;
+        m_track.append(point);
+    }
+}
+
+QByteArray TestTrack::encode(const QVector<M8_TRACK_POINT> &points, double tolerance,
+                             M8_TRACK_STATS *stats)
+{
+    M8TrackEncoder encoder(tolerance);
+    for (const M8_TRACK_POINT &point : points)
+        encoder.add(point);
+    encoder.flush();
+    if (stats)
+        *stats = encoder.statistics();
+    return encoder.takeData();
+}
+
+/**
+ * @brief TestTrack::decode
+ * @param data
+ * @param chunkSize Bytes appended before each attempt to read points
+ * @return Points decoded, up to the first error
+ */
+QVector<M8_TRACK_POINT> TestTrack::decode(const QByteArray &data, int chunkSize)
+{
+    M8TrackDecoder decoder;
+    QVector<M8_TRACK_POINT> points;
+    M8_TRACK_POINT point;
+    for (int offset = 0; offset < data.size(); offset += chunkSize) {
+        decoder.append(data.mid(offset, chunkSize));
+        while (decoder.next(&point))
+            points.append(point);
+    }
+    return points;
+}
+
+/**
+ * @brief TestTrack::compare
+ * @param actual
+ * @param expected
+ *
+ * Timestamps of whole milliseconds survive exactly, positions to 1e-7 deg and altitudes to 1 cm.
+ */
+void TestTrack::compare(const QVector<M8_TRACK_POINT> &actual,
+                        const QVector<M8_TRACK_POINT> &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < actual.size(); ++i) {
+        QCOMPARE(actual.at(i).timestamp, expected.at(i).timestamp);
+        QVERIFY(qAbs(actual.at(i).latitude - expected.at(i).latitude) <= 1e-7);
+        QVERIFY(qAbs(actual.at(i).longitude - expected.at(i).longitude) <= 1e-7);
+        QVERIFY(qAbs(actual.at(i).altitude - expected.at(i).altitude) <= 0.01f);
+    }
+}
+
+/**
+ * @brief TestTrack::distance
+ * @param point
+ * @param start
+ * @param end
+ * @return Distance of point from the line segment between start and end [m], on a plane tangent
+ * at start
+ */
+double TestTrack::distance(const M8_TRACK_POINT &point, const M8_TRACK_POINT &start,
+                           const M8_TRACK_POINT &end)
+{
+    double scaleX = METRES_PER_DEGREE * cos(start.latitude * M_PI / 180);
+    double dx = (end.longitude - start.longitude) * scaleX;
+    double dy = (end.latitude - start.latitude) * METRES_PER_DEGREE;
+    double dz = static_cast<double>(end.altitude - start.altitude);
+    double px = (point.longitude - start.longitude) * scaleX;
+    double py = (point.latitude - start.latitude) * METRES_PER_DEGREE;
+    double pz = static_cast<double>(point.altitude - start.altitude);
+    double length2 = dx * dx + dy * dy + dz * dz;
+    double t = (length2 > 0) ? qBound(0.0, (px * dx + py * dy + pz * dz) / length2, 1.0) : 0;
+    return sqrt((px - t * dx) * (px - t * dx) + (py - t * dy) * (py - t * dy)
+                + (pz - t * dz) * (pz - t * dz));
+}
+
+void TestTrack::lossless()
+{
+    M8_TRACK_STATS stats;
+    QByteArray data = encode(m_track, 0, &stats);
+    QVERIFY(data.startsWith(M8_TRACK_MAGIC));
+    QCOMPARE(stats.points, static_cast<quint64>(POINTS));
+    QCOMPARE(stats.encodedPoints, static_cast<quint64>(POINTS));
+    QCOMPARE(stats.bytes, static_cast<quint64>(data.size()));
+    compare(decode(data, data.size()), m_track);
+}
+
+/**
+ * @brief TestTrack::negativeDeltas
+ *
+ * Crosses the equator, the prime meridian and sea level, with shrinking time steps.
+ */
+void TestTrack::negativeDeltas()
+{
+    QVector<M8_TRACK_POINT> track;
+    M8_TRACK_POINT point;
+    point.timestamp = 10000000000LL;
+    point.latitude = 0.0002;
+    point.longitude = 0.0003;
+    point.altitude = 1.5f;
+    qint64 step = 1000000000;
+    for (int i = 0; i < 10; ++i) {
+        track.append(point);
+        point.timestamp += step;
+        step -= 100000000;
+        point.latitude -= 0.00005;
+        point.longitude -= 0.00007;
+        point.altitude -= 0.37f;
+    }
+    point.latitude = -89.9999999;
+    point.longitude = -179.9999999;
+    point.altitude = -420.0f;
+    track.append(point);
+
+    QByteArray data = encode(track);
+    compare(decode(data, data.size()), track);
+}
+
+/**
+ * @brief TestTrack::simplified
+ *
+ * A walk at 1 m/s with less than half a metre of noise: straight north, then east, then around a
+ * circle. Every point must stay within the tolerance of the decoded line, up to the stored
+ * resolution. The straight parts are longer than M8_TRACK_WINDOW, which limits the points
+ * dropped in a row, and the points held back at the end are dropped by flush().
+ */
+void TestTrack::simplified()
+{
+    QVector<M8_TRACK_POINT> track;
+    quint32 seed = 7;
+    double x = 0;
+    double y = 0;
+    for (int i = 0; i < 1000; ++i) {
+        double heading = (i < 300) ? 0 : (i < 600) ? M_PI / 2 : M_PI / 2 + (i - 600) * M_PI / 180;
+        x += sin(heading);
+        y += cos(heading);
+        seed = seed * 1664525u + 1013904223u;
+        double noiseX = (static_cast<int>((seed >> 8) % 801) - 400) * 1e-3;
+        double noiseY = (static_cast<int>((seed >> 16) % 801) - 400) * 1e-3;
+        M8_TRACK_POINT point;
+        point.timestamp = (1700000000000LL + i * 1000LL) * 1000000;
+        point.latitude = 55.6489 + (y + noiseY) / METRES_PER_DEGREE;
+        point.longitude = 12.5430 + (x + noiseX) / (METRES_PER_DEGREE * cos(55.6489 * M_PI / 180));
+        point.altitude = 61.7f;
+        track.append(point);
+    }
+
+    M8_TRACK_STATS stats;
+    QByteArray data = encode(track, TOLERANCE_M, &stats);
+    QVector<M8_TRACK_POINT> decoded = decode(data, data.size());
+    QCOMPARE(stats.points, static_cast<quint64>(track.size()));
+    QCOMPARE(stats.encodedPoints, static_cast<quint64>(decoded.size()));
+    QVERIFY(stats.encodedPoints < stats.points / 10);
+    QCOMPARE(decoded.first().timestamp, track.first().timestamp);
+    QCOMPARE(decoded.last().timestamp, track.last().timestamp);
+
+    int segment = 0;
+    int dropped = 0;
+    for (const M8_TRACK_POINT &point : qAsConst(track)) {
+        while (decoded.at(segment + 1).timestamp < point.timestamp)
+            ++segment;
+        if (point.timestamp != decoded.at(segment).timestamp
+            && point.timestamp != decoded.at(segment + 1).timestamp) {
+            QVERIFY(++dropped < M8_TRACK_WINDOW);
+        } else {
+            dropped = 0;
+        }
+        double error = distance(point, decoded.at(segment), decoded.at(segment + 1));
+        QVERIFY2(error <= TOLERANCE_M + 0.02, QByteArray::number(error).constData());
+    }
+}
+
+void TestTrack::chunked_data()
+{
+    QTest::addColumn<int>("chunkSize");
+    QTest::newRow("1 byte") << 1;
+    QTest::newRow("2 bytes") << 2;
+    QTest::newRow("3 bytes") << 3;
+    QTest::newRow("7 bytes") << 7;
+    QTest::newRow("64 bytes") << 64;
+}
+
+void TestTrack::chunked()
+{
+    QFETCH(int, chunkSize);
+    QByteArray data = encode(m_track);
+    compare(decode(data, chunkSize), m_track);
+}
+
+void TestTrack::badMagic()
+{
+    QByteArray data = encode(m_track);
+    data[0] = 'X';
+    M8TrackDecoder decoder;
+    decoder.append(data);
+    M8_TRACK_POINT point;
+    QVERIFY(!decoder.next(&point));
+    QVERIFY(decoder.hasError());
+}
+
+void TestTrack::badVersion()
+{
+    QByteArray data = encode(m_track);
+    data[4] = static_cast<char>(M8_TRACK_VERSION + 1);
+    M8TrackDecoder decoder;
+    decoder.append(data);
+    M8_TRACK_POINT point;
+    QVERIFY(!decoder.next(&point));
+    QVERIFY(decoder.hasError());
+}
+
+void TestTrack::longVarint()
+{
+    QByteArray data = M8_TRACK_MAGIC;
+    data.append(static_cast<char>(M8_TRACK_VERSION));
+    data.append(QByteArray(11, static_cast<char>(0x80)));
+    M8TrackDecoder decoder;
+    decoder.append(data);
+    M8_TRACK_POINT point;
+    QVERIFY(!decoder.next(&point));
+    QVERIFY(decoder.hasError());
+}
+
+/**
+ * @brief TestTrack::incompleteVarint
+ *
+ * A record cut short waits for more data rather than being an error.
+ */
+void TestTrack::incompleteVarint()
+{
+    QByteArray data = M8_TRACK_MAGIC;
+    data.append(static_cast<char>(M8_TRACK_VERSION));
+    data.append(QByteArray(3, static_cast<char>(0x80)));
+    M8TrackDecoder decoder;
+    decoder.append(data);
+    M8_TRACK_POINT point;
+    QVERIFY(!decoder.next(&point));
+    QVERIFY(!decoder.hasError());
+}
+
+QTEST_GUILESS_MAIN(TestTrack)
+
+#include "tst_track.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_track
+include(../tests.pri)
+
+SOURCES += \
+    tst_track.cpp \
+    $$M8_SRC/m8track.cpp
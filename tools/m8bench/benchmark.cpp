@@ -0,0 +1,89 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "benchmark.h"
+#include <atomic>
+#include <stdlib.h>
+
+/*
+ * Every allocation is counted by wrapping the allocator of glibc. Qt containers allocate with
+ * malloc and operator new ends in malloc too, so this sees both.
+ */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static std::atomic<quint64> allocations(0);
+
+extern "C" void *malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+quint64 allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+QJsonObject BenchmarkResult::toJson() const
+{
+    QJsonObject json;
+    json.insert("name", name);
+    json.insert("unit", unit);
+    json.insert("messages", static_cast<double>(messages));
+    json.insert("bytes", static_cast<double>(bytes));
+    json.insert("seconds", seconds);
+    json.insert("bytesPerSecond", seconds > 0 ? bytes / seconds : 0);
+    json.insert("messagesPerSecond", seconds > 0 ? messages / seconds : 0);
+    json.insert("allocationsPerMessage", allocationsPerMessage);
+    json.insert("p50Ns", static_cast<double>(p50Ns));
+    json.insert("p99Ns", static_cast<double>(p99Ns));
+    json.insert("maxNs", static_cast<double>(maxNs));
+    return json;
+}
+
+/**
+ * @brief Benchmark::Benchmark
+ * @param rounds Timed passes over the workload for throughput
+ */
+Benchmark::Benchmark(int rounds) : m_rounds(qMax(1, rounds)) { }
+
+qint64 Benchmark::percentile(std::vector<qint64> &samples, double p)
+{
+    size_t index = qMin(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<long>(index), samples.end());
+    return samples[index];
+}
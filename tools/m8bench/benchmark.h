@@ -0,0 +1,117 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "metrics.h"
+#include <QJsonObject>
+#include <QString>
+#include <algorithm>
+#include <vector>
+
+quint64 allocationCount();
+
+/**
+ * @brief Outcome of one benchmark, rates over all timed rounds
+ */
+struct BenchmarkResult {
+    QString name;
+    QString unit; /* What one latency sample covers */
+    quint64 messages;
+    quint64 bytes;
+    double seconds;
+    double allocationsPerMessage;
+    qint64 p50Ns;
+    qint64 p99Ns;
+    qint64 maxNs;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Runs an operation over a workload, first for throughput and then for latency
+ *
+ * Throughput and allocations are measured without per operation timing, which would dominate
+ * the cheaper operations. Latency is measured in a separate round with a timestamp around every
+ * operation.
+ */
+class Benchmark
+{
+public:
+    explicit Benchmark(int rounds);
+
+    /**
+     * @param name
+     * @param unit What one operation covers, such as "message" or "chunk"
+     * @param operations Operations in one round, op(0) to op(operations - 1)
+     * @param messages Messages handled by one round
+     * @param bytes Bytes handled by one round
+     * @param op
+     */
+    template<class F>
+    BenchmarkResult run(const QString &name, const QString &unit, int operations,
+                        quint64 messages, quint64 bytes, F op)
+    {
+        BenchmarkResult result = { name, unit, 0, 0, 0, 0, 0, 0, 0 };
+        if (operations <= 0 || messages == 0)
+            return result;
+
+        // Warm up caches and let containers reach their steady state capacity
+        for (int i = 0; i < operations; ++i)
+            op(i);
+
+        quint64 allocations = allocationCount();
+        qint64 start = Metrics::timestamp();
+        for (int round = 0; round < m_rounds; ++round) {
+            for (int i = 0; i < operations; ++i)
+                op(i);
+        }
+        qint64 elapsed = Metrics::timestamp() - start;
+        allocations = allocationCount() - allocations;
+
+        std::vector<qint64> samples;
+        samples.reserve(static_cast<size_t>(operations));
+        for (int i = 0; i < operations; ++i) {
+            qint64 before = Metrics::timestamp();
+            op(i);
+            samples.push_back(Metrics::timestamp() - before);
+        }
+
+        result.messages = messages * static_cast<quint64>(m_rounds);
+        result.bytes = bytes * static_cast<quint64>(m_rounds);
+        result.seconds = elapsed / 1e9;
+        result.allocationsPerMessage = static_cast<double>(allocations) / result.messages;
+        result.p50Ns = percentile(samples, 0.50);
+        result.p99Ns = percentile(samples, 0.99);
+        result.maxNs = *std::max_element(samples.begin(), samples.end());
+        return result;
+    }
+
+    static qint64 percentile(std::vector<qint64> &samples, double p);
+
+private:
+    int m_rounds;
+};
+
+#endif // BENCHMARK_H
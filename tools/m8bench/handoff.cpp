@@ -0,0 +1,184 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "handoff.h"
+#include "benchmark.h"
+#include "metrics.h"
+#include <QScopedPointer>
+#include <QSocketNotifier>
+#include <QThread>
+#include <cstring>
+
+QJsonObject HandoffResult::toJson() const
+{
+    QJsonObject json;
+    json.insert("path", path);
+    json.insert("byteRate", byteRate);
+    json.insert("chunks", static_cast<double>(chunks));
+    json.insert("bytes", static_cast<double>(bytes));
+    json.insert("seconds", seconds);
+    json.insert("bytesPerSecond", seconds > 0 ? bytes / seconds : 0);
+    json.insert("allocationsPerChunk", allocationsPerChunk);
+    json.insert("producerCpuNs", static_cast<double>(producerCpuNs));
+    json.insert("consumerCpuNs", static_cast<double>(consumerCpuNs));
+    json.insert("p50Ns", static_cast<double>(p50Ns));
+    json.insert("p99Ns", static_cast<double>(p99Ns));
+    json.insert("maxNs", static_cast<double>(maxNs));
+    return json;
+}
+
+/**
+ * @brief HandoffReceiver::HandoffReceiver
+ * @param queue Ring of the ring path
+ * @param chunks Chunks to wait for
+ * @param done Released when all chunks have arrived
+ */
+HandoffReceiver::HandoffReceiver(M8DeviceRxQueue *queue, quint64 chunks, QSemaphore *done)
+    : p_queue(queue), p_done(done), m_notifier(nullptr), m_expected(chunks), m_cpuStart(0),
+      m_cpuNs(0)
+{
+    m_latencies.reserve(chunks);
+}
+
+std::vector<qint64> &HandoffReceiver::latencies()
+{
+    return m_latencies;
+}
+
+qint64 HandoffReceiver::cpuNs()
+{
+    return m_cpuNs;
+}
+
+/**
+ * @brief HandoffReceiver::watchQueue
+ *
+ * Called on the receiver's thread, which the notifier has to be created on.
+ */
+void HandoffReceiver::watchQueue()
+{
+    m_notifier = new QSocketNotifier(p_queue->eventFd(), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &HandoffReceiver::receiveQueued);
+}
+
+void HandoffReceiver::data(const QByteArray &message, qint64 timestamp)
+{
+    Q_UNUSED(message)
+    received(timestamp);
+}
+
+/**
+ * @brief HandoffReceiver::receiveQueued
+ *
+ * Drains the ring like M8Control::receiveQueued.
+ */
+void HandoffReceiver::receiveQueued()
+{
+    p_queue->clearWakeup();
+    while (M8DeviceChunk *chunk = p_queue->readSlot()) {
+        received(chunk->timestamp);
+        p_queue->releaseSlot();
+    }
+}
+
+void HandoffReceiver::received(qint64 timestamp)
+{
+    // Thread CPU time only grows while the thread runs, so waiting for the first chunk is free
+    if (m_latencies.empty())
+        m_cpuStart = Metrics::threadCpuTime();
+    m_latencies.push_back(Metrics::timestamp() - timestamp);
+    if (m_latencies.size() == m_expected) {
+        m_cpuNs = Metrics::threadCpuTime() - m_cpuStart;
+        p_done->release();
+    }
+}
+
+Handoff::Handoff(const QList<QByteArray> &chunks) : m_chunks(chunks) { }
+
+/**
+ * @brief Handoff::run
+ * @param ring Through a receive ring, or else through a queued signal
+ * @param byteRate Offered rate [bytes/s], 0 for as fast as possible
+ * @param chunks Reads to hand over, the workload chunks repeated as needed
+ * @return
+ */
+HandoffResult Handoff::run(bool ring, double byteRate, quint64 chunks)
+{
+    HandoffResult result = { ring ? "ring" : "signal", byteRate, chunks, 0, 0, 0, 0, 0, 0, 0, 0 };
+    if (m_chunks.isEmpty() || chunks == 0)
+        return result;
+
+    QScopedPointer<M8DeviceRxQueue> queue(new M8DeviceRxQueue());
+    QSemaphore done;
+    HandoffSender sender;
+    QThread thread;
+    HandoffReceiver *receiver = new HandoffReceiver(queue.data(), chunks, &done);
+    receiver->moveToThread(&thread);
+    QObject::connect(&thread, &QThread::finished, receiver, &QObject::deleteLater);
+    thread.start();
+    if (ring)
+        QMetaObject::invokeMethod(receiver, "watchQueue", Qt::BlockingQueuedConnection);
+    else
+        QObject::connect(&sender, &HandoffSender::data, receiver, &HandoffReceiver::data);
+
+    quint64 allocations = allocationCount();
+    qint64 cpuStart = Metrics::threadCpuTime();
+    qint64 start = Metrics::timestamp();
+    for (quint64 i = 0; i < chunks; ++i) {
+        const QByteArray &chunk = m_chunks.at(static_cast<int>(i % m_chunks.size()));
+        int size = qMin(chunk.size(), MAX_READ_DATA);
+        if (byteRate > 0) {
+            qint64 due = start + static_cast<qint64>(result.bytes * 1e9 / byteRate);
+            while (Metrics::timestamp() < due) {
+            }
+        }
+        if (ring) {
+            // A full ring holds the device thread back, as M8Device::readAvailable does
+            M8DeviceChunk *slot;
+            while (!(slot = queue->writeSlot()))
+                QThread::yieldCurrentThread();
+            memcpy(slot->data, chunk.constData(), static_cast<size_t>(size));
+            slot->size = size;
+            slot->timestamp = Metrics::timestamp();
+            queue->commitWrite();
+        } else {
+            // What M8Device did with every read before the rings
+            QByteArray data(chunk.constData(), size);
+            emit sender.data(data, Metrics::timestamp());
+        }
+        result.bytes += static_cast<quint64>(size);
+    }
+    result.producerCpuNs = Metrics::threadCpuTime() - cpuStart;
+    done.acquire();
+    result.seconds = (Metrics::timestamp() - start) / 1e9;
+    result.allocationsPerChunk = static_cast<double>(allocationCount() - allocations) / chunks;
+    result.consumerCpuNs = receiver->cpuNs();
+    std::vector<qint64> &latencies = receiver->latencies();
+    result.p50Ns = Benchmark::percentile(latencies, 0.50);
+    result.p99Ns = Benchmark::percentile(latencies, 0.99);
+    result.maxNs = *std::max_element(latencies.begin(), latencies.end());
+
+    thread.quit();
+    thread.wait();
+    return result;
+}
@@ -0,0 +1,116 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include "m8device.h"
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSemaphore>
+#include <vector>
+
+class QSocketNotifier;
+
+/**
+ * @brief Outcome of handing one stream of reads from the device thread to the control thread
+ */
+struct HandoffResult {
+    QString path; /* "signal" or "ring" */
+    double byteRate; /* Offered rate [bytes/s], 0 for as fast as possible */
+    quint64 chunks;
+    quint64 bytes;
+    double seconds;
+    double allocationsPerChunk;
+    qint64 producerCpuNs;
+    qint64 consumerCpuNs;
+    qint64 p50Ns; /* Read until the control thread has the data */
+    qint64 p99Ns;
+    qint64 maxNs;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Device side of the queued signal path that the receive rings replaced
+ */
+class HandoffSender : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void data(const QByteArray &message, qint64 timestamp);
+};
+
+/**
+ * @brief Control side of both paths, on a thread of its own with an event loop
+ */
+class HandoffReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    HandoffReceiver(M8DeviceRxQueue *queue, quint64 chunks, QSemaphore *done);
+
+    std::vector<qint64> &latencies();
+    qint64 cpuNs();
+
+public slots:
+    void watchQueue();
+    void data(const QByteArray &message, qint64 timestamp);
+
+private slots:
+    void receiveQueued();
+
+private:
+    void received(qint64 timestamp);
+
+private:
+    M8DeviceRxQueue *p_queue;
+    QSemaphore *p_done;
+    QSocketNotifier *m_notifier;
+    std::vector<qint64> m_latencies;
+    quint64 m_expected;
+    qint64 m_cpuStart;
+    qint64 m_cpuNs;
+};
+
+/**
+ * @brief Times the queued M8Device::data() signal of earlier releases against the receive ring
+ *
+ * The calling thread plays the device thread and reads the workload chunks at the offered rate,
+ * copying each into a new QByteArray for the signal path or into a ring slot. Latency is taken
+ * from the read timestamp until the control thread handles the chunk.
+ */
+class Handoff
+{
+public:
+    explicit Handoff(const QList<QByteArray> &chunks);
+
+    HandoffResult run(bool ring, double byteRate, quint64 chunks);
+
+private:
+    QList<QByteArray> m_chunks;
+};
+
+#endif // HANDOFF_H
@@ -0,0 +1,82 @@
+QT -= gui
+
+TEMPLATE = app
+TARGET = m8bench
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+LIBS += -lrt
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# The hot paths are internal to the library, so they are built in from source, and with them
+# everything M8Manager needs
+M8_SRC = $$_PRO_FILE_PWD_/../../src
+INCLUDEPATH += \
+    $$_PRO_FILE_PWD_/../../include/ \
+    $$M8_SRC
+
+SOURCES += \
+    main.cpp \
+    benchmark.cpp \
+    handoff.cpp \
+    scaling.cpp \
+    workload.cpp \
+    $$M8_SRC/assistance.cpp \
+    $$M8_SRC/config.cpp \
+    $$M8_SRC/framer.cpp \
+    $$M8_SRC/ioreactor.cpp \
+    $$M8_SRC/kernels.cpp \
+    $$M8_SRC/m8.cpp \
+    $$M8_SRC/m8control.cpp \
+    $$M8_SRC/m8manager.cpp \
+    $$M8_SRC/m8track.cpp \
+    $$M8_SRC/m8device.cpp \
+    $$M8_SRC/metrics.cpp \
+    $$M8_SRC/nmea.cpp \
+    $$M8_SRC/ntpshm.cpp \
+    $$M8_SRC/power.cpp \
+    $$M8_SRC/powerpolicy.cpp \
+    $$M8_SRC/recorder.cpp \
+    $$M8_SRC/recordreader.cpp \
+    $$M8_SRC/replay.cpp \
+    $$M8_SRC/scheduler.cpp \
+    $$M8_SRC/shmpublisher.cpp \
+    $$M8_SRC/sink.cpp \
+    $$M8_SRC/sinks.cpp \
+    $$M8_SRC/transport.cpp \
+    $$M8_SRC/ttff.cpp \
+    $$M8_SRC/ubx.cpp
+
+HEADERS += \
+    benchmark.h \
+    handoff.h \
+    scaling.h \
+    workload.h \
+    $$_PRO_FILE_PWD_/../../include/m8.h \
+    $$_PRO_FILE_PWD_/../../include/m8_manager.h \
+    $$_PRO_FILE_PWD_/../../include/m8_track.h \
+    $$M8_SRC/assistance.h \
+    $$M8_SRC/config.h \
+    $$M8_SRC/framer.h \
+    $$M8_SRC/ioreactor.h \
+    $$M8_SRC/kernels.h \
+    $$M8_SRC/m8control.h \
+    $$M8_SRC/m8device.h \
+    $$M8_SRC/metrics.h \
+    $$M8_SRC/nmea.h \
+    $$M8_SRC/ntpshm.h \
+    $$M8_SRC/power.h \
+    $$M8_SRC/recorder.h \
+    $$M8_SRC/recordreader.h \
+    $$M8_SRC/replay.h \
+    $$M8_SRC/scheduler.h \
+    $$M8_SRC/shmpublisher.h \
+    $$M8_SRC/sinks.h \
+    $$M8_SRC/transport.h \
+    $$M8_SRC/ttff.h \
+    $$M8_SRC/ubx.h
+
+DESTDIR = $$_PRO_FILE_PWD_/../../bin/
+OBJECTS_DIR = $$_PRO_FILE_PWD_/../../build/m8bench/.obj
+MOC_DIR = $$_PRO_FILE_PWD_/../../build/m8bench/.moc
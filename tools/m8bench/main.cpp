@@ -0,0 +1,371 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "benchmark.h"
+#include "framer.h"
+#include "handoff.h"
+#include "kernels.h"
+#include "m8_track.h"
+#include "m8device.h"
+#include "metrics.h"
+#include "nmea.h"
+#include "scaling.h"
+#include "ubx.h"
+#include "workload.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QThread>
+
+/* Longest a handoff at an offered rate runs, so the slow rates do not take minutes */
+#define HANDOFF_PACED_SECONDS 1.0
+
+/* Keeps results of side effect free calls alive */
+static volatile int sink;
+
+/*
+ * The control thread's handling of one read, as M8Control::deviceData without sinks and
+ * signals. Without metrics every counter, histogram and clock read is left out, which is what
+ * the registry costs.
+ */
+static void ingest(Framer *framer, NMEA *nmea, UBX *ubx, Metrics *metrics,
+                   const QByteArray &chunk, qint64 timestamp)
+{
+    qint64 received = 0;
+    if (metrics) {
+        received = Metrics::timestamp();
+        metrics->latency[M8_LATENCY_DEVICE_TO_CONTROL].add(received - timestamp);
+    }
+    framer->append(chunk);
+    QByteArray frame;
+    while (Framer::Frame type = framer->next(frame)) {
+        qint64 complete = 0;
+        if (metrics) {
+            if (Framer::FRAME_NMEA == type)
+                metrics->nmeaFrames[Metrics::nmeaType(frame)].add();
+            else
+                metrics->ubxFrames[Metrics::ubxType(frame.at(0), frame.at(1))].add();
+            complete = Metrics::timestamp();
+            metrics->latency[M8_LATENCY_FRAMING].add(complete - received);
+        }
+        if (Framer::FRAME_NMEA == type)
+            nmea->parse(frame, timestamp);
+        else
+            ubx->parse(frame, timestamp);
+        if (metrics)
+            metrics->latency[M8_LATENCY_PARSING].add(Metrics::timestamp() - complete);
+    }
+    if (metrics)
+        metrics->parserThreadCpuNs.set(static_cast<quint64>(Metrics::threadCpuTime()));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("m8bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks of the libm8 ingest, framing and decode paths");
+    parser.addHelpOption();
+    QCommandLineOption recordOption("record", "Recording file or directory to use as workload.",
+                                    "path");
+    QCommandLineOption epochsOption("epochs", "Epochs in the synthetic workload.", "n", "3600");
+    QCommandLineOption satOption("satellites", "Satellites in synthetic NAV-SAT.", "n", "24");
+    QCommandLineOption chunkOption("chunk", "Bytes per read in the synthetic workload.", "n",
+                                   QString::number(MAX_READ_DATA));
+    QCommandLineOption roundsOption("rounds", "Timed passes over the workload.", "n", "5");
+    QCommandLineOption handoffOption("handoff-chunks",
+                                     "Reads handed to the control thread per handoff run.", "n",
+                                     "100000");
+    QCommandLineOption scalingOption("scaling",
+                                     "Also run M8Manager against simulated receivers, which takes "
+                                     "a while.");
+    QCommandLineOption receiversOption("receivers", "Simulated receivers of each scaling run.",
+                                       "list", "1,4,8,16");
+    QCommandLineOption scalingSecondsOption("scaling-seconds", "Measured time of a scaling run.",
+                                            "s", "10");
+    QCommandLineOption simRateOption("sim-rate", "GGA and NAV-PVT rate of the simulators.", "Hz",
+                                     "10");
+    QCommandLineOption parserThreadsOption("parser-threads",
+                                           "Parser threads of the manager, 0 for one per core.",
+                                           "n", "0");
+    QCommandLineOption simulatorOption("m8sim", "Simulator to run.", "path",
+                                       QCoreApplication::applicationDirPath() + "/m8sim");
+    QCommandLineOption filterOption("filter", "Only benchmarks with this in the name.", "text");
+    QCommandLineOption outputOption("output", "JSON result file instead of stdout.", "path");
+    parser.addOptions({ recordOption, epochsOption, satOption, chunkOption, roundsOption,
+                        handoffOption, scalingOption, receiversOption, scalingSecondsOption,
+                        simRateOption, parserThreadsOption, simulatorOption, filterOption,
+                        outputOption });
+    parser.process(app);
+
+    Workload workload = parser.isSet(recordOption)
+            ? Workload::recorded(parser.value(recordOption))
+            : Workload::synthetic(parser.value(epochsOption).toInt(),
+                                  qBound(0, parser.value(satOption).toInt(), 255),
+                                  qMax(1, parser.value(chunkOption).toInt()));
+    if (workload.chunks.isEmpty()) {
+        qWarning("[m8bench] Empty workload");
+        return 1;
+    }
+
+    Metrics metrics;
+    M8Device device("file:/dev/null", &metrics);
+    NMEA nmea;
+    UBX ubx(&device, &metrics);
+    Framer framer(&metrics);
+    Benchmark benchmark(parser.value(roundsOption).toInt());
+    QString filter = parser.value(filterOption);
+    QList<BenchmarkResult> results;
+    auto run = [&](const QString &name, const QString &unit, const QList<QByteArray> &messages,
+                   auto op) {
+        if (!name.contains(filter))
+            return;
+        quint64 bytes = 0;
+        for (const QByteArray &message : messages)
+            bytes += static_cast<quint64>(message.size());
+        results.append(benchmark.run(name, unit, messages.size(),
+                                     static_cast<quint64>(messages.size()), bytes, op));
+    };
+
+    if (QString("framing").contains(filter)) {
+        QByteArray frame;
+        results.append(benchmark.run("framing", "chunk", workload.chunks.size(), workload.frames,
+                                     workload.bytes, [&](int i) {
+                                         framer.append(workload.chunks.at(i));
+                                         while (framer.next(frame))
+                                             sink = frame.size();
+                                     }));
+    }
+    run("nmea_crc_gga", "message", workload.gga,
+        [&](int i) { sink = nmea.crcCheck(workload.gga.at(i)); });
+    run("nmea_parse_gga", "message", workload.gga,
+        [&](int i) { nmea.parse(workload.gga.at(i), i); });
+    run("ubx_crc_nav_sat", "message", workload.navSat,
+        [&](int i) { sink = ubx.crcCheck(workload.navSat.at(i)); });
+    run("ubx_parse_nav_sat", "message", workload.navSat,
+        [&](int i) { ubx.parse(workload.navSat.at(i), i); });
+    run("ubx_crc_nav_timeutc", "message", workload.navTimeUtc,
+        [&](int i) { sink = ubx.crcCheck(workload.navTimeUtc.at(i)); });
+    run("ubx_parse_nav_timeutc", "message", workload.navTimeUtc,
+        [&](int i) { ubx.parse(workload.navTimeUtc.at(i), i); });
+    run("ubx_encode_send", "message", workload.commands, [&](int i) {
+        // What UBX::encodeAndSend does, with the device thread's side run inline when full
+        QByteArray data = UBX::encode(workload.commands.at(i));
+        if (!device.send(data)) {
+            device.writeQueued();
+            device.send(data);
+        }
+    });
+
+    // The same ingest with and without the metrics registry, for what the counters cost
+    QJsonObject metricsOverhead;
+    if (QString("ingest_metrics").contains(filter)
+        || QString("ingest_no_metrics").contains(filter)) {
+        Metrics ingestMetrics;
+        Framer meteredFramer(&ingestMetrics);
+        Framer plainFramer(nullptr);
+        qint64 timestamp = Metrics::timestamp();
+        BenchmarkResult metered = benchmark.run(
+                "ingest_metrics", "chunk", workload.chunks.size(), workload.frames,
+                workload.bytes, [&](int i) {
+                    ingest(&meteredFramer, &nmea, &ubx, &ingestMetrics, workload.chunks.at(i),
+                           timestamp);
+                });
+        BenchmarkResult plain = benchmark.run(
+                "ingest_no_metrics", "chunk", workload.chunks.size(), workload.frames,
+                workload.bytes, [&](int i) {
+                    ingest(&plainFramer, &nmea, &ubx, nullptr, workload.chunks.at(i), timestamp);
+                });
+        results.append(metered);
+        results.append(plain);
+        if (plain.seconds > 0) {
+            metricsOverhead.insert("secondsWithMetrics", metered.seconds);
+            metricsOverhead.insert("secondsWithoutMetrics", plain.seconds);
+            metricsOverhead.insert("percent", (metered.seconds / plain.seconds - 1) * 100);
+        }
+    }
+
+    // Line noise without anything that could start a frame, the worst case for resync scanning
+    QList<QByteArray> noise;
+    quint32 seed = 1;
+    for (int i = 0; i < 64; ++i) {
+        QByteArray buffer(4096, Qt::Uninitialized);
+        for (int j = 0; j < buffer.size(); ++j) {
+            seed = seed * 1103515245 + 12345;
+            char c = static_cast<char>(seed >> 24);
+            buffer[j] = ('$' == c || static_cast<char>(0xB5) == c) ? 0 : c;
+        }
+        noise.append(buffer);
+    }
+    Kernels::Isa isa = Kernels::isa();
+    for (int i = 0; i < Kernels::ISA_COUNT; ++i) {
+        if (!Kernels::setIsa(static_cast<Kernels::Isa>(i)))
+            continue;
+        run(QString("kernel_find_frame_start_%1").arg(Kernels::name(Kernels::isa())), "buffer",
+            noise, [&](int j) {
+                sink = Kernels::findFrameStart(noise.at(j).constData(), noise.at(j).size());
+            });
+    }
+    Kernels::setIsa(isa);
+    run("kernel_nmea_checksum", "message", workload.gga, [&](int i) {
+        sink = Kernels::nmeaChecksum(workload.gga.at(i).constData() + 1,
+                                     workload.gga.at(i).size() - 5);
+    });
+    run("kernel_nmea_checksum_scalar", "message", workload.gga, [&](int i) {
+        sink = Kernels::nmeaChecksumScalar(workload.gga.at(i).constData() + 1,
+                                           workload.gga.at(i).size() - 5);
+    });
+    run("kernel_ubx_checksum", "message", workload.navSat, [&](int i) {
+        sink = Kernels::ubxChecksum(workload.navSat.at(i).constData(),
+                                    workload.navSat.at(i).size() - 2);
+    });
+    run("kernel_ubx_checksum_scalar", "message", workload.navSat, [&](int i) {
+        sink = Kernels::ubxChecksumScalar(workload.navSat.at(i).constData(),
+                                          workload.navSat.at(i).size() - 2);
+    });
+
+    // Device to control thread handoff, the old queued signal against the receive ring
+    QJsonArray handoffs;
+    Handoff handoff(workload.chunks);
+    quint64 handoffChunks = parser.value(handoffOption).toULongLong();
+    double chunkBytes = static_cast<double>(workload.bytes) / workload.chunks.size();
+    for (double byteRate : { 1e6, 1e7, 1e8, 0.0 }) {
+        quint64 chunks = handoffChunks;
+        if (byteRate > 0)
+            chunks = qMin(chunks, static_cast<quint64>(byteRate * HANDOFF_PACED_SECONDS
+                                                       / chunkBytes));
+        for (bool ring : { false, true }) {
+            QString name = QString("handoff_%1").arg(ring ? "ring" : "signal");
+            if (name.contains(filter))
+                handoffs.append(handoff.run(ring, byteRate, chunks).toJson());
+        }
+    }
+
+    // Tracks from the GGA positions, timed by their UTC time of day
+    QVector<M8_TRACK_POINT> track;
+    quint64 ggaBytes = 0;
+    for (const QByteArray &gga : qAsConst(workload.gga)) {
+        M8_FIX fix;
+        if (!NMEA::decodeGga(gga, &fix))
+            continue;
+        M8_TRACK_POINT point;
+        point.timestamp = fix.utcTimeOfDay * 1000000LL;
+        point.latitude = fix.latitude;
+        point.longitude = fix.longitude;
+        point.altitude = fix.altitude;
+        track.append(point);
+        ggaBytes += static_cast<quint64>(gga.size()) + 1;
+    }
+    QJsonArray tracks;
+    for (double tolerance : { 0.0, 1.0, 5.0 }) {
+        QString name = QString("track_encode_%1m").arg(tolerance);
+        if (track.isEmpty() || !name.contains(filter))
+            continue;
+        // A new encoder each round, as timestamps must increase within a track
+        M8TrackEncoder encoder(tolerance);
+        results.append(benchmark.run(name, "point", track.size(),
+                                     static_cast<quint64>(track.size()), ggaBytes, [&](int i) {
+                                         if (i == 0)
+                                             encoder = M8TrackEncoder(tolerance);
+                                         encoder.add(track.at(i));
+                                         if (i == track.size() - 1) {
+                                             encoder.flush();
+                                             sink = encoder.takeData().size();
+                                         }
+                                     }));
+
+        // Compression of a single pass, so the counts are those of one track
+        M8TrackEncoder once(tolerance);
+        for (const M8_TRACK_POINT &point : qAsConst(track))
+            once.add(point);
+        once.flush();
+        QByteArray data = once.takeData();
+        M8_TRACK_STATS stats = once.statistics();
+        QJsonObject json;
+        json.insert("tolerance", tolerance);
+        json.insert("points", static_cast<double>(stats.points));
+        json.insert("encodedPoints", static_cast<double>(stats.encodedPoints));
+        json.insert("bytes", static_cast<double>(stats.bytes));
+        json.insert("bytesPerPoint", static_cast<double>(stats.bytes) / stats.points);
+        json.insert("ratioToGga", static_cast<double>(ggaBytes) / stats.bytes);
+        json.insert("ratioToRaw",
+                    static_cast<double>(stats.points * sizeof(M8_TRACK_POINT)) / stats.bytes);
+        tracks.append(json);
+
+        M8TrackDecoder decoder;
+        M8_TRACK_POINT point;
+        run(QString("track_decode_%1m").arg(tolerance), "track", { data }, [&](int) {
+            decoder = M8TrackDecoder();
+            decoder.append(data);
+            while (decoder.next(&point))
+                sink = static_cast<int>(point.timestamp);
+        });
+    }
+
+    // M8Manager with a growing number of receivers, each an m8sim on a pseudo terminal
+    QJsonArray scaling;
+    if (parser.isSet(scalingOption)) {
+        Scaling manager(parser.value(simulatorOption), parser.value(simRateOption).toInt(),
+                        qMax(1, parser.value(scalingSecondsOption).toInt()),
+                        parser.value(parserThreadsOption).toInt());
+        for (const QString &count : parser.value(receiversOption).split(",")) {
+            int receivers = count.toInt();
+            if (receivers > 0)
+                scaling.append(manager.run(receivers).toJson());
+        }
+    }
+
+    QJsonArray array;
+    for (const BenchmarkResult &result : qAsConst(results))
+        array.append(result.toJson());
+    QJsonObject report;
+    report.insert("workload", workload.name);
+    report.insert("bytes", static_cast<double>(workload.bytes));
+    report.insert("frames", static_cast<double>(workload.frames));
+    report.insert("rounds", parser.value(roundsOption).toInt());
+    report.insert("cpus", QThread::idealThreadCount());
+    report.insert("time", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    report.insert("results", array);
+    report.insert("tracks", tracks);
+    report.insert("handoff", handoffs);
+    report.insert("scaling", scaling);
+    report.insert("metricsOverhead", metricsOverhead);
+
+    QFile output;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        output.open(QIODevice::WriteOnly);
+    } else {
+        output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!output.isOpen()) {
+        qWarning("[m8bench] Could not write the results");
+        return 1;
+    }
+    output.write(QJsonDocument(report).toJson());
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "scaling.h"
+#include "m8_manager.h"
+#include "metrics.h"
+#include <QEventLoop>
+#include <QProcess>
+#include <QTimer>
+#include <cstring>
+#include <time.h>
+
+/* Time for the receivers to be configured and reach a steady state before measuring */
+#define WARMUP_MS 3000
+
+static qint64 processCpuNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Upper bound of the bin holding the p quantile of the latencies added between two snapshots */
+static double percentileUs(const M8_LATENCY_HISTOGRAM &before, const M8_LATENCY_HISTOGRAM &after,
+                           double p)
+{
+    quint64 count = after.count - before.count;
+    if (0 == count)
+        return 0;
+
+    quint64 rank = static_cast<quint64>(p * count);
+    quint64 seen = 0;
+    for (int bin = 0; bin < M8_LATENCY_BINS; ++bin) {
+        seen += after.bins[bin] - before.bins[bin];
+        if (seen > rank)
+            return static_cast<double>(1ULL << bin);
+    }
+    return static_cast<double>(1ULL << (M8_LATENCY_BINS - 1));
+}
+
+QJsonObject ScalingResult::toJson() const
+{
+    QJsonObject json;
+    json.insert("receivers", receivers);
+    json.insert("parserThreads", parserThreads);
+    json.insert("seconds", seconds);
+    json.insert("bytesPerSecond", bytesPerSecond);
+    json.insert("fixesPerSecond", fixesPerSecond);
+    json.insert("processCpuPercent", processCpuPercent);
+    json.insert("deviceThreadCpuPercent", deviceThreadCpuPercent);
+    json.insert("parserThreadCpuPercent", parserThreadCpuPercent);
+    json.insert("endToEndP50Us", endToEndP50Us);
+    json.insert("endToEndP99Us", endToEndP99Us);
+    json.insert("consumerP50Us", consumerP50Us);
+    json.insert("consumerP99Us", consumerP99Us);
+    return json;
+}
+
+/**
+ * @brief Scaling::Scaling
+ * @param simulator Path of m8sim
+ * @param rateHz GGA and UBX-NAV-PVT rate of every simulator
+ * @param seconds Measured time of each run
+ * @param maxParserThreads Of the manager, 0 for one per core
+ */
+Scaling::Scaling(const QString &simulator, int rateHz, int seconds, int maxParserThreads)
+    : m_simulator(simulator),
+      m_rateHz(rateHz),
+      m_seconds(seconds),
+      m_maxParserThreads(maxParserThreads)
+{
+}
+
+ScalingResult Scaling::run(int receivers)
+{
+    ScalingResult result;
+    memset(&result, 0, sizeof(result));
+    result.receivers = receivers;
+
+    QList<QProcess *> simulators;
+    QStringList devices;
+    QString rate = QString::number(m_rateHz);
+    QString duration = QString::number(WARMUP_MS / 1000 + m_seconds + 10);
+    for (int i = 0; i < receivers; ++i) {
+        QProcess *simulator = new QProcess();
+        simulators.append(simulator);
+        simulator->start(m_simulator, { "--nmea", rate, "--pvt", rate, "--sat", "1", "--seed",
+                                        QString::number(i + 1), "--duration", duration });
+        // The simulator prints the path of its pseudo terminal once it is ready
+        if (!simulator->waitForReadyRead(5000) || !simulator->canReadLine()) {
+            qWarning("[m8bench] Could not start %s", m_simulator.toLocal8Bit().constData());
+            break;
+        }
+        devices.append(QString::fromLocal8Bit(simulator->readLine()).trimmed());
+    }
+
+    if (devices.size() == receivers) {
+        M8Manager manager(m_maxParserThreads);
+        for (const QString &device : qAsConst(devices))
+            manager.addReceiver(device, "/dev/null");
+        result.parserThreads = manager.parserThreads();
+        wait(WARMUP_MS);
+
+        M8_METRICS before = manager.metrics();
+        qint64 cpuStart = processCpuNs();
+        qint64 start = Metrics::timestamp();
+        wait(m_seconds * 1000);
+        M8_METRICS after = manager.metrics();
+        double cpuNs = static_cast<double>(processCpuNs() - cpuStart);
+        double elapsedNs = static_cast<double>(Metrics::timestamp() - start);
+
+        const M8_LATENCY_HISTOGRAM &endToEnd = after.latency[M8_LATENCY_END_TO_END];
+        const M8_LATENCY_HISTOGRAM &consumer = after.latency[M8_LATENCY_CONSUMER];
+        result.seconds = elapsedNs / 1e9;
+        result.bytesPerSecond = (after.bytesRead - before.bytesRead) / result.seconds;
+        result.fixesPerSecond = (endToEnd.count - before.latency[M8_LATENCY_END_TO_END].count)
+                / result.seconds;
+        result.processCpuPercent = 100 * cpuNs / elapsedNs;
+        result.deviceThreadCpuPercent =
+                100 * (after.deviceThreadCpuNs - before.deviceThreadCpuNs) / elapsedNs;
+        result.parserThreadCpuPercent =
+                100 * (after.parserThreadCpuNs - before.parserThreadCpuNs) / elapsedNs;
+        result.endToEndP50Us =
+                percentileUs(before.latency[M8_LATENCY_END_TO_END], endToEnd, 0.50);
+        result.endToEndP99Us =
+                percentileUs(before.latency[M8_LATENCY_END_TO_END], endToEnd, 0.99);
+        result.consumerP50Us = percentileUs(before.latency[M8_LATENCY_CONSUMER], consumer, 0.50);
+        result.consumerP99Us = percentileUs(before.latency[M8_LATENCY_CONSUMER], consumer, 0.99);
+    }
+
+    for (QProcess *simulator : qAsConst(simulators)) {
+        simulator->terminate();
+        if (!simulator->waitForFinished(2000))
+            simulator->kill();
+        delete simulator;
+    }
+    return result;
+}
+
+/**
+ * @brief Scaling::wait
+ * @param ms
+ *
+ * Runs the event loop, so fixes are delivered to the thread of the manager meanwhile.
+ */
+void Scaling::wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SCALING_H
+#define SCALING_H
+
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief Load of one M8Manager serving a number of simulated receivers
+ *
+ * Latency percentiles are the upper bounds of the histogram bins they fall in.
+ */
+struct ScalingResult {
+    int receivers;
+    int parserThreads;
+    double seconds;
+    double bytesPerSecond;
+    double fixesPerSecond;
+    double processCpuPercent; /* Of one core, everything in the process */
+    double deviceThreadCpuPercent; /* The shared I/O thread */
+    double parserThreadCpuPercent; /* All parser workers together */
+    double endToEndP50Us; /* Read until newPosition has been delivered [us] */
+    double endToEndP99Us;
+    double consumerP50Us; /* Read until the fix reached the thread of the manager [us] */
+    double consumerP99Us;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Runs M8Manager against m8sim instances on pseudo terminals
+ *
+ * Each run starts its simulators, gives the receivers time to be configured and then measures
+ * the counters of the manager over a fixed time while the event loop delivers the fixes.
+ */
+class Scaling
+{
+public:
+    Scaling(const QString &simulator, int rateHz, int seconds, int maxParserThreads);
+
+    ScalingResult run(int receivers);
+
+private:
+    static void wait(int ms);
+
+private:
+    QString m_simulator;
+    int m_rateHz;
+    int m_seconds;
+    int m_maxParserThreads;
+};
+
+#endif // SCALING_H
@@ -0,0 +1,197 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "workload.h"
+#include "framer.h"
+#include "metrics.h"
+#include "recordreader.h"
+#include "ubx.h"
+#include <QDir>
+#include <QFileInfo>
+
+static QByteArray sentence(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (char c : body)
+        checksum ^= static_cast<quint8>(c);
+    return "$" + body + "*" + QByteArray::number(checksum, 16).toUpper().rightJustified(2, '0')
+            + "\r\n";
+}
+
+static QByteArray message(quint8 msgClass, quint8 msgId, const QByteArray &payload)
+{
+    QByteArray data;
+    data.append(static_cast<char>(msgClass));
+    data.append(static_cast<char>(msgId));
+    data.append(static_cast<char>(payload.size() & 0xFF));
+    data.append(static_cast<char>((payload.size() >> 8) & 0xFF));
+    data.append(payload);
+    return data;
+}
+
+/**
+ * @brief Workload::synthetic
+ * @param epochs Navigation epochs of one second
+ * @param satellites Satellites in every NAV-SAT
+ * @param chunkSize Bytes per device read
+ * @return GGA, RMC and GSA sentences plus NAV-SAT and NAV-TIMEUTC for every epoch
+ */
+Workload Workload::synthetic(int epochs, int satellites, int chunkSize)
+{
+    Workload workload;
+    workload.name = QString("synthetic-%1x%2").arg(epochs).arg(satellites);
+
+    QByteArray stream;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        int second = epoch % 86400;
+        QByteArray time = QString("%1%2%3.00")
+                                  .arg(second / 3600, 2, 10, QChar('0'))
+                                  .arg((second / 60) % 60, 2, 10, QChar('0'))
+                                  .arg(second % 60, 2, 10, QChar('0'))
+                                  .toLatin1();
+        QByteArray position = QString("55%1,N,012%2,E")
+                                      .arg(38.937814 + (epoch % 1000) * 1e-4, 9, 'f', 6)
+                                      .arg(32.581883 + (epoch % 1000) * 1e-4, 9, 'f', 6)
+                                      .toLatin1();
+        QByteArray used = QByteArray::number(qMin(satellites, 12));
+        stream.append(sentence("GPGGA," + time + "," + position + ",1," + used
+                               + ",1.4,61.7,M,40.5,M,,"));
+        stream.append(sentence("GPRMC," + time + ",A," + position + ",0.013,,010126,,,A"));
+        stream.append(sentence("GPGSA,A,3,02,05,07,09,13,16,20,26,29,,,,1.9,1.4,1.2"));
+
+        QByteArray sat(8 + 12 * satellites, 0);
+        sat[4] = 0x01; /* version */
+        sat[5] = static_cast<char>(satellites);
+        for (int i = 0; i < satellites; ++i) {
+            sat[8 + 12 * i] = static_cast<char>(i % 7); /* gnssId */
+            sat[9 + 12 * i] = static_cast<char>(1 + i);
+            sat[10 + 12 * i] = static_cast<char>(20 + (epoch + i) % 25);
+            sat[11 + 12 * i] = static_cast<char>((7 * i) % 90);
+            sat[16 + 12 * i] = 0x0C; /* flags */
+        }
+        stream.append(UBX::encode(message(0x01, 0x35, sat)));
+
+        QByteArray utc(20, 0);
+        utc[12] = static_cast<char>(2026 & 0xFF);
+        utc[13] = static_cast<char>(2026 >> 8);
+        utc[14] = 1;
+        utc[15] = 1;
+        utc[16] = static_cast<char>(second / 3600);
+        utc[17] = static_cast<char>((second / 60) % 60);
+        utc[18] = static_cast<char>(second % 60);
+        utc[19] = 0x07; /* validTOW, validWKN, validUTC */
+        stream.append(UBX::encode(message(0x01, 0x21, utc)));
+    }
+
+    for (int i = 0; i < stream.size(); i += chunkSize)
+        workload.chunks.append(stream.mid(i, chunkSize));
+    workload.split();
+    workload.addCommands();
+    return workload;
+}
+
+/**
+ * @brief Workload::recorded
+ * @param path Recording file, or directory of them, made with "record:" in the configuration
+ * @return Everything the recording read from the receiver, in the original chunks
+ */
+Workload Workload::recorded(const QString &path)
+{
+    Workload workload;
+    workload.name = QFileInfo(path).fileName();
+
+    QStringList files;
+    if (QFileInfo(path).isDir()) {
+        QDir dir(path);
+        for (const QString &file : dir.entryList(QStringList("*.m8rec"), QDir::Files, QDir::Name))
+            files.append(dir.filePath(file));
+    } else {
+        files.append(path);
+    }
+
+    for (const QString &file : qAsConst(files)) {
+        RecordReader reader(file);
+        if (!reader.isOpen()) {
+            qWarning("[Workload] Could not read %s", file.toUtf8().constData());
+            continue;
+        }
+        M8_RECORD_CHUNK chunk;
+        QByteArray data;
+        while (reader.next(&chunk, &data)) {
+            if (M8_RECORD_RX == chunk.direction)
+                workload.chunks.append(data);
+        }
+    }
+    workload.split();
+    workload.addCommands();
+    return workload;
+}
+
+void Workload::split()
+{
+    Metrics metrics;
+    Framer framer(&metrics);
+    QByteArray frame;
+    bytes = 0;
+    frames = 0;
+    for (const QByteArray &chunk : qAsConst(chunks)) {
+        bytes += static_cast<quint64>(chunk.size());
+        framer.append(chunk);
+        while (Framer::Frame type = framer.next(frame)) {
+            frames++;
+            if (Framer::FRAME_NMEA == type && Metrics::nmeaType(frame) == M8_NMEA_GGA) {
+                gga.append(frame);
+            } else if (Framer::FRAME_UBX == type && 0x01 == frame.at(0) && 0x35 == frame.at(1)) {
+                navSat.append(frame);
+            } else if (Framer::FRAME_UBX == type && 0x01 == frame.at(0) && 0x21 == frame.at(1)) {
+                navTimeUtc.append(frame);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Workload::addCommands
+ *
+ * The messages the library sends most: configuration polls and sets, and navigation database
+ * uploads.
+ */
+void Workload::addCommands()
+{
+    for (int i = 0; i < 256; ++i) {
+        switch (i % 4) {
+        case 0:
+            commands.append(message(0x01, 0x21, QByteArray()));
+            break;
+        case 1:
+            commands.append(message(0x06, 0x01, QByteArray("\xF0\x00\x00\x01\x00\x00\x00\x00", 8)));
+            break;
+        case 2:
+            commands.append(message(0x06, 0x3B, QByteArray(44, static_cast<char>(i))));
+            break;
+        default:
+            commands.append(message(0x13, 0x80, QByteArray(60 + i % 100, static_cast<char>(i))));
+            break;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Receiver data to run the benchmarks over
+ *
+ * The stream is kept both as read chunks, for framing, and as the frames the framer produces,
+ * for the checksum and parse benchmarks.
+ */
+struct Workload {
+    QString name;
+    QList<QByteArray> chunks;
+    QList<QByteArray> gga; /* NMEA sentences without the line feed */
+    QList<QByteArray> navSat; /* UBX frames without sync chars */
+    QList<QByteArray> navTimeUtc;
+    QList<QByteArray> commands; /* UBX messages to encode, without sync chars and checksum */
+    quint64 bytes;
+    quint64 frames;
+
+    static Workload synthetic(int epochs, int satellites, int chunkSize);
+    static Workload recorded(const QString &path);
+
+private:
+    void split();
+    void addCommands();
+};
+
+#endif // WORKLOAD_H
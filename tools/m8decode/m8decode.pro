@@ -0,0 +1,21 @@
+QT -= gui
+
+TEMPLATE = app
+TARGET = m8decode
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += \
+    $$_PRO_FILE_PWD_/../../include/
+
+LIBS += -L$$_PRO_FILE_PWD_/../../bin/ -lm8
+
+SOURCES += \
+    main.cpp
+
+DESTDIR = $$_PRO_FILE_PWD_/../../bin/
+OBJECTS_DIR = $$_PRO_FILE_PWD_/../../build/m8decode/.obj
+MOC_DIR = $$_PRO_FILE_PWD_/../../build/m8decode/.moc
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "m8_decoder.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("m8decode");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decodes raw u-blox M8 captures on all cores");
+    parser.addHelpOption();
+    parser.addPositionalArgument("capture", "Raw receiver stream or .m8rec recording.");
+    QCommandLineOption outputOption("output", "Directory for the decoded tables.", "dir", ".");
+    QCommandLineOption formatOption("format", "csv or columns.", "format", "csv");
+    QCommandLineOption threadsOption("threads", "Decoder threads, 0 for one per core.", "n", "0");
+    QCommandLineOption chunkOption("chunk", "Chunk size.", "MiB", "16");
+    parser.addOptions({ outputOption, formatOption, threadsOption, chunkOption });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+    QString format = parser.value(formatOption);
+    if (format != "csv" && format != "columns") {
+        qWarning("[m8decode] Unknown format %s", format.toUtf8().constData());
+        return 1;
+    }
+
+    M8Decoder decoder;
+    decoder.setThreads(parser.value(threadsOption).toInt());
+    decoder.setChunkSize(parser.value(chunkOption).toLongLong() * 1024 * 1024);
+    QElapsedTimer timer;
+    timer.start();
+    if (!decoder.decode(parser.positionalArguments().at(0)))
+        return 1;
+    qint64 decodeMs = timer.elapsed();
+
+    QString output = parser.value(outputOption);
+    bool written = (format == "csv") ? decoder.writeCsv(output) : decoder.writeColumns(output);
+    if (!written) {
+        qWarning("[m8decode] Could not write to %s", output.toUtf8().constData());
+        return 1;
+    }
+
+    M8_DECODER_STATS stats = decoder.statistics();
+    QTextStream(stderr) << stats.bytes << " bytes in " << decodeMs << " ms, " << stats.chunks
+                        << " chunks (" << stats.redecodedChunks << " decoded again), "
+                        << stats.nmeaFrames << " NMEA and " << stats.ubxFrames << " UBX frames, "
+                        << stats.nmeaChecksumErrors + stats.ubxChecksumErrors
+                        << " checksum errors, " << stats.framesRecovered << " frames recovered, "
+                        << stats.bytesDiscarded << " bytes discarded, "
+                        << decoder.positions().offset.size() << " positions" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,20 @@
+QT -= gui
+
+TEMPLATE = app
+TARGET = m8sim
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    main.cpp \
+    simulator.cpp
+
+HEADERS += \
+    simulator.h
+
+DESTDIR = $$_PRO_FILE_PWD_/../../bin/
+OBJECTS_DIR = $$_PRO_FILE_PWD_/../../build/m8sim/.obj
+MOC_DIR = $$_PRO_FILE_PWD_/../../build/m8sim/.moc
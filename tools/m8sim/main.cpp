@@ -0,0 +1,100 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "simulator.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <signal.h>
+#include <unistd.h>
+
+static int quitPipe[2];
+
+static void quit(int)
+{
+    // Only async-signal-safe calls here. The event loop picks it up from the pipe.
+    char c = 0;
+    ssize_t bytesWritten = write(quitPipe[1], &c, 1);
+    Q_UNUSED(bytesWritten)
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("m8sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulated u-blox M8 receiver on a pseudo terminal");
+    parser.addHelpOption();
+    QCommandLineOption linkOption("link", "Symbolic link to the pseudo terminal.", "path");
+    QCommandLineOption nmeaOption("nmea", "GGA and RMC rate.", "Hz", "1");
+    QCommandLineOption pvtOption("pvt", "UBX-NAV-PVT rate.", "Hz", "0");
+    QCommandLineOption timeOption("time", "UBX-NAV-TIMEUTC rate.", "Hz", "0");
+    QCommandLineOption satOption("sat", "UBX-NAV-SAT rate.", "Hz", "0");
+    QCommandLineOption latencyOption("ack-latency", "Delay before ACK or NAK.", "ms", "0");
+    QCommandLineOption nakOption("nak", "Probability of a NAK.", "p", "0");
+    QCommandLineOption corruptOption("corrupt", "Probability of a corrupted message.", "p", "0");
+    QCommandLineOption dropOption("drop", "Probability of a dropped message.", "p", "0");
+    QCommandLineOption seedOption("seed", "Seed for the fault injection.", "n");
+    QCommandLineOption noFixOption("no-fix", "Start without a fix.");
+    QCommandLineOption scriptOption("script", "Timed commands, see Simulator::runScript.", "file");
+    QCommandLineOption durationOption("duration", "Quit after this long.", "s");
+    parser.addOptions({ linkOption, nmeaOption, pvtOption, timeOption, satOption, latencyOption,
+                        nakOption, corruptOption, dropOption, seedOption, noFixOption, scriptOption,
+                        durationOption });
+    parser.process(app);
+
+    Simulator simulator;
+    simulator.setRates({ parser.value(nmeaOption).toDouble(), parser.value(pvtOption).toDouble(),
+                         parser.value(timeOption).toDouble(), parser.value(satOption).toDouble() });
+    simulator.setFaults({ parser.value(nakOption).toDouble(),
+                          parser.value(corruptOption).toDouble(),
+                          parser.value(dropOption).toDouble() });
+    simulator.setAckLatency(parser.value(latencyOption).toInt());
+    simulator.setFix(!parser.isSet(noFixOption));
+    if (parser.isSet(seedOption))
+        simulator.setSeed(parser.value(seedOption).toUInt());
+    if (!simulator.open(parser.value(linkOption)))
+        return 1;
+    if (parser.isSet(scriptOption) && !simulator.runScript(parser.value(scriptOption)))
+        return 1;
+
+    QObject::connect(&simulator, &Simulator::finished, &app, &QCoreApplication::quit);
+    if (parser.isSet(durationOption))
+        QTimer::singleShot(parser.value(durationOption).toInt() * 1000, &app,
+                           &QCoreApplication::quit);
+    if (pipe(quitPipe) == 0) {
+        QSocketNotifier *notifier = new QSocketNotifier(quitPipe[0], QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, &app, &QCoreApplication::quit);
+        signal(SIGINT, quit);
+        signal(SIGTERM, quit);
+    }
+
+    // The device name for the library, for scripts starting the host side
+    QTextStream(stdout) << simulator.slavePath() << Qt::endl;
+    int result = app.exec();
+    QTextStream(stderr) << simulator.statistics() << Qt::endl;
+    return result;
+}
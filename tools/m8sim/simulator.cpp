@@ -0,0 +1,683 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "simulator.h"
+#include <QDateTime>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QStringList>
+#include <QTextStream>
+#include <QTimer>
+#include <errno.h>
+#include <fcntl.h>
+#include <qmath.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+//#define SIMULATOR_DEBUG
+#ifdef SIMULATOR_DEBUG
+#include <QDebug>
+#define SIMULATOR_D(x) qDebug() << "[Simulator] " << x
+#else
+#define SIMULATOR_D(x)
+#endif
+
+#define GPS_EPOCH_OFFSET 315964800LL /* 1980-01-06 in seconds since 1970-01-01 */
+#define GPS_LEAP_SECONDS 18
+#define SATELLITES 8
+#define DBD_ENTRIES 8
+
+static void put(QByteArray &data, int offset, qint64 value, int size)
+{
+    for (int i = 0; i < size; ++i)
+        data[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static quint32 timeOfWeek(const QDateTime &utc)
+{
+    qint64 ms = utc.toMSecsSinceEpoch() - GPS_EPOCH_OFFSET * 1000 + GPS_LEAP_SECONDS * 1000;
+    return static_cast<quint32>(ms % (7 * 24 * 3600 * 1000LL));
+}
+
+Simulator::Simulator(QObject *parent)
+    : QObject(parent),
+      m_masterFd(-1),
+      m_slaveFd(-1),
+      m_notifier(nullptr),
+      m_ackLatency(0),
+      m_latitude(55.648964),
+      m_longitude(12.543031),
+      m_altitude(61.7),
+      m_fix(true),
+      m_engineOn(true),
+      m_silent(false),
+      m_messagesReceived(0),
+      m_messagesSent(0),
+      m_acks(0),
+      m_naks(0),
+      m_corrupted(0),
+      m_dropped(0),
+      m_overruns(0),
+      m_bytesSent(0),
+      m_dbdEntries(0)
+{
+    m_rates = { 1, 0, 0, 0 };
+    m_faults = { 0, 0, 0 };
+    m_nmeaTimer = new QTimer(this);
+    connect(m_nmeaTimer, &QTimer::timeout, this, &Simulator::sendNmea);
+    m_pvtTimer = new QTimer(this);
+    connect(m_pvtTimer, &QTimer::timeout, this, &Simulator::sendPvt);
+    m_timeTimer = new QTimer(this);
+    connect(m_timeTimer, &QTimer::timeout, this, &Simulator::sendTime);
+    m_satelliteTimer = new QTimer(this);
+    connect(m_satelliteTimer, &QTimer::timeout, this, &Simulator::sendSatellites);
+
+    // Configuration the library reads back before changing it
+    m_cfg.insert(0x3E, gnssPayload());
+    QByteArray pm2(44, 0);
+    pm2[0] = 0x01; /* version */
+    m_cfg.insert(0x3B, pm2);
+    QByteArray navx5(40, 0);
+    navx5[0] = 0x02; /* version */
+    m_cfg.insert(0x23, navx5);
+}
+
+Simulator::~Simulator()
+{
+    if (!m_link.isEmpty())
+        unlink(m_link.toUtf8().constData());
+    if (m_slaveFd >= 0)
+        close(m_slaveFd);
+    if (m_masterFd >= 0)
+        close(m_masterFd);
+}
+
+/**
+ * @brief Simulator::open
+ * @param link Symbolic link to create to the slave side, for a stable device name
+ * @return false if no pseudo terminal could be allocated
+ */
+bool Simulator::open(const QString &link)
+{
+    m_masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_masterFd < 0 || grantpt(m_masterFd) != 0 || unlockpt(m_masterFd) != 0) {
+        qWarning("[Simulator] Could not allocate a pseudo terminal");
+        return false;
+    }
+    m_slavePath = QString::fromLocal8Bit(ptsname(m_masterFd));
+    fcntl(m_masterFd, F_SETFL, fcntl(m_masterFd, F_GETFL) | O_NONBLOCK);
+
+    // Holding the slave open keeps the master usable while the host reconnects. The host opens
+    // it like a UART, so it gets raw mode and a plausible baud rate here.
+    m_slaveFd = ::open(m_slavePath.toUtf8().constData(), O_RDWR | O_NOCTTY);
+    if (m_slaveFd < 0) {
+        qWarning("[Simulator] Could not open %s", m_slavePath.toUtf8().constData());
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(m_slaveFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, B115200);
+        tcsetattr(m_slaveFd, TCSANOW, &tio);
+    }
+
+    if (!link.isEmpty()) {
+        unlink(link.toUtf8().constData());
+        if (symlink(m_slavePath.toUtf8().constData(), link.toUtf8().constData()) != 0) {
+            qWarning("[Simulator] Could not create %s", link.toUtf8().constData());
+            return false;
+        }
+        m_link = link;
+    }
+
+    m_notifier = new QSocketNotifier(m_masterFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &Simulator::readHost);
+    setRates(m_rates);
+    return true;
+}
+
+QString Simulator::slavePath() const
+{
+    return m_slavePath;
+}
+
+void Simulator::setRates(const SimulatorRates &rates)
+{
+    m_rates = rates;
+    if (m_masterFd < 0)
+        return;
+
+    startTimer(m_nmeaTimer, m_rates.nmea);
+    startTimer(m_pvtTimer, m_rates.pvt);
+    startTimer(m_timeTimer, m_rates.time);
+    startTimer(m_satelliteTimer, m_rates.satellites);
+}
+
+void Simulator::setFaults(const SimulatorFaults &faults)
+{
+    m_faults = faults;
+}
+
+/**
+ * @brief Simulator::setAckLatency
+ * @param ms Delay before a CFG message is answered with ACK-ACK or ACK-NAK
+ */
+void Simulator::setAckLatency(int ms)
+{
+    m_ackLatency = ms;
+}
+
+void Simulator::setPosition(double latitude, double longitude, double altitude)
+{
+    m_latitude = latitude;
+    m_longitude = longitude;
+    m_altitude = altitude;
+}
+
+void Simulator::setFix(bool fix)
+{
+    m_fix = fix;
+}
+
+/**
+ * @brief Simulator::setSeed
+ * @param seed Makes the injected faults repeatable
+ */
+void Simulator::setSeed(quint32 seed)
+{
+    m_random.seed(seed);
+}
+
+/**
+ * @brief Simulator::runScript
+ * @param path File with one "<ms> <command>" per line, ms counted from now
+ * @return false if the file could not be read or has a malformed line
+ *
+ * Commands:
+ *  - fix on|off
+ *  - rate nmea|pvt|time|sat <Hz>
+ *  - nak|corrupt|drop <probability>
+ *  - latency <ms>
+ *  - position <latitude> <longitude> <altitude>
+ *  - silence on|off
+ *  - quit
+ */
+bool Simulator::runScript(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning("[Simulator] Could not read %s", path.toUtf8().constData());
+        return false;
+    }
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith("#"))
+            continue;
+
+        bool ok;
+        int at = line.section(' ', 0, 0).toInt(&ok);
+        QString text = line.section(' ', 1).trimmed();
+        if (!ok || at < 0 || text.isEmpty()) {
+            qWarning("[Simulator] %s:%d: expected \"<ms> <command>\"", path.toUtf8().constData(),
+                     lineNumber);
+            return false;
+        }
+        QTimer::singleShot(at, this, [=]() {
+            if (!command(text))
+                qWarning("[Simulator] Unknown command: %s", text.toUtf8().constData());
+        });
+    }
+    return true;
+}
+
+bool Simulator::command(const QString &line)
+{
+    SIMULATOR_D("Command" << line);
+    QStringList args = line.split(' ', Qt::SkipEmptyParts);
+    QString name = args.takeFirst();
+    if (name == "quit") {
+        emit finished();
+        return true;
+    }
+    if (args.isEmpty())
+        return false;
+
+    if (name == "fix") {
+        m_fix = (args.at(0) == "on");
+    } else if (name == "silence") {
+        m_silent = (args.at(0) == "on");
+    } else if (name == "latency") {
+        m_ackLatency = args.at(0).toInt();
+    } else if (name == "nak") {
+        m_faults.nak = args.at(0).toDouble();
+    } else if (name == "corrupt") {
+        m_faults.corrupt = args.at(0).toDouble();
+    } else if (name == "drop") {
+        m_faults.drop = args.at(0).toDouble();
+    } else if (name == "position" && args.size() >= 3) {
+        setPosition(args.at(0).toDouble(), args.at(1).toDouble(), args.at(2).toDouble());
+    } else if (name == "rate" && args.size() >= 2) {
+        double rate = args.at(1).toDouble();
+        if (args.at(0) == "nmea") {
+            m_rates.nmea = rate;
+        } else if (args.at(0) == "pvt") {
+            m_rates.pvt = rate;
+        } else if (args.at(0) == "time") {
+            m_rates.time = rate;
+        } else if (args.at(0) == "sat") {
+            m_rates.satellites = rate;
+        } else {
+            return false;
+        }
+        setRates(m_rates);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString Simulator::statistics() const
+{
+    return QString("received %1, sent %2 (%3 bytes), ack %4, nak %5, corrupted %6, dropped %7, "
+                   "overruns %8, dbd uploads %9")
+            .arg(m_messagesReceived)
+            .arg(m_messagesSent)
+            .arg(m_bytesSent)
+            .arg(m_acks)
+            .arg(m_naks)
+            .arg(m_corrupted)
+            .arg(m_dropped)
+            .arg(m_overruns)
+            .arg(m_dbdEntries);
+}
+
+void Simulator::readHost()
+{
+    char buffer[4096];
+    for (;;) {
+        ssize_t bytesRead = read(m_masterFd, buffer, sizeof(buffer));
+        if (bytesRead <= 0)
+            break;
+        m_input.append(buffer, static_cast<int>(bytesRead));
+    }
+    parseHost();
+}
+
+/**
+ * @brief Simulator::parseHost
+ *
+ * Takes complete UBX frames off the input. Anything between frames is skipped.
+ */
+void Simulator::parseHost()
+{
+    for (;;) {
+        int start = m_input.indexOf("\xB5\x62");
+        if (start < 0) {
+            // Keep a trailing first sync char, the second may still be on its way
+            m_input = m_input.endsWith('\xB5') ? QByteArray("\xB5") : QByteArray();
+            return;
+        }
+        m_input.remove(0, start);
+        if (m_input.size() < 8)
+            return;
+
+        int length = (m_input.at(4) & 0xFF) | ((m_input.at(5) & 0xFF) << 8);
+        if (m_input.size() < length + 8)
+            return;
+
+        quint8 ck_a = 0;
+        quint8 ck_b = 0;
+        for (int i = 2; i < length + 6; ++i) {
+            ck_a += static_cast<quint8>(m_input.at(i));
+            ck_b += ck_a;
+        }
+        if (ck_a != static_cast<quint8>(m_input.at(length + 6))
+            || ck_b != static_cast<quint8>(m_input.at(length + 7))) {
+            SIMULATOR_D("Checksum error");
+            m_input.remove(0, 2);
+            continue;
+        }
+
+        m_messagesReceived++;
+        handleMessage(static_cast<quint8>(m_input.at(2)), static_cast<quint8>(m_input.at(3)),
+                      m_input.mid(6, length));
+        m_input.remove(0, length + 8);
+    }
+}
+
+void Simulator::handleMessage(quint8 msgClass, quint8 msgId, const QByteArray &payload)
+{
+    SIMULATOR_D("Message" << msgClass << msgId << payload.size());
+    switch (msgClass) {
+    case 0x01:
+        if (!payload.isEmpty())
+            break;
+        if (0x07 == msgId) {
+            sendUbx(0x01, 0x07, pvtPayload());
+        } else if (0x21 == msgId) {
+            sendUbx(0x01, 0x21, timePayload());
+        } else if (0x35 == msgId) {
+            sendUbx(0x01, 0x35, satellitePayload());
+        }
+        break;
+    case 0x06:
+        if (payload.isEmpty()) {
+            // Poll. Answered with the current configuration, if there is one.
+            if (m_cfg.contains(msgId))
+                sendUbx(0x06, msgId, m_cfg.value(msgId));
+            break;
+        }
+        if (0x04 == msgId) {
+            // CFG-RST is not acknowledged. Every reset mode but GNSS stop (0x08) runs the engine.
+            if (payload.size() >= 3)
+                m_engineOn = (0x08 != static_cast<quint8>(payload.at(2)));
+            break;
+        }
+        // A rejected message changes nothing
+        if (!acknowledge(msgClass, msgId))
+            break;
+        if (0x01 == msgId && payload.size() >= 3) {
+            // CFG-MSG, rate in navigation cycles on the current port (UART1 in the long form)
+            int cycles = static_cast<quint8>(payload.at(payload.size() >= 8 ? 3 : 2));
+            double rate = (cycles > 0) ? 1.0 / cycles : 0;
+            quint16 message = static_cast<quint16>(((payload.at(0) & 0xFF) << 8)
+                                                   | (payload.at(1) & 0xFF));
+            if (0x0107 == message) {
+                m_rates.pvt = rate;
+            } else if (0x0121 == message) {
+                m_rates.time = rate;
+            } else if (0x0135 == message) {
+                m_rates.satellites = rate;
+            } else if (0xF000 == message) {
+                m_rates.nmea = rate;
+            }
+            setRates(m_rates);
+        } else {
+            m_cfg.insert(msgId, payload);
+        }
+        break;
+    case 0x0A:
+        if (0x28 == msgId && payload.isEmpty()) {
+            QByteArray gnss(8, 0);
+            gnss[1] = 0x0F; /* supported: GPS, GLONASS, BeiDou, Galileo */
+            gnss[2] = 0x03; /* default */
+            gnss[3] = 0x03; /* enabled */
+            gnss[4] = 0x03; /* simultaneous */
+            sendUbx(0x0A, 0x28, gnss);
+        }
+        break;
+    case 0x13:
+        if (0x80 != msgId)
+            break;
+        if (payload.isEmpty()) {
+            for (int i = 0; i < DBD_ENTRIES; ++i) {
+                QByteArray entry(12 + 48, 0);
+                entry[12] = static_cast<char>(i);
+                sendUbx(0x13, 0x80, entry);
+            }
+        } else {
+            m_dbdEntries++;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Simulator::acknowledge
+ * @param msgClass
+ * @param msgId
+ * @return false if the message is answered with ACK-NAK
+ */
+bool Simulator::acknowledge(quint8 msgClass, quint8 msgId)
+{
+    bool nak = m_random.generateDouble() < m_faults.nak;
+    if (nak) {
+        m_naks++;
+    } else {
+        m_acks++;
+    }
+
+    QByteArray payload;
+    payload.append(static_cast<char>(msgClass));
+    payload.append(static_cast<char>(msgId));
+    QTimer::singleShot(m_ackLatency, this, [=]() { sendUbx(0x05, nak ? 0x00 : 0x01, payload); });
+    return !nak;
+}
+
+void Simulator::sendUbx(quint8 msgClass, quint8 msgId, const QByteArray &payload)
+{
+    QByteArray data;
+    data.reserve(payload.size() + 8);
+    data.append(static_cast<char>(0xB5));
+    data.append(static_cast<char>(0x62));
+    data.append(static_cast<char>(msgClass));
+    data.append(static_cast<char>(msgId));
+    data.append(static_cast<char>(payload.size() & 0xFF));
+    data.append(static_cast<char>((payload.size() >> 8) & 0xFF));
+    data.append(payload);
+
+    quint8 ck_a = 0;
+    quint8 ck_b = 0;
+    for (int i = 2; i < data.size(); ++i) {
+        ck_a += static_cast<quint8>(data.at(i));
+        ck_b += ck_a;
+    }
+    data.append(static_cast<char>(ck_a));
+    data.append(static_cast<char>(ck_b));
+    output(data);
+}
+
+void Simulator::sendSentence(const QByteArray &body)
+{
+    quint8 checksum = 0;
+    for (char c : body)
+        checksum ^= static_cast<quint8>(c);
+
+    QByteArray data = "$" + body + "*";
+    data.append(QByteArray::number(checksum, 16).toUpper().rightJustified(2, '0'));
+    data.append("\r\n");
+    output(data);
+}
+
+/**
+ * @brief Simulator::output
+ * @param data Complete message
+ *
+ * Applies the fault injection. A host that does not keep up loses the rest of the message, as
+ * it would with a UART overrun.
+ */
+void Simulator::output(QByteArray data)
+{
+    if (m_silent)
+        return;
+    if (m_random.generateDouble() < m_faults.drop) {
+        m_dropped++;
+        return;
+    }
+    if (m_random.generateDouble() < m_faults.corrupt) {
+        int index = static_cast<int>(m_random.bounded(static_cast<quint32>(data.size())));
+        data[index] = static_cast<char>(data.at(index) ^ (1 << m_random.bounded(8)));
+        m_corrupted++;
+    }
+
+    ssize_t bytesSent = write(m_masterFd, data.constData(), static_cast<size_t>(data.size()));
+    if (bytesSent > 0)
+        m_bytesSent += static_cast<quint64>(bytesSent);
+    if (bytesSent < data.size())
+        m_overruns++;
+    m_messagesSent++;
+}
+
+void Simulator::startTimer(QTimer *timer, double rate)
+{
+    if (rate <= 0) {
+        timer->stop();
+        return;
+    }
+    timer->setTimerType(Qt::PreciseTimer);
+    timer->setInterval(qMax(1, qRound(1000.0 / rate)));
+    timer->start();
+}
+
+void Simulator::sendNmea()
+{
+    if (!m_engineOn)
+        return;
+
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    QByteArray time = now.toString("hhmmss.zzz").left(9).toLatin1();
+
+    double latitude = qAbs(m_latitude);
+    double longitude = qAbs(m_longitude);
+    int latitudeDegrees = static_cast<int>(latitude);
+    int longitudeDegrees = static_cast<int>(longitude);
+    QByteArray position = QString("%1%2,%3,%4%5,%6")
+                                  .arg(latitudeDegrees, 2, 10, QChar('0'))
+                                  .arg((latitude - latitudeDegrees) * 60, 9, 'f', 6, QChar('0'))
+                                  .arg(m_latitude < 0 ? "S" : "N")
+                                  .arg(longitudeDegrees, 3, 10, QChar('0'))
+                                  .arg((longitude - longitudeDegrees) * 60, 9, 'f', 6, QChar('0'))
+                                  .arg(m_longitude < 0 ? "W" : "E")
+                                  .toLatin1();
+
+    sendSentence("GPGGA," + time + "," + position + "," + (m_fix ? "1" : "0") + ","
+                 + (m_fix ? QByteArray::number(SATELLITES) : QByteArray("00")) + ",1.2,"
+                 + QByteArray::number(m_altitude, 'f', 1) + ",M,40.5,M,,");
+    sendSentence("GPRMC," + time + "," + (m_fix ? "A" : "V") + "," + position + ",0.0,0.0,"
+                 + now.toString("ddMMyy").toLatin1() + ",,," + (m_fix ? "A" : "N"));
+}
+
+void Simulator::sendPvt()
+{
+    if (!m_engineOn)
+        return;
+
+    sendUbx(0x01, 0x07, pvtPayload());
+}
+
+void Simulator::sendTime()
+{
+    if (!m_engineOn)
+        return;
+
+    sendUbx(0x01, 0x21, timePayload());
+}
+
+void Simulator::sendSatellites()
+{
+    if (!m_engineOn)
+        return;
+
+    sendUbx(0x01, 0x35, satellitePayload());
+}
+
+QByteArray Simulator::pvtPayload() const
+{
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    QByteArray payload(92, 0);
+    put(payload, 0, timeOfWeek(now), 4);
+    put(payload, 4, now.date().year(), 2);
+    payload[6] = static_cast<char>(now.date().month());
+    payload[7] = static_cast<char>(now.date().day());
+    payload[8] = static_cast<char>(now.time().hour());
+    payload[9] = static_cast<char>(now.time().minute());
+    payload[10] = static_cast<char>(now.time().second());
+    payload[11] = 0x07; /* validDate, validTime, fullyResolved */
+    put(payload, 12, 50, 4); /* tAcc [ns] */
+    put(payload, 16, now.time().msec() * 1000000LL, 4);
+    payload[20] = m_fix ? 0x03 : 0x00; /* fixType */
+    payload[21] = m_fix ? 0x01 : 0x00; /* gnssFixOK */
+    payload[23] = m_fix ? SATELLITES : 0;
+    put(payload, 24, qRound64(m_longitude * 1e7), 4);
+    put(payload, 28, qRound64(m_latitude * 1e7), 4);
+    put(payload, 32, qRound64((m_altitude + 40.5) * 1000), 4);
+    put(payload, 36, qRound64(m_altitude * 1000), 4);
+    put(payload, 40, m_fix ? 2500 : 0xFFFFFFFF, 4); /* hAcc [mm] */
+    put(payload, 44, m_fix ? 4000 : 0xFFFFFFFF, 4); /* vAcc [mm] */
+    put(payload, 76, 150, 2); /* pDOP, 0.01 */
+    return payload;
+}
+
+QByteArray Simulator::timePayload() const
+{
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    QByteArray payload(20, 0);
+    put(payload, 0, timeOfWeek(now), 4);
+    put(payload, 4, 50, 4); /* tAcc [ns] */
+    put(payload, 8, now.time().msec() * 1000000LL, 4);
+    put(payload, 12, now.date().year(), 2);
+    payload[14] = static_cast<char>(now.date().month());
+    payload[15] = static_cast<char>(now.date().day());
+    payload[16] = static_cast<char>(now.time().hour());
+    payload[17] = static_cast<char>(now.time().minute());
+    payload[18] = static_cast<char>(now.time().second());
+    payload[19] = 0x07; /* validTOW, validWKN, validUTC */
+    return payload;
+}
+
+QByteArray Simulator::satellitePayload() const
+{
+    QByteArray payload(8 + 12 * SATELLITES, 0);
+    put(payload, 0, timeOfWeek(QDateTime::currentDateTimeUtc()), 4);
+    payload[4] = 0x01; /* version */
+    payload[5] = SATELLITES;
+    for (int i = 0; i < SATELLITES; ++i) {
+        int offset = 8 + 12 * i;
+        payload[offset] = 0x00; /* GPS */
+        payload[offset + 1] = static_cast<char>(2 + 3 * i);
+        payload[offset + 2] = static_cast<char>(m_fix ? 30 + 2 * i : 5);
+        payload[offset + 3] = static_cast<char>(15 + 9 * i);
+        put(payload, offset + 4, 45 * i, 2);
+        put(payload, offset + 8, m_fix ? 0x0C : 0x01, 4); /* qualityInd, svUsed */
+    }
+    return payload;
+}
+
+QByteArray Simulator::gnssPayload() const
+{
+    static const quint8 blocks[][4] = {
+        { 0, 8, 16, 0x01 }, /* GPS */
+        { 1, 1, 3, 0x01 }, /* SBAS */
+        { 6, 8, 14, 0x01 }, /* GLONASS */
+    };
+    QByteArray payload(4, 0);
+    payload[1] = 32; /* numTrkChHw */
+    payload[2] = 32; /* numTrkChUse */
+    payload[3] = sizeof(blocks) / sizeof(blocks[0]);
+    for (const auto &block : blocks) {
+        QByteArray entry(8, 0);
+        entry[0] = static_cast<char>(block[0]);
+        entry[1] = static_cast<char>(block[1]);
+        entry[2] = static_cast<char>(block[2]);
+        put(entry, 4, block[3] | (0x01 << 16), 4);
+        payload.append(entry);
+    }
+    return payload;
+}
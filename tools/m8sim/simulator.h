@@ -0,0 +1,141 @@
+/*
+MIT License
+
+Copyright (c) 2026 Nikolaj Due Østerbye
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QRandomGenerator>
+
+class QSocketNotifier;
+class QTimer;
+
+/**
+ * @brief Output rates [Hz] of the simulated receiver. 0 disables the output.
+ */
+struct SimulatorRates {
+    double nmea;
+    double pvt;
+    double time;
+    double satellites;
+};
+
+/**
+ * @brief Faults injected into the stream, as probabilities in the range 0 to 1
+ */
+struct SimulatorFaults {
+    double nak; /* CFG message answered with ACK-NAK */
+    double corrupt; /* one byte of an outgoing message flipped */
+    double drop; /* outgoing message never sent */
+};
+
+/**
+ * @brief Simulated u-blox M8 receiver on the master side of a pseudo terminal
+ *
+ * The library opens the slave side like a serial port. CFG messages are acknowledged after a
+ * configurable latency, polls of NAV-TIMEUTC, NAV-SAT, NAV-PVT, MON-GNSS, MGA-DBD and the CFG
+ * messages the library reads back are answered, and NMEA and UBX navigation output is sent at
+ * the configured rates. CFG-RST is not acknowledged, like on the receiver; a GNSS stop pauses
+ * the periodic output until a GNSS start.
+ */
+class Simulator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Simulator(QObject *parent = nullptr);
+    ~Simulator();
+
+    bool open(const QString &link = QString());
+    QString slavePath() const;
+
+    void setRates(const SimulatorRates &rates);
+    void setFaults(const SimulatorFaults &faults);
+    void setAckLatency(int ms);
+    void setPosition(double latitude, double longitude, double altitude);
+    void setFix(bool fix);
+    void setSeed(quint32 seed);
+    bool runScript(const QString &path);
+
+    QString statistics() const;
+
+signals:
+    void finished();
+
+private slots:
+    void readHost();
+    void sendNmea();
+    void sendPvt();
+    void sendTime();
+    void sendSatellites();
+
+private:
+    void parseHost();
+    void handleMessage(quint8 msgClass, quint8 msgId, const QByteArray &payload);
+    bool acknowledge(quint8 msgClass, quint8 msgId);
+    void sendUbx(quint8 msgClass, quint8 msgId, const QByteArray &payload);
+    void sendSentence(const QByteArray &body);
+    void output(QByteArray data);
+    void startTimer(QTimer *timer, double rate);
+    bool command(const QString &line);
+
+    QByteArray pvtPayload() const;
+    QByteArray timePayload() const;
+    QByteArray satellitePayload() const;
+    QByteArray gnssPayload() const;
+
+private:
+    int m_masterFd;
+    int m_slaveFd;
+    QString m_slavePath;
+    QString m_link;
+    QSocketNotifier *m_notifier;
+    QTimer *m_nmeaTimer;
+    QTimer *m_pvtTimer;
+    QTimer *m_timeTimer;
+    QTimer *m_satelliteTimer;
+    QByteArray m_input;
+    QHash<quint8, QByteArray> m_cfg;
+    QRandomGenerator m_random;
+    SimulatorRates m_rates;
+    SimulatorFaults m_faults;
+    int m_ackLatency;
+    double m_latitude;
+    double m_longitude;
+    double m_altitude;
+    bool m_fix;
+    bool m_engineOn;
+    bool m_silent;
+    quint64 m_messagesReceived;
+    quint64 m_messagesSent;
+    quint64 m_acks;
+    quint64 m_naks;
+    quint64 m_corrupted;
+    quint64 m_dropped;
+    quint64 m_overruns;
+    quint64 m_bytesSent;
+    quint64 m_dbdEntries;
+};
+
+#endif // SIMULATOR_H